@@ -2,8 +2,20 @@
 #pragma once
 
 #include <cstdint>
-
+#include <memory>
+#include <mutex>
+
+// the configuration is stored as a binary image of CONFIG_T. the JSON file
+// is used for import and export and is written before a firmware update.
+// the binary file is only accepted by a firmware with the same
+// CONFIG_VERSION and layout of CONFIG_T, otherwise the JSON file is imported.
+// large and rarely used texts are kept in files of their own and are only
+// loaded while they are needed.
 #define CONFIG_FILENAME "/config.json"
+#define CONFIG_TMP_FILENAME "/config.json.tmp"
+#define CONFIG_BINARY_FILENAME "/config.bin"
+#define CONFIG_MQTT_TLS_FILENAME "/mqtt_tls.bin"
+#define CONFIG_POWERMETER_HTTP_FILENAME "/powermeter_http.bin"
 #define CONFIG_VERSION 0x00011900 // 0.1.24 // make sure to clean all after change
 
 #define WIFI_MAX_SSID_STRLEN 32
@@ -40,6 +52,11 @@
 
 #define JSON_BUFFER_SIZE 15360
 
+// requested writes are delayed until no change was requested for the
+// quiet period, but at most by the maximum delay (milliseconds)
+#define CONFIG_WRITE_QUIET_PERIOD 2000
+#define CONFIG_WRITE_MAX_DELAY 10000
+
 struct CHANNEL_CONFIG_T {
     uint16_t MaxChannelPower;
     char Name[CHAN_MAX_NAME_STRLEN];
@@ -63,16 +80,31 @@ struct INVERTER_CONFIG_T {
 enum Auth { none, basic, digest };
 struct POWERMETER_HTTP_PHASE_CONFIG_T {
     bool Enabled;
-    char Url[POWERMETER_MAX_HTTP_URL_STRLEN + 1];
     Auth AuthType;
     char Username[POWERMETER_MAX_USERNAME_STRLEN +1];
     char Password[POWERMETER_MAX_USERNAME_STRLEN +1];
+    uint16_t Timeout;
+};
+
+// stored in CONFIG_POWERMETER_HTTP_FILENAME
+struct POWERMETER_HTTP_PHASE_TEXT_T {
+    char Url[POWERMETER_MAX_HTTP_URL_STRLEN + 1];
     char HeaderKey[POWERMETER_MAX_HTTP_HEADER_KEY_STRLEN + 1];
     char HeaderValue[POWERMETER_MAX_HTTP_HEADER_VALUE_STRLEN + 1];
-    uint16_t Timeout;
     char JsonPath[POWERMETER_MAX_HTTP_JSON_PATH_STRLEN + 1];
 };
 
+struct POWERMETER_HTTP_TEXT_T {
+    POWERMETER_HTTP_PHASE_TEXT_T Phase[POWERMETER_MAX_PHASES];
+};
+
+// stored in CONFIG_MQTT_TLS_FILENAME
+struct MQTT_TLS_CONFIG_T {
+    char RootCaCert[MQTT_MAX_CERT_STRLEN + 1];
+    char ClientCert[MQTT_MAX_CERT_STRLEN + 1];
+    char ClientKey[MQTT_MAX_CERT_STRLEN + 1];
+};
+
 struct CONFIG_T {
     uint32_t Cfg_Version;
     uint32_t Cfg_SaveCount;
@@ -125,10 +157,7 @@ struct CONFIG_T {
     bool Mqtt_Hass_Expire;
 
     bool Mqtt_Tls;
-    char Mqtt_RootCaCert[MQTT_MAX_CERT_STRLEN + 1];
     bool Mqtt_TlsCertLogin;
-    char Mqtt_ClientCert[MQTT_MAX_CERT_STRLEN + 1];
-    char Mqtt_ClientKey[MQTT_MAX_CERT_STRLEN +1];
 
     bool Vedirect_Enabled;
     bool Vedirect_VerboseLogging;
@@ -195,16 +224,76 @@ struct CONFIG_T {
     uint8_t Display_Language;
 };
 
+struct ConfigWriteStatistics_t {
+    uint32_t Writes;
+    uint32_t Requests;
+    uint32_t LastWriteUs;
+    uint32_t MaxWriteUs;
+    bool Pending;
+};
+
 class ConfigurationClass {
 public:
+    // the web API changes the configuration from the async_tcp task. it
+    // holds a guard while doing so, as do other tasks while they copy
+    // settings which have to be consistent. the guard must not be held
+    // while calling write() or flush().
+    class WriteGuard {
+    public:
+        CONFIG_T& getConfig();
+
+    private:
+        friend class ConfigurationClass;
+        explicit WriteGuard(std::mutex& mutex);
+
+        std::unique_lock<std::mutex> _lock;
+    };
+
     void init();
+    void loop();
     bool read();
     bool write();
     void migrate();
+
+    // changes to the configuration take effect immediately, requestWrite()
+    // persists them after a delay, merging consecutive requests. flush()
+    // writes a pending request right away, e.g. before a restart.
+    void requestWrite();
+    bool flush();
+    ConfigWriteStatistics_t getWriteStatistics();
+
+    // JSON import and export, the import does not write the binary file
+    // of CONFIG_T but the files of the large texts below. flush() exports
+    // the JSON file after writing the binary file.
+    bool importJson();
+    bool exportJson();
     CONFIG_T& get();
+    WriteGuard getWriteGuard();
+
+    // the large texts are read from flash on every call, the returned copy
+    // should be released as soon as it is no longer needed. writing an
+    // unchanged copy does not touch the flash.
+    std::unique_ptr<MQTT_TLS_CONFIG_T> loadMqttTls();
+    bool writeMqttTls(const MQTT_TLS_CONFIG_T& tls);
+    std::unique_ptr<POWERMETER_HTTP_TEXT_T> loadPowerMeterHttp();
+    bool writePowerMeterHttp(const POWERMETER_HTTP_TEXT_T& http);
 
     INVERTER_CONFIG_T* getFreeInverterSlot();
     INVERTER_CONFIG_T* getInverterConfig(uint64_t serial);
+
+private:
+    std::unique_ptr<CONFIG_T> copyConfig(bool save);
+    bool exportJson(const CONFIG_T& config);
+    bool readBinary();
+    static bool writeBinaryFile(const char* filename, const void* data, size_t size, uint32_t layout);
+    static bool readBinaryFile(const char* filename, void* data, size_t size, uint32_t layout);
+
+    std::mutex _configMutex;
+    std::mutex _writeMutex;
+    bool _writePending = false;
+    uint32_t _firstWriteRequest = 0;
+    uint32_t _lastWriteRequest = 0;
+    ConfigWriteStatistics_t _writeStatistics = {};
 };
 
 extern ConfigurationClass Configuration;
\ No newline at end of file
@@ -2,81 +2,106 @@
 #pragma once
 
 #include <TimeoutHelper.h>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 class DatastoreClass {
 public:
-    void init();
-    void loop();
+    // totals of all inverters, consistent among each other
+    struct Snapshot {
+        // incremented whenever any of the values below changes
+        uint32_t version = 0;
+
+        // Sum of yield total of all enabled inverters, a inverter which is just disabled at night is also included
+        float totalAcYieldTotalEnabled = 0;
 
-    // Sum of yield total of all enabled inverters, a inverter which is just disabled at night is also included
-    float getTotalAcYieldTotalEnabled();
+        // Sum of yield day of all enabled inverters, a inverter which is just disabled at night is also included
+        float totalAcYieldDayEnabled = 0;
 
-    // Sum of yield day of all enabled inverters, a inverter which is just disabled at night is also included
-    float getTotalAcYieldDayEnabled();
+        // Sum of total AC power of all enabled inverters
+        float totalAcPowerEnabled = 0;
 
-    // Sum of total AC power of all enabled inverters
-    float getTotalAcPowerEnabled();
+        // Sum of total DC power of all enabled inverters
+        float totalDcPowerEnabled = 0;
 
-    // Sum of total DC power of all enabled inverters
-    float getTotalDcPowerEnabled();
+        // Sum of total DC power of all enabled inverters with maxStringPower set
+        float totalDcPowerIrradiation = 0;
 
-    // Sum of total DC power of all enabled inverters with maxStringPower set
-    float getTotalDcPowerIrradiation();
+        // Sum of total installed irradiation of all enabled inverters
+        float totalDcIrradiationInstalled = 0;
 
-    // Sum of total installed irradiation of all enabled inverters
-    float getTotalDcIrradiationInstalled();
+        // Percentage (1-100) of total irradiation
+        float totalDcIrradiation = 0;
 
-    // Percentage (1-100) of total irradiation
-    float getTotalDcIrradiation();
+        // Amount of relevant digits for yield total
+        uint32_t totalAcYieldTotalDigits = 0;
 
-    // Amount of relevant digits for yield total
-    uint32_t getTotalAcYieldTotalDigits();
+        // Amount of relevant digits for yield total
+        uint32_t totalAcYieldDayDigits = 0;
 
-    // Amount of relevant digits for yield total
-    uint32_t getTotalAcYieldDayDigits();
+        // Amount of relevant digits for AC power
+        uint32_t totalAcPowerDigits = 0;
 
-    // Amount of relevant digits for AC power
-    uint32_t getTotalAcPowerDigits();
+        // Amount of relevant digits for DC power
+        uint32_t totalDcPowerDigits = 0;
 
-    // Amount of relevant digits for DC power
-    uint32_t getTotalDcPowerDigits();
+        // True, if at least one inverter is reachable
+        bool isAtLeastOneReachable = false;
 
-    // True, if at least one inverter is reachable
-    bool getIsAtLeastOneReachable();
+        // True if at least one inverter is producing
+        bool isAtLeastOneProducing = false;
 
-    // True if at least one inverter is producing
-    bool getIsAtLeastOneProducing();
+        // True if at least one inverter is enabled for polling
+        bool isAtLeastOnePollEnabled = false;
 
-    // True if at least one inverter is enabled for polling
-    bool getIsAtLeastOnePollEnabled();
+        // True if all enabled inverters are producing
+        bool isAllEnabledProducing = false;
 
-    // True if all enabled inverters are producing
-    bool getIsAllEnabledProducing();
+        // True if all enabled inverters are reachable
+        bool isAllEnabledReachable = false;
+    };
 
-    // True if all enabled inverters are reachable
-    bool getIsAllEnabledReachable();
+    void init();
+    void loop();
+
+    // never blocks, may be called from any task
+    Snapshot getSnapshot() const;
 
 private:
+    // what a single inverter adds to the totals
+    struct Contribution {
+        uint64_t serial = 0;
+        uint32_t lastUpdate = 0;
+        bool configured = false;
+        bool configPollEnable = false;
+        bool pollEnabled = false;
+        bool producing = false;
+        bool reachable = false;
+
+        float acYieldTotal = 0;
+        float acYieldDay = 0;
+        float acPower = 0;
+        float dcPower = 0;
+        float dcPowerIrradiation = 0;
+        float dcIrradiationInstalled = 0;
+        uint32_t acYieldTotalDigits = 0;
+        uint32_t acYieldDayDigits = 0;
+        uint32_t acPowerDigits = 0;
+        uint32_t dcPowerDigits = 0;
+    };
+
+    void publish();
+
     TimeoutHelper _updateTimeout;
-    std::mutex _mutex;
-
-    float _totalAcYieldTotalEnabled = 0;
-    float _totalAcYieldDayEnabled = 0;
-    float _totalAcPowerEnabled = 0;
-    float _totalDcPowerEnabled = 0;
-    float _totalDcPowerIrradiation = 0;
-    float _totalDcIrradiationInstalled = 0;
-    float _totalDcIrradiation = 0;
-    uint32_t _totalAcYieldTotalDigits = 0;
-    uint32_t _totalAcYieldDayDigits = 0;
-    uint32_t _totalAcPowerDigits = 0;
-    uint32_t _totalDcPowerDigits = 0;
-    bool _isAtLeastOneReachable = false;
-    bool _isAtLeastOneProducing = false;
-    bool _isAllEnabledProducing = false;
-    bool _isAllEnabledReachable = false;
-    bool _isAtLeastOnePollEnabled = false;
+
+    // only accessed by loop()
+    std::vector<Contribution> _contributions;
+
+    // the snapshot is written to the slot not currently published, readers
+    // retry if a new one was published while they were copying.
+    Snapshot _snapshots[2];
+    std::atomic<uint32_t> _version = 0;
 };
 
 extern DatastoreClass Datastore;
\ No newline at end of file
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// maximum time spent on discovery configs per loop iteration
+#define HASS_DISCOVERY_STEP_BUDGET_US 4000
+
+#define HASS_DISCOVERY_JSON_DOC_SIZE 1024
+
+struct HassDiscoveryStatistics_t {
+    // entities sent and skipped because their config did not change
+    uint32_t Published;
+    uint32_t Skipped;
+    // wall time and busy time of the last complete burst
+    uint32_t LastBurstMs;
+    uint32_t LastBurstBusyUs;
+    uint32_t LastBurstSteps;
+    // heap in use above the level at the start of the last burst
+    uint32_t LastBurstPeakHeap;
+};
+
+// Spreads the Home Assistant discovery configs of one handler across
+// several loop iterations.
+//
+// The handler enumerates all of its entities in a fixed order on every
+// step and asks claim() before building an entity's config. Entities
+// handled by an earlier step are skipped cheaply, and once the step's
+// time budget is used up all further entities are left for the next step:
+//
+//   if (_discovery.beginStep()) {
+//       publishConfig(); // calls claim() and publish() per entity
+//       _discovery.endStep();
+//   }
+//
+// A hash of every published config is kept. If the configs are retained
+// by the broker, unchanged entities are not published again after a
+// reconnect.
+class HassDiscoveryPublisher {
+public:
+    // starts a new burst. with force set, every entity is published even
+    // if its config did not change.
+    void begin(bool force);
+    bool isActive() const { return _active; }
+
+    // returns true if a burst is in progress
+    bool beginStep();
+    void endStep();
+
+    // true if the next entity is to be built and published by this step
+    bool claim();
+
+    // an empty document for the config of the claimed entity, it is kept
+    // until the burst completes
+    DynamicJsonDocument& getDocument();
+
+    void publish(const String& topic, const JsonDocument& doc, bool retain);
+    void publish(const String& topic, const char* payload, bool retain);
+
+    HassDiscoveryStatistics_t getStatistics() const { return _statistics; }
+
+private:
+    static uint32_t hash(const char* s);
+    bool isUnchanged(uint32_t topicHash, uint32_t payloadHash, bool retain) const;
+    void send(const String& topic, bool retain);
+
+    bool _active = false;
+    bool _force = false;
+    bool _budgetExhausted = false;
+
+    // index of the next entity to publish and of the entity currently
+    // enumerated by the handler
+    size_t _cursor = 0;
+    size_t _index = 0;
+    size_t _claimed = 0;
+
+    uint32_t _burstStart = 0;
+    uint32_t _stepStart = 0;
+    uint32_t _busyUs = 0;
+    uint32_t _steps = 0;
+    uint32_t _heapAtStart = 0;
+    uint32_t _minFreeHeap = 0;
+
+    // config hash by topic hash of every entity published so far
+    std::unordered_map<uint32_t, uint32_t> _published;
+
+    // reused between entities
+    std::unique_ptr<DynamicJsonDocument> _doc;
+    std::string _payload;
+
+    HassDiscoveryStatistics_t _statistics = {};
+};
@@ -4,23 +4,73 @@
 #include <stdint.h>
 #include <Arduino.h>
 #include <HTTPClient.h>
+#include <WiFiClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <memory>
+#include <mutex>
+#include "Configuration.h"
 
 class HttpPowerMeterClass {
 public:
+    // all phases of the last complete and successful poll
+    struct Reading {
+        float power[POWERMETER_MAX_PHASES];
+        float powerTotal;
+        uint32_t timestamp; // millis() when the poll completed, 0 if none
+    };
+
     void init();
-    bool updateValues();
-    float getPower(int8_t phase);
+
+    // wakes up the polling task. never blocks, returns immediately.
+    void requestUpdate();
+
+    Reading getReading();
+
+    // synchronous one-shot request using a fresh connection, used to test
+    // settings from the web UI. must not be called from the polling task.
     bool httpRequest(const char* url, Auth authType, const char* username, const char* password, const char* httpHeader, const char* httpValue, uint32_t timeout,
         char* response, size_t responseSize, char* error, size_t errorSize);
     float getFloatValueByJsonPath(const char* jsonString, const char* jsonPath, float &value);
 
 private:
-     void extractUrlComponents(const String& url, String& protocol, String& hostname, String& uri);
-     void prepareRequest(uint32_t timeout, const char* httpHeader, const char* httpValue);
-     HTTPClient httpClient;
-     float power[POWERMETER_MAX_PHASES];
-     String sha256(const String& data);
-     
+    // a connection is kept open between polls (HTTP keep-alive, TLS session)
+    // and remembers the last digest challenge so that subsequent requests
+    // can authenticate without an additional round trip.
+    struct HttpConnection {
+        std::unique_ptr<WiFiClient> wifiClient;
+        bool secure = false;
+        HTTPClient httpClient;
+        String digestRealm;
+        String digestNonce;
+        uint32_t digestNonceCount = 0;
+    };
+
+    static void pollingLoopHelper(void* context);
+    void pollingLoop();
+    bool updateValues();
+
+    bool httpRequest(HttpConnection& connection, const char* url, Auth authType, const char* username, const char* password, const char* httpHeader, const char* httpValue, uint32_t timeout,
+        char* response, size_t responseSize, char* error, size_t errorSize);
+    bool beginRequest(HttpConnection& connection, const char* url, uint32_t timeout, const char* httpHeader, const char* httpValue);
+    bool parseDigestChallenge(HttpConnection& connection);
+    String getDigestAuthorization(HttpConnection& connection, const String& uri, const char* username, const char* password);
+    void extractUrlComponents(const String& url, String& protocol, String& hostname, String& uri);
+    String sha256(const String& data);
+
+    TaskHandle_t _taskHandle = nullptr;
+
+    std::mutex _mutex;
+    Reading _reading = {};
+
+    // only accessed by the polling task. the settings are copied from the
+    // configuration when a poll starts, as the web API may change them.
+    POWERMETER_HTTP_PHASE_CONFIG_T _phaseConfig[POWERMETER_MAX_PHASES];
+    bool _individualRequests = false;
+    HttpConnection _connections[POWERMETER_MAX_PHASES];
+    float _pendingPower[POWERMETER_MAX_PHASES];
+    char _response[2000];
+    char _errorMessage[256];
 };
 
 extern HttpPowerMeterClass HttpPowerMeter;
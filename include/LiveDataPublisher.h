@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Publishes a live data document to all clients of a websocket.
+//
+// Clients which do not negotiate a protocol receive the full document on
+// every publish. Clients which send "protocol:2" receive a snapshot first:
+//   {"protocol":2,"type":"snapshot","snapshot":S,"seq":N,"ids":["/path/to/leaf",...],"data":{...}}
+// followed by deltas containing only the leaves which changed, addressed
+// by their index into the "ids" array of snapshot S:
+//   {"protocol":2,"type":"delta","snapshot":S,"seq":N+1,"changes":[[id,value],...]}
+// A client which missed a sequence number sends "resync" to receive a new
+// snapshot. Whenever the set of leaves changes, e.g. if an inverter was
+// added, the snapshot id is incremented and all clients get a new snapshot.
+class LiveDataPublisher {
+public:
+    static constexpr uint8_t PROTOCOL_VERSION = 2;
+
+    explicit LiveDataPublisher(AsyncWebSocket& ws);
+
+    // to be called from the websocket's event handler
+    void onWebsocketEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len);
+
+    // true if a client is waiting for a snapshot
+    bool isPublishRequested() const { return _publishRequested; }
+
+    void publish(JsonVariantConst root);
+
+    // total size of all messages serialized by the last publish
+    size_t getLastPublishBytes() const { return _lastPublishBytes; }
+
+private:
+    using buffer_t = std::vector<uint8_t>;
+
+    struct ClientState {
+        bool delta = false;
+        bool snapshotPending = false;
+    };
+
+    // ArduinoJson writer appending to a buffer
+    class BufferWriter {
+    public:
+        explicit BufferWriter(buffer_t& buffer)
+            : _buffer(buffer)
+        {
+        }
+        size_t write(uint8_t c);
+        size_t write(const uint8_t* s, size_t n);
+        size_t print(const char* s);
+
+    private:
+        buffer_t& _buffer;
+    };
+
+    // FNV-1a over everything written to it
+    class HashWriter {
+    public:
+        size_t write(uint8_t c);
+        size_t write(const uint8_t* s, size_t n);
+        uint32_t hash = 2166136261u;
+    };
+
+    // calls visitor(path, leaf) for every value which is neither an object
+    // nor an array, in document order. path is a JSON pointer.
+    template <typename Visitor>
+    static void visitLeaves(JsonVariantConst var, char* path, size_t pathLen, size_t pathSize, Visitor& visitor);
+
+    // returns true if the set of leaves changed, otherwise the changed
+    // leaves were appended to delta
+    bool updateLeaves(JsonVariantConst root, BufferWriter& delta, size_t& changes);
+    void writeSnapshot(JsonVariantConst root, buffer_t& buffer);
+
+    // the messages stay referenced by the send queues of the clients until
+    // they were transmitted. a few buffers per message type are recycled,
+    // keeping their capacity, instead of allocating one per publish.
+    static constexpr size_t BUFFERS_PER_TYPE = 3;
+    using buffer_pool_t = std::array<std::shared_ptr<buffer_t>, BUFFERS_PER_TYPE>;
+
+    // returns an empty buffer which is not referenced by any send queue or
+    // nullptr if all of them are still queued
+    static std::shared_ptr<buffer_t> acquire(buffer_pool_t& pool);
+
+    AsyncWebSocket& _ws;
+
+    std::mutex _mutex;
+    std::map<uint32_t, ClientState> _clients;
+    std::atomic<bool> _publishRequested = false;
+
+    // value hashes of all leaves in the order of the snapshot's "ids"
+    std::vector<uint32_t> _leafHashes;
+    uint32_t _structureHash = 0;
+    bool _baselineValid = false;
+    uint32_t _snapshotId = 0;
+    uint32_t _sequence = 0;
+
+    buffer_pool_t _fullBuffers;
+    buffer_pool_t _snapshotBuffers;
+    buffer_pool_t _deltaBuffers;
+
+    // messages are handed to the clients after releasing _mutex as
+    // sending may close a client, which calls back into the event handler
+    std::vector<std::pair<uint32_t, std::shared_ptr<buffer_t>>> _outbox;
+
+    size_t _lastPublishBytes = 0;
+};
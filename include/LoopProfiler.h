@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+#include <array>
+#include <memory>
+#include <mutex>
+
+// Measures how long the subsystems called by the main loop take. The time
+// since the previous checkpoint is accounted to the section passed to
+// endSection(), which then yields. Time spent in yield(), i.e. in other
+// tasks of the same priority, is accounted to the Yield section.
+//
+// Durations are counted in histograms with power of two buckets, from
+// which percentiles are estimated by the bucket's upper bound. The
+// histograms and the longest call are collected per window of one minute,
+// the readers get the last completed window. Sums and counts are also
+// accumulated since boot.
+class LoopProfilerClass {
+public:
+    enum class Section : uint8_t {
+        NetworkSettings,
+        PowerMeter,
+        PowerLimiter,
+        InverterSettings,
+        Datastore,
+        VeDirectMppt,
+        MqttSettings,
+        MqttHandleDtu,
+        MqttHandleInverter,
+        MqttHandleInverterTotal,
+        MqttHandleVedirect,
+        MqttHandleHass,
+        MqttHandleVedirectHass,
+        MqttHandleHuawei,
+        MqttHandlePowerLimiter,
+        WebApi,
+        Display,
+        SunPosition,
+        MessageOutput,
+        Battery,
+        MqttHandlePylontechHass,
+        HuaweiCan,
+        LedSingle,
+        Configuration,
+        Yield,
+        Count
+    };
+
+    static constexpr size_t SECTION_COUNT = static_cast<size_t>(Section::Count);
+
+    // bucket i counts durations below 2^i us, the last one everything else
+    static constexpr size_t BUCKET_COUNT = 21;
+
+    struct Histogram {
+        std::array<uint32_t, BUCKET_COUNT> buckets = {};
+        uint32_t count = 0;
+        uint64_t sumUs = 0;
+        uint32_t minUs = UINT32_MAX;
+        uint32_t maxUs = 0;
+
+        void add(uint32_t us);
+
+        // upper bound of the bucket containing the given percentile
+        uint32_t getPercentileUs(uint8_t percentile) const;
+    };
+
+    static constexpr uint32_t WINDOW_US = 60 * 1000 * 1000;
+
+    struct Window {
+        std::array<Histogram, SECTION_COUNT> sections;
+        Histogram loop;
+
+        // longest single call of any section and the section it happened in
+        uint32_t stallUs = 0;
+        Section stallSection = Section::Yield;
+
+        uint32_t durationMs = 0;
+        uint32_t number = 0; // windows completed since boot, 0 if none yet
+
+        const Histogram& getHistogram(Section section) const { return sections[static_cast<size_t>(section)]; }
+    };
+
+    struct Total {
+        uint64_t sumUs = 0;
+        uint64_t count = 0;
+    };
+
+    void startLoop();
+    void endSection(Section section);
+
+    static const char* getSectionName(Section section);
+    static uint32_t getBucketBoundUs(size_t bucket);
+
+    // copy of the last completed window, on the heap as it does not fit on
+    // the stack of the web server's task comfortably
+    std::unique_ptr<Window> getLastWindow() const;
+
+    // sums and counts of all completed windows
+    Total getTotal(Section section) const;
+    Total getLoopTotal() const;
+
+    // completed loops during the last full second
+    uint32_t getLoopsPerSecond() const { return _loopsPerSecond; }
+
+private:
+    void record(Section section, uint32_t now);
+    void completeWindow(uint32_t now);
+
+    // written by the main loop only, without locking
+    Window _window;
+    uint32_t _windowStart = 0;
+
+    mutable std::mutex _mutex;
+    Window _lastWindow;
+    std::array<Total, SECTION_COUNT> _totals;
+    Total _loopTotal;
+
+    bool _running = false;
+    uint32_t _loopStart = 0;
+    uint32_t _checkpoint = 0;
+
+    uint32_t _secondStart = 0;
+    uint32_t _loopsThisSecond = 0;
+    uint32_t _loopsPerSecond = 0;
+};
+
+extern LoopProfilerClass LoopProfiler;
@@ -3,33 +3,91 @@
 
 #include <AsyncWebSocket.h>
 #include <Print.h>
+#include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
-#include <unordered_map>
-#include <queue>
 
 class MessageOutputClass : public Print {
 public:
+    void init();
     void loop();
     size_t write(uint8_t c) override;
     size_t write(const uint8_t *buffer, size_t size) override;
     void register_ws_output(AsyncWebSocket* output);
 
+    // the recent history is sent to a newly connected console client
+    void requestHistory(uint32_t clientId);
+
+    // lines lost as the buffer was full or the websocket was congested
+    uint32_t getDroppedLines() const { return _droppedLines; }
+    uint32_t getDroppedWsLines() const { return _droppedWsLines; }
+
 private:
     using message_t = std::vector<uint8_t>;
 
-    // we keep a buffer for every task and only write complete lines to the
-    // serial output and then move them to be pushed through the websocket.
-    // this way we prevent mangling of messages from different contexts.
-    std::unordered_map<TaskHandle_t, message_t> _task_messages;
-    std::queue<message_t> _lines;
+    static constexpr size_t BUFFER_SIZE = 4096;
+    static constexpr size_t HISTORY_SIZE = 2048;
+    static constexpr size_t LINE_SIZE = 256;
+    static constexpr size_t LINE_SLOTS = 8;
+
+    // we keep a partial line for every task and only hand complete lines
+    // to the output task. this way we prevent mangling of messages from
+    // different contexts. longer lines are split.
+    struct PendingLine {
+        TaskHandle_t task = nullptr;
+        uint16_t len = 0;
+        uint8_t data[LINE_SIZE];
+    };
+
+    // lines are stored as two bytes length followed by the text
+    class LineRing {
+    public:
+        explicit LineRing(size_t size) : _size(size) { }
+        bool push(uint8_t* buffer, const uint8_t* line, size_t len);
+        size_t pop(const uint8_t* buffer, uint8_t* line);
+        void dropOldest(const uint8_t* buffer);
+        size_t available() const { return _size - (_head - _tail); }
+        bool empty() const { return _head == _tail; }
 
-    AsyncWebSocket* _ws = nullptr;
+    private:
+        void copyIn(uint8_t* buffer, size_t pos, const uint8_t* data, size_t len);
+        void copyOut(const uint8_t* buffer, size_t pos, uint8_t* data, size_t len) const;
+        size_t peekLength(const uint8_t* buffer) const;
 
+        size_t _size;
+        size_t _head = 0;
+        size_t _tail = 0;
+    };
+
+    static void outputLoopHelper(void* context);
+    void outputLoop();
+    void serialWrite(const uint8_t* data, size_t len);
+    void sendHistory(AsyncWebSocket* ws);
+    void sendToWs(AsyncWebSocket* ws, std::shared_ptr<message_t>& message, uint32_t& lines);
+    void appendHistory(const uint8_t* line, size_t len);
+    PendingLine* getPendingLine(TaskHandle_t task);
+    void commit(const uint8_t* data, size_t len);
+
+    TaskHandle_t _taskHandle = nullptr;
+    std::atomic<AsyncWebSocket*> _ws = nullptr;
+
+    // _msgLock only guards copying into and out of the buffer, the slow
+    // serial and websocket output happens in the output task.
     std::mutex _msgLock;
+    PendingLine _pendingLines[LINE_SLOTS];
+    uint8_t _buffer[BUFFER_SIZE];
+    LineRing _lines = LineRing(BUFFER_SIZE);
+    std::vector<uint32_t> _historyClients;
+
+    // only accessed by the output task
+    uint8_t _history[HISTORY_SIZE];
+    LineRing _historyLines = LineRing(HISTORY_SIZE);
 
-    void serialWrite(message_t const& m);
+    std::atomic<uint32_t> _droppedLines = 0;
+    std::atomic<uint32_t> _droppedWsLines = 0;
 };
 
 extern MessageOutputClass MessageOutput;
\ No newline at end of file
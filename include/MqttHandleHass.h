@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "HassDiscoveryPublisher.h"
 #include <ArduinoJson.h>
 #include <Hoymiles.h>
 
@@ -52,11 +53,14 @@ class MqttHandleHassClass {
 public:
     void init();
     void loop();
-    void publishConfig();
     void forceUpdate();
 
+    HassDiscoveryStatistics_t getDiscoveryStatistics() const { return _discovery.getStatistics(); }
+
 private:
-    void publish(const String& subtopic, const String& payload);
+    void publishConfig();
+    void publish(const String& subtopic, const JsonDocument& doc);
+    void publish(const String& subtopic, const char* payload);
     void publishField(std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, byteAssign_fieldDeviceClass_t fieldType, bool clear = false);
     void publishInverterButton(std::shared_ptr<InverterAbstract> inv, const char* caption, const char* icon, const char* category, const char* deviceClass, const char* subTopic, const char* payload);
     void publishInverterNumber(std::shared_ptr<InverterAbstract> inv, const char* caption, const char* icon, const char* category, const char* commandTopic, const char* stateTopic, const char* unitOfMeasure, int16_t min = 1, int16_t max = 100);
@@ -65,6 +69,8 @@ private:
 
     bool _wasConnected = false;
     bool _updateForced = false;
+
+    HassDiscoveryPublisher _discovery;
 };
 
 extern MqttHandleHassClass MqttHandleHass;
\ No newline at end of file
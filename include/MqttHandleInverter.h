@@ -5,6 +5,24 @@
 #include <Hoymiles.h>
 #include <TimeoutHelper.h>
 #include <espMqttClient.h>
+#include <string>
+#include <vector>
+
+// default for republishing unchanged telemetry, in milliseconds
+#ifndef PUBLISH_MAX_INTERVAL
+#define PUBLISH_MAX_INTERVAL 60000
+#endif
+
+struct MqttInverterStatistics_t {
+    // telemetry messages sent and skipped because the value did not change
+    uint32_t Published;
+    uint32_t Suppressed;
+    // topic and payload length of all suppressed messages
+    uint32_t BytesSaved;
+    // duration of the last and the longest publish cycle
+    uint32_t LastCycleUs;
+    uint32_t MaxCycleUs;
+};
 
 class MqttHandleInverterClass {
 public:
@@ -13,28 +31,68 @@ public:
 
     static String getTopic(std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId);
 
+    MqttInverterStatistics_t getStatistics() const { return _statistics; }
+
 private:
-    void publishField(std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId);
+    // a field is published if its value differs from the last published
+    // one by at least the absolute deadband or the relative deadband (a
+    // fraction of the last published value), whichever is larger. Deadbands
+    // are in the unit of the field, with both set to 0 every change of the
+    // formatted value is published. Unchanged values are republished after
+    // maxInterval milliseconds.
+    struct FieldPublishSettings {
+        FieldId_t fieldId;
+        float absoluteDeadband;
+        float relativeDeadband;
+        uint32_t maxInterval;
+    };
+
+    struct PublishedField {
+        ChannelType_t type;
+        ChannelNum_t channel;
+        const FieldPublishSettings* settings;
+        std::string topic; // including the prefix
+        float value;
+        char payload[16];
+        uint32_t lastPublish;
+        bool published;
+    };
+
+    struct InverterState {
+        uint64_t serial = 0;
+        uint32_t lastPublishStats = 0;
+        uint32_t lastChannelNames = 0;
+        bool channelNamesPublished = false;
+        std::vector<PublishedField> fields;
+    };
+
+    void buildTopicTable(std::shared_ptr<InverterAbstract> inv, InverterState& state);
+    void publishChannelNames(std::shared_ptr<InverterAbstract> inv, InverterState& state);
+    void publishField(std::shared_ptr<InverterAbstract> inv, PublishedField& field, bool retain);
     void onMqttMessage(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t len, size_t index, size_t total);
 
-    uint32_t _lastPublishStats[INV_MAX_COUNT] = { 0 };
+    InverterState _inverters[INV_MAX_COUNT];
     uint32_t _lastPublish = 0;
+    bool _connected = false;
+    std::string _topicPrefix;
+
+    MqttInverterStatistics_t _statistics = {};
 
-    FieldId_t _publishFields[14] = {
-        FLD_UDC,
-        FLD_IDC,
-        FLD_PDC,
-        FLD_YD,
-        FLD_YT,
-        FLD_UAC,
-        FLD_IAC,
-        FLD_PAC,
-        FLD_F,
-        FLD_T,
-        FLD_PF,
-        FLD_EFF,
-        FLD_IRR,
-        FLD_Q
+    static constexpr FieldPublishSettings _publishFields[14] = {
+        { FLD_UDC, 0.5, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_IDC, 0.02, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_PDC, 1, 0.01, PUBLISH_MAX_INTERVAL },
+        { FLD_YD, 0, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_YT, 0, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_UAC, 0.5, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_IAC, 0.02, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_PAC, 1, 0.01, PUBLISH_MAX_INTERVAL },
+        { FLD_F, 0.02, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_T, 0.5, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_PF, 0.005, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_EFF, 0.5, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_IRR, 0.5, 0, PUBLISH_MAX_INTERVAL },
+        { FLD_Q, 1, 0.01, PUBLISH_MAX_INTERVAL }
     };
 };
 
@@ -1,23 +1,28 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "HassDiscoveryPublisher.h"
 #include <ArduinoJson.h>
 
 class MqttHandlePylontechHassClass {
 public:
     void init();
     void loop();
-    void publishConfig();
     void forceUpdate();
 
+    HassDiscoveryStatistics_t getDiscoveryStatistics() const { return _discovery.getStatistics(); }
+
 private:
-    void publish(const String& subtopic, const String& payload);
+    void publishConfig();
+    void publish(const String& subtopic, const JsonDocument& doc);
     void publishBinarySensor(const char* caption, const char* icon, const char* subTopic, const char* payload_on, const char* payload_off);
     void publishSensor(const char* caption, const char* icon, const char* subTopic, const char* deviceClass = NULL, const char* stateClass = NULL, const char* unitOfMeasurement = NULL);
     void createDeviceInfo(JsonObject& object);
 
     bool _wasConnected = false;
     bool _updateForced = false;
+
+    HassDiscoveryPublisher _discovery;
     String serial = "0001"; // pseudo-serial, can be replaced in future with real serialnumber
 };
 
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "HassDiscoveryPublisher.h"
 #include <ArduinoJson.h>
 #include "VeDirectMpptController.h"
 
@@ -8,17 +9,21 @@ class MqttHandleVedirectHassClass {
 public:
     void init();
     void loop();
-    void publishConfig();
     void forceUpdate();
 
+    HassDiscoveryStatistics_t getDiscoveryStatistics() const { return _discovery.getStatistics(); }
+
 private:
-    void publish(const String& subtopic, const String& payload);
+    void publishConfig();
+    void publish(const String& subtopic, const JsonDocument& doc);
     void publishBinarySensor(String serial, String pid, const char* caption, const char* icon, const char* subTopic, const char* payload_on, const char* payload_off);
     void publishSensor(String serial, String pid, const char* caption, const char* icon, const char* subTopic, const char* deviceClass = NULL, const char* stateClass = NULL, const char* unitOfMeasurement = NULL);
     void createDeviceInfo(String serial, String pid, JsonObject& object);
 
     bool _wasConnected = false;
     bool _updateForced = false;
+
+    HassDiscoveryPublisher _discovery;
 };
 
 extern MqttHandleVedirectHassClass MqttHandleVedirectHass;
\ No newline at end of file
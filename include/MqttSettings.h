@@ -1,10 +1,12 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "Configuration.h"
 #include "NetworkSettings.h"
 #include <MqttSubscribeParser.h>
 #include <Ticker.h>
 #include <espMqttClient.h>
+#include <memory>
 #include <mutex>
 
 class MqttSettingsClass {
@@ -17,6 +19,10 @@ public:
     void publish(const String& subtopic, const String& payload);
     void publishGeneric(const String& topic, const String& payload, bool retain, uint8_t qos = 0);
 
+    // publishes to a full topic (including the prefix) without copying or
+    // trimming the payload. returns false if the message was not queued.
+    bool publishGeneric(const char* topic, const char* payload, bool retain, uint8_t qos = 0);
+
     void subscribe(const String& topic, uint8_t qos, const espMqttClientTypes::OnMessageCallback& cb);
     void unsubscribe(const String& topic);
 
@@ -35,6 +41,8 @@ private:
     void createMqttClientObject();
 
     MqttClient* mqttClient = nullptr;
+    // the TLS client keeps pointers to the certificates
+    std::unique_ptr<MQTT_TLS_CONFIG_T> _tlsConfig;
     String clientId;
     String willTopic;
     Ticker mqttReconnectTimer;
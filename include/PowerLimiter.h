@@ -2,9 +2,11 @@
 #pragma once
 
 #include "Configuration.h"
+#include "PowerMeter.h"
 #include <espMqttClient.h>
 #include <Arduino.h>
 #include <Hoymiles.h>
+#include <LogLevel.h>
 #include <memory>
 #include <functional>
 
@@ -17,6 +19,10 @@
 #define PL_MODE_FULL_DISABLE 1
 #define PL_MODE_SOLAR_PT_ONLY 2
 
+#ifndef DPL_LOG_LEVEL
+#define DPL_LOG_LEVEL LOG_LEVEL
+#endif
+
 typedef enum {
     EMPTY_WHEN_FULL= 0, 
     EMPTY_AT_NIGHT
@@ -60,6 +66,7 @@ public:
 
     void setMode(Mode m) { _mode = m; }
     Mode getMode() const { return _mode; }
+    Status getStatus() const { return _lastStatus; }
     void calcNextInverterRestart();
 
 private:
@@ -78,6 +85,8 @@ private:
     bool _fullSolarPassThroughEnabled = false;
     bool _verboseLogging = true;
 
+    bool isVerboseLogging() const { return LOG_ENABLED(LOG_LEVEL_VERBOSE, DPL_LOG_LEVEL, _verboseLogging); }
+
     std::string const& getStatusText(Status status);
     void announceStatus(Status status);
     bool shutdown(Status status);
@@ -85,7 +94,7 @@ private:
     int32_t inverterPowerDcToAc(std::shared_ptr<InverterAbstract> inverter, int32_t dcPower);
     void unconditionalSolarPassthrough(std::shared_ptr<InverterAbstract> inverter);
     bool canUseDirectSolarPower();
-    int32_t calcPowerLimit(std::shared_ptr<InverterAbstract> inverter, bool solarPowerEnabled, bool batteryDischargeEnabled);
+    int32_t calcPowerLimit(std::shared_ptr<InverterAbstract> inverter, PowerMeterClass::Sample const& powerMeter, bool solarPowerEnabled, bool batteryDischargeEnabled);
     void commitPowerLimit(std::shared_ptr<InverterAbstract> inverter, int32_t limit, bool enablePowerProduction);
     bool setNewPowerLimit(std::shared_ptr<InverterAbstract> inverter, int32_t newPowerLimit);
     int32_t getSolarChargePower();
@@ -5,7 +5,7 @@
 #include <espMqttClient.h>
 #include <Arduino.h>
 #include <map>
-#include <list>
+#include <mutex>
 #include "SDM.h"
 #include "sml.h"
 
@@ -22,8 +22,7 @@
 #endif
 
 typedef struct {
-  const unsigned char OBIS[6];
-  void (*Fn)(double&);
+  void (SmlParser::*Fn)(double&) const;
   float* Arg;
 } OBISHandler;
 
@@ -36,9 +35,20 @@ public:
         SOURCE_HTTP = 3,
         SOURCE_SML = 4
     };
+    // immutable copy of the most recent complete reading. readings are taken
+    // by loop() only, consumers never trigger (potentially blocking) reads.
+    struct Sample {
+        float power[POWERMETER_MAX_PHASES];
+        float powerTotal;
+        uint32_t timestamp; // millis() when the reading completed, 0 if none
+
+        uint32_t getAgeMillis() const { return millis() - timestamp; }
+    };
+
     void init();
     void loop();
-    float getPowerTotal(bool forceUpdate = true);
+    Sample getSample();
+    float getPowerTotal();
     uint32_t getLastPowerMeterUpdate();
 
 private:
@@ -49,8 +59,11 @@ private:
 
     bool _verboseLogging = true;
     uint32_t _lastPowerMeterCheck;
-    // Used in Power limiter for safety check
-    uint32_t _lastPowerMeterUpdate;
+    uint32_t _lastHttpPowerMeterUpdate;
+
+    std::mutex _mutex;
+    Sample _sample;
+    void publishSample();
 
     float _powerMeter1Power = 0.0;
     float _powerMeter2Power = 0.0;
@@ -64,12 +77,35 @@ private:
     std::map<String, float*> _mqttSubscriptions;
 
     void readPowerMeter();
+    bool readHttpPowerMeter();
+
+    // a range of consecutive float input registers read in one transaction.
+    // the values are stored in the respective members, if any.
+    struct SdmBlock {
+        uint16_t reg;
+        uint8_t count; // 0 terminates a list of blocks
+        bool energy;
+        float PowerMeterClass::* targets[SDM_MAX_BLOCK_VALUES];
+    };
+    static const SdmBlock _sdm3phBlocks[];
+    static const SdmBlock _sdm1phBlocks[];
+    static constexpr uint32_t _sdmEnergyIntervalMs = 60 * 1000;
+
+    SdmBlock const* _sdmBlocks = nullptr; // blocks of the current read cycle
+    uint8_t _sdmBlockIdx = 0;
+    bool _sdmReadEnergy = false;
+    uint32_t _lastSdmEnergyRead = 0;
+
+    bool requestSdmBlock();
+    bool sdmReadLoop();
 
     bool smlReadLoop();
-    const std::list<OBISHandler> smlHandlerList{
-        {{0x01, 0x00, 0x10, 0x07, 0x00, 0xff}, &smlOBISW, &_powerMeter1Power},
-        {{0x01, 0x00, 0x01, 0x08, 0x00, 0xff}, &smlOBISWh, &_powerMeterImport},
-        {{0x01, 0x00, 0x02, 0x08, 0x00, 0xff}, &smlOBISWh, &_powerMeterExport}
+    SmlParser _smlParser;
+    // indexed by the OBIS code as packed by SmlParser::obisCode()
+    const std::map<uint64_t, OBISHandler> _smlHandlers{
+        {0x0100100700ff, {&SmlParser::obisW, &_powerMeter1Power}},  // 1-0:16.7.0*255
+        {0x0100010800ff, {&SmlParser::obisWh, &_powerMeterImport}}, // 1-0:1.8.0*255
+        {0x0100020800ff, {&SmlParser::obisWh, &_powerMeterExport}}  // 1-0:2.8.0*255
     };
 };
 
@@ -42,6 +42,8 @@ public:
 
     static void sendTooManyRequests(AsyncWebServerRequest* request);
 
+    const WebApiWsLiveClass& getWsLive() const { return _webApiWsLive; }
+
 private:
     AsyncWebServer _server;
     AsyncEventSource _events;
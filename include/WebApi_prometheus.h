@@ -4,6 +4,14 @@
 #include <ESPAsyncWebServer.h>
 #include <Hoymiles.h>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// scrapes within this period are served from the same rendering
+#define PROMETHEUS_CACHE_TTL 5000
+// reserved in addition to the size of the previous rendering
+#define PROMETHEUS_RENDER_MARGIN 512
 
 class WebApiPrometheusClass {
 public:
@@ -11,14 +19,48 @@ public:
     void loop();
 
 private:
+    // appends to a string, formats without temporary heap allocations
+    class MetricsWriter {
+    public:
+        explicit MetricsWriter(std::string& buffer)
+            : _buffer(buffer)
+        {
+        }
+        void print(const char* s);
+        void printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+        // "# HELP" and "# TYPE" lines of a metric
+        void header(const char* name, const char* help, const char* type);
+
+    private:
+        std::string& _buffer;
+    };
+
     void onPrometheusMetricsGet(AsyncWebServerRequest* request);
 
-    void addField(AsyncResponseStream* stream, String& serial, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, const char* metricName, const char* channelName = NULL);
+    void render(MetricsWriter& stream);
+    void addSystemInfo(MetricsWriter& stream);
+    void addInverters(MetricsWriter& stream);
+    void addVedirect(MetricsWriter& stream);
+    void addBattery(MetricsWriter& stream);
+    void addHuawei(MetricsWriter& stream);
+    void addPowerMeter(MetricsWriter& stream);
+    void addPowerLimiter(MetricsWriter& stream);
+    void addLoopProfile(MetricsWriter& stream);
+
+    void addField(MetricsWriter& stream, String& serial, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, const char* metricName, const char* channelName = NULL);
 
-    void addPanelInfo(AsyncResponseStream* stream, String& serial, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel);
+    void addPanelInfo(MetricsWriter& stream, String& serial, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel);
 
     AsyncWebServer* _server;
 
+    // last rendering, shared with the responses still sending it.
+    // released by loop() once it expired and no response refers to it.
+    std::shared_ptr<std::string> _cache;
+    uint32_t _cacheTimestamp = 0;
+    size_t _lastRenderSize = 0;
+    std::mutex _mutex;
+
     enum MetricType_t {
         NONE = 0,
         GAUGE,
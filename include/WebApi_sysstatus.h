@@ -1,7 +1,13 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "HassDiscoveryPublisher.h"
+#include <ArduinoJson.h>
 #include <ESPAsyncWebServer.h>
+#include <HoymilesRadio.h>
+#include "LoopProfiler.h"
+
+#define SYSSTATUS_JSON_DOC_SIZE 7168
 
 class WebApiSysstatusClass {
 public:
@@ -10,6 +16,10 @@ public:
 
 private:
     void onSystemStatus(AsyncWebServerRequest* request);
+    static void addRadioStatistics(JsonObject& root, const RadioStatistics_t& stats);
+    static void addDiscoveryStatistics(JsonObject& root, const HassDiscoveryStatistics_t& stats);
+    static void addLoopStatistics(JsonObject& root);
+    static void addHistogram(JsonObject& root, const LoopProfilerClass::Histogram& histogram);
 
     AsyncWebServer* _server;
 };
\ No newline at end of file
@@ -1,9 +1,12 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "LiveDataPublisher.h"
 #include <ArduinoJson.h>
 #include <ESPAsyncWebServer.h>
 #include <Hoymiles.h>
+#include <memory>
+#include <mutex>
 
 class WebApiWsLiveClass {
 public:
@@ -11,20 +14,34 @@ public:
     void init(AsyncWebServer* server);
     void loop();
 
+    // size and duration of the most recent websocket publish
+    size_t getLastPublishBytes() const { return _lastPublishBytes; }
+    uint32_t getLastPublishMicros() const { return _lastPublishMicros; }
+
 private:
+    // inverters plus the totals of the other subsystems
+    static size_t getDocumentSize();
+    DynamicJsonDocument& getDocument();
     void generateJsonResponse(JsonVariant& root);
-    void addField(JsonObject& root, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, String topic = "");
+    void addField(JsonObject& root, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, const char* topic = nullptr);
     void addTotalField(JsonObject& root, String name, float value, String unit, uint8_t digits);
     void onLivedataStatus(AsyncWebServerRequest* request);
     void onWebsocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len);
 
     AsyncWebServer* _server;
     AsyncWebSocket _ws;
+    LiveDataPublisher _publisher;
+
+    std::unique_ptr<DynamicJsonDocument> _doc;
+    size_t _docSize = 0;
 
     uint32_t _lastWsPublish = 0;
     uint32_t _lastInvUpdateCheck = 0;
     uint32_t _lastWsCleanup = 0;
     uint32_t _newestInverterTimestamp = 0;
 
+    size_t _lastPublishBytes = 0;
+    uint32_t _lastPublishMicros = 0;
+
     std::mutex _mutex;
 };
\ No newline at end of file
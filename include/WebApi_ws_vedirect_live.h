@@ -2,6 +2,7 @@
 #pragma once
 
 #include "ArduinoJson.h"
+#include "LiveDataPublisher.h"
 #include <ESPAsyncWebServer.h>
 #include <VeDirectMpptController.h>
 
@@ -18,6 +19,7 @@ private:
 
     AsyncWebServer* _server;
     AsyncWebSocket _ws;
+    LiveDataPublisher _publisher;
 
     uint32_t _lastWsPublish = 0;
     uint32_t _lastVedirectUpdateCheck = 0;
@@ -21,120 +21,211 @@ void HoymilesClass::init()
     _pollInterval = 0;
     _radioNrf.reset(new HoymilesRadio_NRF());
     _radioCmt.reset(new HoymilesRadio_CMT());
+
+    xTaskCreatePinnedToCore(radioLoopHelper, "Hoymiles", HOY_RADIO_TASK_STACK_SIZE,
+        this, HOY_RADIO_TASK_PRIORITY, &_radioTaskHandle, HOY_RADIO_TASK_CORE);
+
+    _radioNrf->setTaskHandle(_radioTaskHandle);
+    _radioCmt->setTaskHandle(_radioTaskHandle);
 }
 
 void HoymilesClass::initNRF(SPIClass* initialisedSpiBus, uint8_t pinCE, uint8_t pinIRQ)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     _radioNrf->init(initialisedSpiBus, pinCE, pinIRQ);
 }
 
 void HoymilesClass::initCMT(int8_t pin_sdio, int8_t pin_clk, int8_t pin_cs, int8_t pin_fcs, int8_t pin_gpio2, int8_t pin_gpio3)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     _radioCmt->init(pin_sdio, pin_clk, pin_cs, pin_fcs, pin_gpio2, pin_gpio3);
 }
 
+void HoymilesClass::radioLoopHelper(void* context)
+{
+    auto instance = static_cast<HoymilesClass*>(context);
+    instance->radioLoop();
+}
+
+void HoymilesClass::radioLoop()
+{
+    while (true) {
+        // woken up by the radio interrupts. the timeout keeps the rx channel
+        // hopping, rx timeouts and the command queues serviced.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1));
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _radioNrf->loop();
+        _radioCmt->loop();
+    }
+}
+
 void HoymilesClass::loop()
 {
     std::lock_guard<std::mutex> lock(_mutex);
-    _radioNrf->loop();
-    _radioCmt->loop();
 
     if (getNumInverters() > 0) {
-        if (millis() - _lastPoll > (_pollInterval * 1000)) {
-            static uint8_t inverterPos = 0;
+        // inverters using different radios can be polled at the same time
+        uint32_t now = millis();
+        for (uint8_t i = 0; i < 2; i++) {
+            std::shared_ptr<InverterAbstract> iv = getNextInverterToPoll(now);
+            if (iv == nullptr) {
+                break;
+            }
+            pollInverter(iv, now);
+        }
 
-            std::shared_ptr<InverterAbstract> iv = getInverterByPos(inverterPos);
-            if ((iv == nullptr) || ((iv != nullptr) && (!iv->getRadio()->isInitialized()))) {
-                if (++inverterPos >= getNumInverters()) {
-                    inverterPos = 0;
+        // Perform housekeeping of all inverters on day change
+        int8_t currentWeekDay = Utils::getWeekDay();
+        static int8_t lastWeekDay = -1;
+        if (lastWeekDay == -1) {
+            lastWeekDay = currentWeekDay;
+        } else {
+            if (currentWeekDay != lastWeekDay) {
+
+                for (auto& inv : _inverters) {
+                    if (inv->getZeroYieldDayOnMidnight()) {
+                        inv->Statistics()->zeroDailyData();
+                    }
                 }
+
+                lastWeekDay = currentWeekDay;
             }
+        }
+    }
+}
 
-            if (iv != nullptr && iv->getRadio()->isInitialized() && iv->getRadio()->isQueueEmpty()) {
+std::shared_ptr<InverterAbstract> HoymilesClass::getNextInverterToPoll(uint32_t now)
+{
+    std::shared_ptr<InverterAbstract> next = nullptr;
+    int32_t nextOverdue = 0;
 
-                if (iv->getEnablePolling() || iv->getEnableCommands()) {
-                    _messageOutput->print("Fetch inverter: ");
-                    _messageOutput->println(iv->serial(), HEX);
+    for (auto& iv : _inverters) {
+        if (!iv->getRadio()->isInitialized() || !iv->getRadio()->isQueueEmpty()) {
+            continue;
+        }
 
-                    if (!iv->isReachable()) {
-                        iv->sendChangeChannelRequest();
-                    }
+        int32_t overdue = now - iv->PollSchedule()->nextPoll[POLL_STATS];
+        if (overdue < 0) {
+            continue;
+        }
 
-                    iv->sendStatsRequest();
+        // high priority inverters first, otherwise the longest overdue one
+        bool better = next == nullptr
+            || (iv->getPollPriority() && !next->getPollPriority())
+            || (iv->getPollPriority() == next->getPollPriority() && overdue > nextOverdue);
 
-                    // Fetch event log
-                    bool force = iv->EventLog()->getLastAlarmRequestSuccess() == CMD_NOK;
-                    iv->sendAlarmLogRequest(force);
+        if (better) {
+            next = iv;
+            nextOverdue = overdue;
+        }
+    }
 
-                    // Fetch limit
-                    if (((millis() - iv->SystemConfigPara()->getLastUpdateRequest() > HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL)
-                            && (millis() - iv->SystemConfigPara()->getLastUpdateCommand() > HOY_SYSTEM_CONFIG_PARA_POLL_MIN_DURATION))) {
-                        _messageOutput->println("Request SystemConfigPara");
-                        iv->sendSystemConfigParaRequest();
-                    }
+    return next;
+}
 
-                    // Set limit if required
-                    if (iv->SystemConfigPara()->getLastLimitCommandSuccess() == CMD_NOK) {
-                        _messageOutput->println("Resend ActivePowerControl");
-                        iv->resendActivePowerControlRequest();
-                    }
+uint32_t HoymilesClass::getStatsPollPeriod(std::shared_ptr<InverterAbstract> iv)
+{
+    uint32_t period = _pollInterval * 1000;
 
-                    // Set power status if required
-                    if (iv->PowerCommand()->getLastPowerCommandSuccess() == CMD_NOK) {
-                        _messageOutput->println("Resend PowerCommand");
-                        iv->resendPowerControlRequest();
-                    }
+    // inverters without priority are polled one after another, like a
+    // round robin over all inverters
+    if (!iv->getPollPriority()) {
+        period *= getNumInverters();
+    }
 
-                    // Fetch dev info (but first fetch stats)
-                    if (iv->Statistics()->getLastUpdate() > 0) {
-                        bool invalidDevInfo = !iv->DevInfo()->containsValidData()
-                            && iv->DevInfo()->getLastUpdateAll() > 0
-                            && iv->DevInfo()->getLastUpdateSimple() > 0;
-
-                        if (invalidDevInfo) {
-                            _messageOutput->println("DevInfo: No Valid Data");
-                        }
-
-                        if ((iv->DevInfo()->getLastUpdateAll() == 0)
-                            || (iv->DevInfo()->getLastUpdateSimple() == 0)
-                            || invalidDevInfo) {
-                            _messageOutput->println("Request device info");
-                            iv->sendDevInfoRequest();
-                        }
-                    }
+    if (!iv->getEnablePolling()) {
+        // only pending commands need to be resent
+        period <<= HOY_POLL_BACKOFF_MAX_SHIFT;
+    } else if (!iv->isReachable()) {
+        uint32_t failures = iv->Statistics()->getRxFailureCount() - iv->getReachableThreshold();
+        period <<= min<uint32_t>(failures, HOY_POLL_BACKOFF_MAX_SHIFT);
+    }
 
-                    // Fetch grid profile
-                    if (iv->Statistics()->getLastUpdate() > 0 && iv->GridProfile()->getLastUpdate() == 0) {
-                        iv->sendGridOnProFileParaRequest();
-                    }
+    return period;
+}
 
-                    _lastPoll = millis();
-                }
+void HoymilesClass::pollInverter(std::shared_ptr<InverterAbstract> iv, uint32_t now)
+{
+    pollSchedule_t* schedule = iv->PollSchedule();
+    schedule->nextPoll[POLL_STATS] = now + getStatsPollPeriod(iv);
+
+    uint32_t lastStatsUpdate = iv->Statistics()->getLastUpdate();
+    if (lastStatsUpdate != schedule->lastStatsUpdate) {
+        if (schedule->lastStatsUpdate > 0) {
+            uint32_t interval = lastStatsUpdate - schedule->lastStatsUpdate;
+            schedule->statsInterval = (schedule->statsInterval == 0) ? interval : (3 * schedule->statsInterval + interval) / 4;
+        }
+        schedule->lastStatsUpdate = lastStatsUpdate;
+    }
 
-                if (++inverterPos >= getNumInverters()) {
-                    inverterPos = 0;
-                }
-            }
+    if (!iv->getEnablePolling() && !iv->getEnableCommands()) {
+        return;
+    }
 
-            // Perform housekeeping of all inverters on day change
-            int8_t currentWeekDay = Utils::getWeekDay();
-            static int8_t lastWeekDay = -1;
-            if (lastWeekDay == -1) {
-                lastWeekDay = currentWeekDay;
-            } else {
-                if (currentWeekDay != lastWeekDay) {
+    _messageOutput->print("Fetch inverter: ");
+    _messageOutput->println(iv->serial(), HEX);
 
-                    for (auto& inv : _inverters) {
-                        if (inv->getZeroYieldDayOnMidnight()) {
-                            inv->Statistics()->zeroDailyData();
-                        }
-                    }
+    if (!iv->isReachable()) {
+        iv->sendChangeChannelRequest();
+    }
 
-                    lastWeekDay = currentWeekDay;
-                }
+    iv->sendStatsRequest();
+
+    // Fetch event log
+    if (static_cast<int32_t>(now - schedule->nextPoll[POLL_ALARM_LOG]) >= 0) {
+        bool force = iv->EventLog()->getLastAlarmRequestSuccess() == CMD_NOK;
+        if (iv->sendAlarmLogRequest(force)) {
+            schedule->nextPoll[POLL_ALARM_LOG] = now + HOY_ALARM_LOG_POLL_INTERVAL;
+        }
+    }
+
+    // Fetch limit
+    if (((millis() - iv->SystemConfigPara()->getLastUpdateRequest() > HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL)
+            && (millis() - iv->SystemConfigPara()->getLastUpdateCommand() > HOY_SYSTEM_CONFIG_PARA_POLL_MIN_DURATION))) {
+        _messageOutput->println("Request SystemConfigPara");
+        iv->sendSystemConfigParaRequest();
+    }
+
+    // Set limit if required
+    if (iv->SystemConfigPara()->getLastLimitCommandSuccess() == CMD_NOK) {
+        _messageOutput->println("Resend ActivePowerControl");
+        iv->resendActivePowerControlRequest();
+    }
+
+    // Set power status if required
+    if (iv->PowerCommand()->getLastPowerCommandSuccess() == CMD_NOK) {
+        _messageOutput->println("Resend PowerCommand");
+        iv->resendPowerControlRequest();
+    }
+
+    // Fetch dev info (but first fetch stats)
+    if (iv->Statistics()->getLastUpdate() > 0 && static_cast<int32_t>(now - schedule->nextPoll[POLL_DEV_INFO]) >= 0) {
+        bool invalidDevInfo = !iv->DevInfo()->containsValidData()
+            && iv->DevInfo()->getLastUpdateAll() > 0
+            && iv->DevInfo()->getLastUpdateSimple() > 0;
+
+        if (invalidDevInfo) {
+            _messageOutput->println("DevInfo: No Valid Data");
+        }
+
+        if ((iv->DevInfo()->getLastUpdateAll() == 0)
+            || (iv->DevInfo()->getLastUpdateSimple() == 0)
+            || invalidDevInfo) {
+            _messageOutput->println("Request device info");
+            if (iv->sendDevInfoRequest()) {
+                schedule->nextPoll[POLL_DEV_INFO] = now + HOY_DEV_INFO_POLL_INTERVAL;
             }
         }
     }
+
+    // Fetch grid profile
+    if (iv->Statistics()->getLastUpdate() > 0 && iv->GridProfile()->getLastUpdate() == 0
+        && static_cast<int32_t>(now - schedule->nextPoll[POLL_GRID_PROFILE]) >= 0) {
+        if (iv->sendGridOnProFileParaRequest()) {
+            schedule->nextPoll[POLL_GRID_PROFILE] = now + HOY_GRID_PROFILE_POLL_INTERVAL;
+        }
+    }
 }
 
 std::shared_ptr<InverterAbstract> HoymilesClass::addInverter(const char* name, uint64_t serial)
@@ -161,6 +252,7 @@ std::shared_ptr<InverterAbstract> HoymilesClass::addInverter(const char* name, u
     if (i) {
         i->setName(name);
         i->init();
+        std::lock_guard<std::mutex> lock(_mutex);
         _inverters.push_back(std::move(i));
         return _inverters.back();
     }
@@ -265,18 +357,3 @@ Print* HoymilesClass::getMessageOutput()
 {
     return _messageOutput;
 }
-
-class Silent : public Print {
-    public:
-        size_t write(uint8_t c) final { return 0; }
-};
-
-Silent Dummy;
-
-Print* HoymilesClass::getVerboseMessageOutput()
-{
-    if (_verboseLogging) {
-        return _messageOutput;
-    }
-    return &Dummy;
-}
@@ -5,6 +5,7 @@
 #include "HoymilesRadio_NRF.h"
 #include "inverters/InverterAbstract.h"
 #include "types.h"
+#include <LogLevel.h>
 #include <Print.h>
 #include <SPI.h>
 #include <memory>
@@ -12,6 +13,23 @@
 
 #define HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL (2 * 60 * 1000) // 2 minutes
 #define HOY_SYSTEM_CONFIG_PARA_POLL_MIN_DURATION (4 * 60 * 1000) // at least 4 minutes between sending limit command and read request. Otherwise eventlog entry
+#define HOY_ALARM_LOG_POLL_INTERVAL (30 * 1000) // at most every 30 seconds, only if the event count changed
+#define HOY_DEV_INFO_POLL_INTERVAL (60 * 1000) // retry every minute until valid data was received
+#define HOY_GRID_PROFILE_POLL_INTERVAL (60 * 1000) // retry every minute until received
+#define HOY_POLL_BACKOFF_MAX_SHIFT 3 // unreachable inverters are polled up to 8 times less often
+
+// the radios are serviced by a dedicated task which preempts the main loop
+#ifndef HOY_RADIO_TASK_PRIORITY
+#define HOY_RADIO_TASK_PRIORITY 5
+#endif
+#ifndef HOY_RADIO_TASK_CORE
+#define HOY_RADIO_TASK_CORE 1
+#endif
+#define HOY_RADIO_TASK_STACK_SIZE 6144
+
+#ifndef HOY_LOG_LEVEL
+#define HOY_LOG_LEVEL LOG_LEVEL
+#endif
 
 class HoymilesClass {
 public:
@@ -22,7 +40,7 @@ public:
 
     void setMessageOutput(Print* output);
     Print* getMessageOutput();
-    Print* getVerboseMessageOutput();
+    bool isVerboseLogging() const { return LOG_ENABLED(LOG_LEVEL_VERBOSE, HOY_LOG_LEVEL, _verboseLogging); }
 
     std::shared_ptr<InverterAbstract> addInverter(const char* name, uint64_t serial);
     std::shared_ptr<InverterAbstract> getInverterByPos(uint8_t pos);
@@ -41,15 +59,22 @@ public:
     bool isAllRadioIdle();
 
 private:
+    static void radioLoopHelper(void* context);
+    void radioLoop();
+
+    std::shared_ptr<InverterAbstract> getNextInverterToPoll(uint32_t now);
+    uint32_t getStatsPollPeriod(std::shared_ptr<InverterAbstract> iv);
+    void pollInverter(std::shared_ptr<InverterAbstract> iv, uint32_t now);
+
     std::vector<std::shared_ptr<InverterAbstract>> _inverters;
     std::unique_ptr<HoymilesRadio_NRF> _radioNrf;
     std::unique_ptr<HoymilesRadio_CMT> _radioCmt;
 
     std::mutex _mutex;
+    TaskHandle_t _radioTaskHandle = nullptr;
 
     uint32_t _pollInterval = 0;
     bool _verboseLogging = true;
-    uint32_t _lastPoll = 0;
 
     Print* _messageOutput = &Serial;
 };
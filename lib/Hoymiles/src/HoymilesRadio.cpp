@@ -5,6 +5,7 @@
 #include "HoymilesRadio.h"
 #include "Hoymiles.h"
 #include "crc.h"
+#include <algorithm>
 
 serial_u HoymilesRadio::DtuSerial()
 {
@@ -28,6 +29,75 @@ serial_u HoymilesRadio::convertSerialToRadioId(serial_u serial)
     return radioId;
 }
 
+bool HoymilesRadio::enqueCommand(std::shared_ptr<CommandAbstract> cmd)
+{
+    if (_newCommands.try_push(cmd)) {
+        return true;
+    }
+
+    Hoymiles.getMessageOutput()->println("Command queue full, dropping command");
+    _txDropped++;
+
+    auto inv = Hoymiles.getInverterBySerial(cmd->getTargetAddress());
+    if (nullptr != inv) {
+        cmd->gotTimeout(inv.get());
+    }
+    return false;
+}
+
+void HoymilesRadio::takeNewCommands()
+{
+    std::shared_ptr<CommandAbstract> cmd;
+    while (_commandQueueSize < _commandQueue.size() && _newCommands.try_pop(cmd)) {
+        insertCommand(std::move(cmd));
+    }
+}
+
+void HoymilesRadio::insertCommand(std::shared_ptr<CommandAbstract> cmd)
+{
+    size_t size = _commandQueueSize;
+
+    // the first command might already be sent and has to stay in place
+    size_t begin = std::min<size_t>(size, 1);
+
+    for (size_t i = begin; i < size; i++) {
+        if (_commandQueue[i]->isSupersededBy(cmd.get())) {
+            _commandQueue[i] = std::move(cmd);
+            _statistics.TxCoalesced++;
+            return;
+        }
+    }
+
+    size_t pos = size;
+    if (cmd->isControlCommand()) {
+        for (pos = begin; pos < size && _commandQueue[pos]->isControlCommand(); pos++) { }
+        if (pos != size) {
+            _statistics.TxPreempted++;
+        }
+    }
+
+    std::move_backward(_commandQueue.begin() + pos, _commandQueue.begin() + size, _commandQueue.begin() + size + 1);
+    _commandQueue[pos] = std::move(cmd);
+    _commandQueueSize = size + 1;
+}
+
+CommandAbstract* HoymilesRadio::frontCommand()
+{
+    return _commandQueue[0].get();
+}
+
+void HoymilesRadio::popCommand()
+{
+    size_t size = _commandQueueSize;
+    if (size == 0) {
+        return;
+    }
+
+    std::move(_commandQueue.begin() + 1, _commandQueue.begin() + size, _commandQueue.begin());
+    _commandQueue[size - 1].reset();
+    _commandQueueSize = size - 1;
+}
+
 bool HoymilesRadio::checkFragmentCrc(fragment_t* fragment)
 {
     uint8_t crc = crc8(fragment->fragment, fragment->len - 1);
@@ -36,29 +106,35 @@ bool HoymilesRadio::checkFragmentCrc(fragment_t* fragment)
 
 void HoymilesRadio::sendRetransmitPacket(uint8_t fragment_id)
 {
-    CommandAbstract* cmd = _commandQueue.front().get();
+    CommandAbstract* cmd = frontCommand();
 
     CommandAbstract* requestCmd = cmd->getRequestFrameCommand(fragment_id);
 
     if (requestCmd != nullptr) {
+        _statistics.TxReRequestFragment++;
         sendEsbPacket(requestCmd);
     }
 }
 
 void HoymilesRadio::sendLastPacketAgain()
 {
-    CommandAbstract* cmd = _commandQueue.front().get();
+    CommandAbstract* cmd = frontCommand();
+    _statistics.TxResendWhole++;
     sendEsbPacket(cmd);
 }
 
 void HoymilesRadio::handleReceivedPackage()
 {
+    takeNewCommands();
+
     if (_busyFlag && _rxTimeout.occured()) {
-        Hoymiles.getVerboseMessageOutput()->println("RX Period End");
-        std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterBySerial(_commandQueue.front().get()->getTargetAddress());
+        if (Hoymiles.isVerboseLogging()) {
+            Hoymiles.getMessageOutput()->println("RX Period End");
+        }
+        std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterBySerial(frontCommand()->getTargetAddress());
 
         if (nullptr != inv) {
-            CommandAbstract* cmd = _commandQueue.front().get();
+            CommandAbstract* cmd = frontCommand();
             uint8_t verifyResult = inv->verifyAllFragments(cmd);
             if (verifyResult == FRAGMENT_ALL_MISSING_RESEND) {
                 Hoymiles.getMessageOutput()->println("Nothing received, resend whole request");
@@ -66,17 +142,20 @@ void HoymilesRadio::handleReceivedPackage()
 
             } else if (verifyResult == FRAGMENT_ALL_MISSING_TIMEOUT) {
                 Hoymiles.getMessageOutput()->println("Nothing received, resend count exeeded");
-                _commandQueue.pop();
+                _statistics.RxFailNothing++;
+                popCommand();
                 _busyFlag = false;
 
             } else if (verifyResult == FRAGMENT_RETRANSMIT_TIMEOUT) {
                 Hoymiles.getMessageOutput()->println("Retransmit timeout");
-                _commandQueue.pop();
+                _statistics.RxFailPartial++;
+                popCommand();
                 _busyFlag = false;
 
             } else if (verifyResult == FRAGMENT_HANDLE_ERROR) {
                 Hoymiles.getMessageOutput()->println("Packet handling error");
-                _commandQueue.pop();
+                _statistics.RxFailCorrupt++;
+                popCommand();
                 _busyFlag = false;
 
             } else if (verifyResult > 0) {
@@ -88,27 +167,29 @@ void HoymilesRadio::handleReceivedPackage()
             } else {
                 // Successful received all packages
                 Hoymiles.getMessageOutput()->println("Success");
-                _commandQueue.pop();
+                _statistics.RxSuccess++;
+                popCommand();
                 _busyFlag = false;
             }
         } else {
             // If inverter was not found, assume the command is invalid
             Hoymiles.getMessageOutput()->println("RX: Invalid inverter found");
-            _commandQueue.pop();
+            popCommand();
             _busyFlag = false;
         }
     } else if (!_busyFlag) {
         // Currently in idle mode --> send packet if one is in the queue
-        if (!isQueueEmpty()) {
-            CommandAbstract* cmd = _commandQueue.front().get();
+        if (_commandQueueSize > 0) {
+            CommandAbstract* cmd = frontCommand();
 
             auto inv = Hoymiles.getInverterBySerial(cmd->getTargetAddress());
             if (nullptr != inv) {
                 inv->clearRxFragmentBuffer();
+                _statistics.TxRequestData++;
                 sendEsbPacket(cmd);
             } else {
                 Hoymiles.getMessageOutput()->println("TX: Invalid inverter found");
-                _commandQueue.pop();
+                popCommand();
             }
         }
     }
@@ -117,10 +198,10 @@ void HoymilesRadio::handleReceivedPackage()
 void HoymilesRadio::dumpBuf(const uint8_t buf[], uint8_t len, bool appendNewline)
 {
     for (uint8_t i = 0; i < len; i++) {
-        Hoymiles.getVerboseMessageOutput()->printf("%02X ", buf[i]);
+        Hoymiles.getMessageOutput()->printf("%02X ", buf[i]);
     }
     if (appendNewline) {
-        Hoymiles.getVerboseMessageOutput()->println("");
+        Hoymiles.getMessageOutput()->println("");
     }
 }
 
@@ -136,5 +217,31 @@ bool HoymilesRadio::isIdle()
 
 bool HoymilesRadio::isQueueEmpty()
 {
-    return _commandQueue.size() == 0;
+    return _commandQueueSize == 0 && _newCommands.empty();
+}
+
+void HoymilesRadio::setTaskHandle(TaskHandle_t handle)
+{
+    _taskHandle = handle;
+}
+
+RadioStatistics_t HoymilesRadio::getStatistics()
+{
+    RadioStatistics_t statistics = _statistics;
+    statistics.TxDropped = _txDropped;
+    statistics.TxQueueHighWater = _newCommands.getHighWaterMark();
+    return statistics;
+}
+
+void ARDUINO_ISR_ATTR HoymilesRadio::notifyTaskFromISR()
+{
+    if (_taskHandle == nullptr) {
+        return;
+    }
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(_taskHandle, &higherPriorityTaskWoken);
+    if (higherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
 }
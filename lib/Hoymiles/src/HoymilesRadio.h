@@ -1,11 +1,44 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "SpscRingBuffer.h"
 #include "TimeoutHelper.h"
 #include "commands/CommandAbstract.h"
 #include "types.h"
+#include <Arduino.h>
+#include <MpscQueue.h>
+#include <array>
+#include <atomic>
 #include <memory>
-#include <ThreadSafeQueue.h>
+#include <mutex>
+
+// number of fragments held in the rx buffer, must be a power of two
+#define FRAGMENT_BUFFER_SIZE 32
+
+// number of commands waiting to be sent, must be a power of two
+#define COMMAND_QUEUE_SIZE 32
+
+typedef struct {
+    // TX requests
+    uint32_t TxRequestData;
+    uint32_t TxReRequestFragment;
+    uint32_t TxResendWhole;
+    uint32_t TxCoalesced; // replaced by a newer command before being sent
+    uint32_t TxPreempted; // queued ahead of data requests
+    uint32_t TxDropped; // command queue was full
+    uint32_t TxQueueHighWater; // maximum number of commands handed over at once
+
+    // received fragments
+    uint32_t RxFragments;
+    uint32_t RxFragmentsCorrupt;
+    uint32_t RxFragmentsDropped;
+
+    // request results
+    uint32_t RxSuccess;
+    uint32_t RxFailNothing;
+    uint32_t RxFailPartial;
+    uint32_t RxFailCorrupt;
+} RadioStatistics_t;
 
 class HoymilesRadio {
 public:
@@ -16,10 +49,15 @@ public:
     bool isQueueEmpty();
     bool isInitialized();
 
-    void enqueCommand(std::shared_ptr<CommandAbstract> cmd)
-    {
-        _commandQueue.push(cmd);
-    }
+    // the radio task which calls loop(), woken up by the radio interrupts
+    void setTaskHandle(TaskHandle_t handle);
+    RadioStatistics_t getStatistics();
+
+    // may be called from any task. the command is handed over to the radio
+    // task, which queues control commands ahead of data requests that were
+    // not sent yet and lets them replace a pending command of the same kind.
+    // returns false if the command was dropped as the queue is full.
+    bool enqueCommand(std::shared_ptr<CommandAbstract> cmd);
 
     template <typename T>
     std::shared_ptr<T> prepareCommand()
@@ -29,6 +67,7 @@ public:
 
 protected:
     static serial_u convertSerialToRadioId(serial_u serial);
+    // callers check Hoymiles.isVerboseLogging() first
     void dumpBuf(const uint8_t buf[], uint8_t len, bool appendNewline = true);
 
     bool checkFragmentCrc(fragment_t* fragment);
@@ -36,11 +75,37 @@ protected:
     void sendRetransmitPacket(uint8_t fragment_id);
     void sendLastPacketAgain();
     void handleReceivedPackage();
+    void ARDUINO_ISR_ATTR notifyTaskFromISR();
 
     serial_u _dtuSerial;
-    ThreadSafeQueue<std::shared_ptr<CommandAbstract>> _commandQueue;
     bool _isInitialized = false;
-    bool _busyFlag = false;
+    std::atomic<bool> _busyFlag = false;
 
     TimeoutHelper _rxTimeout;
+
+    // filled right after the radio interrupt and parsed afterwards, both
+    // from within loop()
+    SpscRingBuffer<fragment_t, FRAGMENT_BUFFER_SIZE> _rxBuffer;
+
+    // loop() runs in the radio task, this serializes access to the radio
+    // module by the public setters which are called from other tasks.
+    std::mutex _mutex;
+    TaskHandle_t _taskHandle = nullptr;
+
+    RadioStatistics_t _statistics = {};
+    std::atomic<uint32_t> _txDropped = 0;
+
+private:
+    void takeNewCommands();
+    void insertCommand(std::shared_ptr<CommandAbstract> cmd);
+    CommandAbstract* frontCommand();
+    void popCommand();
+
+    // handover from the tasks creating commands to the radio task
+    MpscQueue<std::shared_ptr<CommandAbstract>, COMMAND_QUEUE_SIZE> _newCommands;
+
+    // commands in the order they are sent, only accessed by the radio task.
+    // the first command is the one currently on air.
+    std::array<std::shared_ptr<CommandAbstract>, COMMAND_QUEUE_SIZE> _commandQueue;
+    std::atomic<size_t> _commandQueueSize = 0;
 };
\ No newline at end of file
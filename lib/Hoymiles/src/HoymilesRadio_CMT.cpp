@@ -88,6 +88,8 @@ void HoymilesRadio_CMT::loop()
         return;
     }
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     if (!_gpio3_configured) {
         if (_radio->rxFifoAvailable()) { // read INT2, PKT_OK flag
             _packetReceived = true;
@@ -95,60 +97,68 @@ void HoymilesRadio_CMT::loop()
     }
 
     if (_packetReceived) {
-        Hoymiles.getVerboseMessageOutput()->println("Interrupt received");
+        if (Hoymiles.isVerboseLogging()) {
+            Hoymiles.getMessageOutput()->println("Interrupt received");
+        }
+        // cleared first to not miss an interrupt while draining the fifo
+        _packetReceived = false;
         while (_radio->available()) {
-            if (!(_rxBuffer.size() > FRAGMENT_BUFFER_SIZE)) {
-                fragment_t f;
-                memset(f.fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
-                f.len = _radio->getDynamicPayloadSize();
-                f.channel = _radio->getChannel();
-                f.rssi = _radio->getRssiDBm();
-                if (f.len > MAX_RF_PAYLOAD_SIZE) {
-                    f.len = MAX_RF_PAYLOAD_SIZE;
-                }
-                _radio->read(f.fragment, f.len);
-                _rxBuffer.push(f);
-            } else {
+            fragment_t* f = _rxBuffer.reserve();
+            if (f == nullptr) {
                 Hoymiles.getMessageOutput()->println("CMT: Buffer full");
-                _radio->flush_rx();
+                _statistics.RxFragmentsDropped++;
+                break;
             }
+
+            memset(f->fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
+            f->len = _radio->getDynamicPayloadSize();
+            f->channel = _radio->getChannel();
+            f->rssi = _radio->getRssiDBm();
+            f->timestamp = millis();
+            if (f->len > MAX_RF_PAYLOAD_SIZE) {
+                f->len = MAX_RF_PAYLOAD_SIZE;
+            }
+            _radio->read(f->fragment, f->len);
+            _rxBuffer.commit();
         }
         _radio->flush_rx();
-        _packetReceived = false;
-
-    } else {
-        // Perform package parsing only if no packages are received
-        if (!_rxBuffer.empty()) {
-            fragment_t f = _rxBuffer.back();
-            if (checkFragmentCrc(&f)) {
+    }
 
-                serial_u dtuId = convertSerialToRadioId(_dtuSerial);
+    // Perform package parsing only if no packages are received
+    fragment_t* f;
+    while (!_packetReceived && (f = _rxBuffer.front()) != nullptr) {
+        if (checkFragmentCrc(f)) {
 
-                // The CMT RF module does not filter foreign packages by itself.
-                // Has to be done manually here.
-                if (memcmp(&f.fragment[5], &dtuId.b[1], 4) == 0) {
+            serial_u dtuId = convertSerialToRadioId(_dtuSerial);
 
-                    std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterByFragment(&f);
+            // The CMT RF module does not filter foreign packages by itself.
+            // Has to be done manually here.
+            if (memcmp(&f->fragment[5], &dtuId.b[1], 4) == 0) {
 
-                    if (nullptr != inv) {
-                        // Save packet in inverter rx buffer
-                        Hoymiles.getVerboseMessageOutput()->printf("RX %.2f MHz --> ", getFrequencyFromChannel(f.channel));
-                        dumpBuf(f.fragment, f.len, false);
-                        Hoymiles.getVerboseMessageOutput()->printf("| %d dBm\r\n", f.rssi);
+                std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterByFragment(f);
 
-                        inv->addRxFragment(f.fragment, f.len);
-                    } else {
-                        Hoymiles.getMessageOutput()->println("Inverter Not found!");
+                if (nullptr != inv) {
+                    // Save packet in inverter rx buffer
+                    if (Hoymiles.isVerboseLogging()) {
+                        Hoymiles.getMessageOutput()->printf("RX %.2f MHz --> ", getFrequencyFromChannel(f->channel));
+                        dumpBuf(f->fragment, f->len, false);
+                        Hoymiles.getMessageOutput()->printf("| %d dBm | %u ms\r\n", f->rssi, static_cast<unsigned>(millis() - f->timestamp));
                     }
-                }
 
-            } else {
-                Hoymiles.getMessageOutput()->println("Frame kaputt"); // ;-)
+                    inv->addRxFragment(f->fragment, f->len);
+                    _statistics.RxFragments++;
+                } else {
+                    Hoymiles.getMessageOutput()->println("Inverter Not found!");
+                }
             }
 
-            // Remove paket from buffer even it was corrupted
-            _rxBuffer.pop();
+        } else {
+            Hoymiles.getMessageOutput()->println("Frame kaputt"); // ;-)
+            _statistics.RxFragmentsCorrupt++;
         }
+
+        // Remove paket from buffer even it was corrupted
+        _rxBuffer.pop();
     }
 
     handleReceivedPackage();
@@ -160,6 +170,7 @@ void HoymilesRadio_CMT::setPALevel(int8_t paLevel)
         return;
     }
 
+    std::lock_guard<std::mutex> lock(_mutex);
     if (_radio->setPALevel(paLevel)) {
         Hoymiles.getMessageOutput()->printf("CMT TX power set to %d dBm\r\n", paLevel);
     } else {
@@ -173,6 +184,7 @@ void HoymilesRadio_CMT::setInverterTargetFrequency(uint32_t frequency)
     if (!_isInitialized) {
         return;
     }
+    std::lock_guard<std::mutex> lock(_mutex);
     cmtSwitchDtuFreq(_inverterTargetFrequency);
 }
 
@@ -186,6 +198,7 @@ bool HoymilesRadio_CMT::isConnected()
     if (!_isInitialized) {
         return false;
     }
+    std::lock_guard<std::mutex> lock(_mutex);
     return _radio->isChipConnected();
 }
 
@@ -202,11 +215,13 @@ uint32_t HoymilesRadio_CMT::getMaxFrequency()
 void ARDUINO_ISR_ATTR HoymilesRadio_CMT::handleInt1()
 {
     _packetSent = true;
+    notifyTaskFromISR();
 }
 
 void ARDUINO_ISR_ATTR HoymilesRadio_CMT::handleInt2()
 {
     _packetReceived = true;
+    notifyTaskFromISR();
 }
 
 void HoymilesRadio_CMT::sendEsbPacket(CommandAbstract* cmd)
@@ -221,9 +236,11 @@ void HoymilesRadio_CMT::sendEsbPacket(CommandAbstract* cmd)
         cmtSwitchDtuFreq(HOY_BOOT_FREQ / 1000);
     }
 
-    Hoymiles.getVerboseMessageOutput()->printf("TX %s %.2f MHz --> ",
-        cmd->getCommandName().c_str(), getFrequencyFromChannel(_radio->getChannel()));
-    cmd->dumpDataPayload(Hoymiles.getVerboseMessageOutput());
+    if (Hoymiles.isVerboseLogging()) {
+        Hoymiles.getMessageOutput()->printf("TX %s %.2f MHz --> ",
+            cmd->getCommandName().c_str(), getFrequencyFromChannel(_radio->getChannel()));
+        cmd->dumpDataPayload(Hoymiles.getMessageOutput());
+    }
 
     if (!_radio->write(cmd->getDataPayload(), cmd->getDataSize())) {
         Hoymiles.getMessageOutput()->println("TX SPI Timeout");
@@ -7,10 +7,6 @@
 #include <Arduino.h>
 #include <cmt2300wrapper.h>
 #include <memory>
-#include <queue>
-
-// number of fragments hold in buffer
-#define FRAGMENT_BUFFER_SIZE 30
 
 #ifndef HOYMILES_CMT_WORK_FREQ
 #define HOYMILES_CMT_WORK_FREQ 865000
@@ -46,7 +42,6 @@ private:
     bool _gpio2_configured = false;
     bool _gpio3_configured = false;
 
-    std::queue<fragment_t> _rxBuffer;
     TimeoutHelper _txTimeout;
 
     uint32_t _inverterTargetFrequency = HOYMILES_CMT_WORK_FREQ;
@@ -42,56 +42,67 @@ void HoymilesRadio_NRF::loop()
         return;
     }
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     EVERY_N_MILLIS(4)
     {
         switchRxCh();
     }
 
     if (_packetReceived) {
-        Hoymiles.getVerboseMessageOutput()->println("Interrupt received");
+        if (Hoymiles.isVerboseLogging()) {
+            Hoymiles.getMessageOutput()->println("Interrupt received");
+        }
+        // cleared first to not miss an interrupt while draining the fifo
+        _packetReceived = false;
         while (_radio->available()) {
-            if (!(_rxBuffer.size() > FRAGMENT_BUFFER_SIZE)) {
-                fragment_t f;
-                memset(f.fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
-                f.len = _radio->getDynamicPayloadSize();
-                f.channel = _radio->getChannel();
-                f.rssi = _radio->testRPD() ? -30 : -80;
-                if (f.len > MAX_RF_PAYLOAD_SIZE)
-                    f.len = MAX_RF_PAYLOAD_SIZE;
-                _radio->read(f.fragment, f.len);
-                _rxBuffer.push(f);
-            } else {
+            fragment_t* f = _rxBuffer.reserve();
+            if (f == nullptr) {
                 Hoymiles.getMessageOutput()->println("NRF: Buffer full");
+                _statistics.RxFragmentsDropped++;
                 _radio->flush_rx();
+                break;
             }
+
+            memset(f->fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
+            f->len = _radio->getDynamicPayloadSize();
+            f->channel = _radio->getChannel();
+            f->rssi = _radio->testRPD() ? -30 : -80;
+            f->timestamp = millis();
+            if (f->len > MAX_RF_PAYLOAD_SIZE)
+                f->len = MAX_RF_PAYLOAD_SIZE;
+            _radio->read(f->fragment, f->len);
+            _rxBuffer.commit();
         }
-        _packetReceived = false;
+    }
 
-    } else {
-        // Perform package parsing only if no packages are received
-        if (!_rxBuffer.empty()) {
-            fragment_t f = _rxBuffer.back();
-            if (checkFragmentCrc(&f)) {
-                std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterByFragment(&f);
-
-                if (nullptr != inv) {
-                    // Save packet in inverter rx buffer
-                    Hoymiles.getVerboseMessageOutput()->printf("RX Channel: %d --> ", f.channel);
-                    dumpBuf(f.fragment, f.len, false);
-                    Hoymiles.getVerboseMessageOutput()->printf("| %d dBm\r\n", f.rssi);
-
-                    inv->addRxFragment(f.fragment, f.len);
-                } else {
-                    Hoymiles.getMessageOutput()->println("Inverter Not found!");
+    // Perform package parsing only if no packages are received
+    fragment_t* f;
+    while (!_packetReceived && (f = _rxBuffer.front()) != nullptr) {
+        if (checkFragmentCrc(f)) {
+            std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterByFragment(f);
+
+            if (nullptr != inv) {
+                // Save packet in inverter rx buffer
+                if (Hoymiles.isVerboseLogging()) {
+                    Hoymiles.getMessageOutput()->printf("RX Channel: %d --> ", f->channel);
+                    dumpBuf(f->fragment, f->len, false);
+                    Hoymiles.getMessageOutput()->printf("| %d dBm | %u ms\r\n", f->rssi, static_cast<unsigned>(millis() - f->timestamp));
                 }
 
+                inv->addRxFragment(f->fragment, f->len);
+                _statistics.RxFragments++;
             } else {
-                Hoymiles.getMessageOutput()->println("Frame kaputt");
+                Hoymiles.getMessageOutput()->println("Inverter Not found!");
             }
 
-            // Remove paket from buffer even it was corrupted
-            _rxBuffer.pop();
+        } else {
+            Hoymiles.getMessageOutput()->println("Frame kaputt");
+            _statistics.RxFragmentsCorrupt++;
         }
+
+        // Remove paket from buffer even it was corrupted
+        _rxBuffer.pop();
     }
 
     handleReceivedPackage();
@@ -102,6 +113,7 @@ void HoymilesRadio_NRF::setPALevel(rf24_pa_dbm_e paLevel)
     if (!_isInitialized) {
         return;
     }
+    std::lock_guard<std::mutex> lock(_mutex);
     _radio->setPALevel(paLevel);
 }
 
@@ -112,6 +124,7 @@ void HoymilesRadio_NRF::setDtuSerial(uint64_t serial)
     if (!_isInitialized) {
         return;
     }
+    std::lock_guard<std::mutex> lock(_mutex);
     openReadingPipe();
 }
 
@@ -120,6 +133,7 @@ bool HoymilesRadio_NRF::isConnected()
     if (!_isInitialized) {
         return false;
     }
+    std::lock_guard<std::mutex> lock(_mutex);
     return _radio->isChipConnected();
 }
 
@@ -128,6 +142,7 @@ bool HoymilesRadio_NRF::isPVariant()
     if (!_isInitialized) {
         return false;
     }
+    std::lock_guard<std::mutex> lock(_mutex);
     return _radio->isPVariant();
 }
 
@@ -148,6 +163,7 @@ void HoymilesRadio_NRF::openWritingPipe(serial_u serial)
 void ARDUINO_ISR_ATTR HoymilesRadio_NRF::handleIntr()
 {
     _packetReceived = true;
+    notifyTaskFromISR();
 }
 
 uint8_t HoymilesRadio_NRF::getRxNxtChannel()
@@ -185,9 +201,11 @@ void HoymilesRadio_NRF::sendEsbPacket(CommandAbstract* cmd)
     openWritingPipe(s);
     _radio->setRetries(3, 15);
 
-    Hoymiles.getVerboseMessageOutput()->printf("TX %s Channel: %d --> ",
-        cmd->getCommandName().c_str(), _radio->getChannel());
-    cmd->dumpDataPayload(Hoymiles.getVerboseMessageOutput());
+    if (Hoymiles.isVerboseLogging()) {
+        Hoymiles.getMessageOutput()->printf("TX %s Channel: %d --> ",
+            cmd->getCommandName().c_str(), _radio->getChannel());
+        cmd->dumpDataPayload(Hoymiles.getMessageOutput());
+    }
     _radio->write(cmd->getDataPayload(), cmd->getDataSize());
 
     _radio->setRetries(0, 0);
@@ -6,10 +6,6 @@
 #include <RF24.h>
 #include <memory>
 #include <nRF24L01.h>
-#include <queue>
-
-// number of fragments hold in buffer
-#define FRAGMENT_BUFFER_SIZE 30
 
 class HoymilesRadio_NRF : public HoymilesRadio {
 public:
@@ -42,5 +38,4 @@ private:
 
     volatile bool _packetReceived = false;
 
-    std::queue<fragment_t> _rxBuffer;
 };
\ No newline at end of file
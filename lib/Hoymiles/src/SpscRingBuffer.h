@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Fixed capacity FIFO for exactly one producer and one consumer, which may
+// run in different tasks. Elements are written and read in place, no
+// locking and no heap allocation takes place.
+template <typename T, size_t N>
+class SpscRingBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // producer: returns the slot to fill next or nullptr if the buffer is
+    // full. the element becomes visible to the consumer by commit().
+    T* reserve()
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N) {
+            return nullptr;
+        }
+        return &_items[head & (N - 1)];
+    }
+
+    void commit()
+    {
+        _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // consumer: returns the oldest element or nullptr if the buffer is
+    // empty. the slot is handed back to the producer by pop().
+    T* front()
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &_items[tail & (N - 1)];
+    }
+
+    void pop()
+    {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+private:
+    T _items[N];
+
+    // free running counters, the slot index is the counter modulo N
+    std::atomic<size_t> _head = 0;
+    std::atomic<size_t> _tail = 0;
+};
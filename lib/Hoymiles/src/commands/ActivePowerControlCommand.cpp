@@ -61,7 +61,7 @@ bool ActivePowerControlCommand::handleResponse(InverterAbstract* inverter, fragm
         }
     }
     inverter->SystemConfigPara()->setLastUpdateCommand(millis());
-    inverter->SystemConfigPara()->setLastLimitCommandSuccess(CMD_OK);
+    inverter->SystemConfigPara()->setLastLimitCommandSuccess(CMD_OK, _statusId);
     return true;
 }
 
@@ -76,7 +76,15 @@ PowerLimitControlType ActivePowerControlCommand::getType()
     return (PowerLimitControlType)(((uint16_t)_payload[14] << 8) | _payload[15]);
 }
 
+bool ActivePowerControlCommand::isSupersededBy(CommandAbstract* cmd)
+{
+    // any newer limit for the same inverter
+    return cmd->getTargetAddress() == getTargetAddress()
+        && cmd->getDataPayload()[0] == _payload[0]
+        && cmd->getDataPayload()[10] == _payload[10];
+}
+
 void ActivePowerControlCommand::gotTimeout(InverterAbstract* inverter)
 {
-    inverter->SystemConfigPara()->setLastLimitCommandSuccess(CMD_NOK);
+    inverter->SystemConfigPara()->setLastLimitCommandSuccess(CMD_NOK, _statusId);
 }
\ No newline at end of file
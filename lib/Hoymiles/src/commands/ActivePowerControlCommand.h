@@ -18,6 +18,7 @@ public:
 
     virtual bool handleResponse(InverterAbstract* inverter, fragment_t fragment[], uint8_t max_fragment_id);
     virtual void gotTimeout(InverterAbstract* inverter);
+    virtual bool isSupersededBy(CommandAbstract* cmd);
 
     void setActivePowerLimit(float limit, PowerLimitControlType type = RelativNonPersistent);
     float getLimit();
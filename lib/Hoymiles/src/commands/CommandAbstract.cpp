@@ -111,3 +111,13 @@ uint8_t CommandAbstract::getMaxRetransmitCount()
 {
     return MAX_RETRANSMIT_COUNT;
 }
+
+bool CommandAbstract::isControlCommand()
+{
+    return false;
+}
+
+bool CommandAbstract::isSupersededBy(CommandAbstract* cmd)
+{
+    return false;
+}
@@ -47,6 +47,12 @@ public:
     // Sets the amount how often a missing fragment is re-requested if it was not available
     virtual uint8_t getMaxRetransmitCount();
 
+    // Control commands are sent before data requests which are still queued
+    virtual bool isControlCommand();
+
+    // Returns true if cmd makes this command obsolete while it is still queued
+    virtual bool isSupersededBy(CommandAbstract* cmd);
+
 protected:
     uint8_t _payload[RF_LEN];
     uint8_t _payload_size;
@@ -15,6 +15,21 @@ DevControlCommand::DevControlCommand(uint64_t target_address, uint64_t router_ad
     setTimeout(1000);
 }
 
+bool DevControlCommand::isControlCommand()
+{
+    return true;
+}
+
+void DevControlCommand::setStatusId(uint32_t id)
+{
+    _statusId = id;
+}
+
+uint32_t DevControlCommand::getStatusId()
+{
+    return _statusId;
+}
+
 void DevControlCommand::udpateCRC(uint8_t len)
 {
     uint16_t crc = crc16(&_payload[10], len);
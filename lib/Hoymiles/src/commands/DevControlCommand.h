@@ -9,6 +9,14 @@ public:
 
     virtual bool handleResponse(InverterAbstract* inverter, fragment_t fragment[], uint8_t max_fragment_id);
 
+    virtual bool isControlCommand();
+
+    // id returned by the parser when the command was marked as pending
+    void setStatusId(uint32_t id);
+    uint32_t getStatusId();
+
 protected:
     void udpateCRC(uint8_t len);
+
+    uint32_t _statusId = 0;
 };
\ No newline at end of file
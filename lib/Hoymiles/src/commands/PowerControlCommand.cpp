@@ -32,13 +32,24 @@ bool PowerControlCommand::handleResponse(InverterAbstract* inverter, fragment_t
     }
 
     inverter->PowerCommand()->setLastUpdateCommand(millis());
-    inverter->PowerCommand()->setLastPowerCommandSuccess(CMD_OK);
+    inverter->PowerCommand()->setLastPowerCommandSuccess(CMD_OK, _statusId);
     return true;
 }
 
+bool PowerControlCommand::isSupersededBy(CommandAbstract* cmd)
+{
+    // turn on and turn off replace each other, a restart is always sent
+    auto isOnOff = [](uint8_t control) { return control == 0x00 || control == 0x01; };
+
+    return cmd->getTargetAddress() == getTargetAddress()
+        && cmd->getDataPayload()[0] == _payload[0]
+        && isOnOff(cmd->getDataPayload()[10])
+        && isOnOff(_payload[10]);
+}
+
 void PowerControlCommand::gotTimeout(InverterAbstract* inverter)
 {
-    inverter->PowerCommand()->setLastPowerCommandSuccess(CMD_NOK);
+    inverter->PowerCommand()->setLastPowerCommandSuccess(CMD_NOK, _statusId);
 }
 
 void PowerControlCommand::setPowerOn(bool state)
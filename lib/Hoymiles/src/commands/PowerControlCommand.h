@@ -11,6 +11,7 @@ public:
 
     virtual bool handleResponse(InverterAbstract* inverter, fragment_t fragment[], uint8_t max_fragment_id);
     virtual void gotTimeout(InverterAbstract* inverter);
+    virtual bool isSupersededBy(CommandAbstract* cmd);
 
     void setPowerOn(bool state);
     void setRestart();
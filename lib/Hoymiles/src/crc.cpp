@@ -4,6 +4,100 @@
  */
 #include "crc.h"
 
+#ifndef HOY_CRC_BITWISE
+#include <array>
+
+// lookup tables are generated at compile time and placed in flash (768 bytes)
+template <typename T, typename F>
+static constexpr std::array<T, 256> generateCrcTable(F step)
+{
+    std::array<T, 256> table {};
+    for (uint16_t i = 0; i < 256; i++) {
+        table[i] = step(i);
+    }
+    return table;
+}
+
+static constexpr auto crc8Table = generateCrcTable<uint8_t>([](uint16_t i) {
+    uint8_t crc = i;
+    for (uint8_t b = 0; b < 8; b++) {
+        crc = (crc << 1) ^ ((crc & 0x80) ? CRC8_POLY : 0x00);
+    }
+    return crc;
+});
+
+static constexpr auto crc16Table = generateCrcTable<uint16_t>([](uint16_t i) {
+    uint16_t crc = i;
+    for (uint8_t b = 0; b < 8; b++) {
+        crc = (crc & 0x0001) ? ((crc >> 1) ^ CRC16_MODBUS_POLYNOM) : (crc >> 1);
+    }
+    return crc;
+});
+
+static constexpr auto crc16nrf24Table = generateCrcTable<uint16_t>([](uint16_t i) {
+    uint16_t crc = i << 8;
+    for (uint8_t b = 0; b < 8; b++) {
+        crc = (crc & 0x8000) ? ((crc << 1) ^ CRC16_NRF24_POLYNOM) : (crc << 1);
+    }
+    return crc;
+});
+
+uint8_t crc8(const uint8_t buf[], uint8_t len)
+{
+    uint8_t crc = CRC8_INIT;
+    for (uint8_t i = 0; i < len; i++) {
+        crc = crc8Table[crc ^ buf[i]];
+    }
+    return crc;
+}
+
+uint16_t crc16(const uint8_t buf[], uint8_t len, uint16_t start)
+{
+    uint16_t crc = start;
+    for (uint8_t i = 0; i < len; i++) {
+        crc = (crc >> 8) ^ crc16Table[(crc ^ buf[i]) & 0xff];
+    }
+    return crc;
+}
+
+static uint16_t crc16nrf24Bits(uint16_t crc, uint8_t val, uint8_t fromBit, uint8_t toBit)
+{
+    for (uint8_t idx = fromBit; idx < toBit; idx++) {
+        crc ^= 0x8000 & (val << (8 + idx));
+        crc = (crc & 0x8000) ? ((crc << 1) ^ CRC16_NRF24_POLYNOM) : (crc << 1);
+    }
+    return crc;
+}
+
+uint16_t crc16nrf24(const uint8_t buf[], uint16_t lenBits, uint16_t startBit, uint16_t crcIn)
+{
+    uint16_t crc = crcIn;
+    uint16_t bit = startBit;
+
+    // leading bits up to the next byte boundary
+    if ((bit & 0x07) && bit < lenBits) {
+        uint16_t end = ((bit >> 3) + 1) << 3;
+        if (end > lenBits) {
+            end = lenBits;
+        }
+        crc = crc16nrf24Bits(crc, buf[bit >> 3], bit & 0x07, ((end - 1) & 0x07) + 1);
+        bit = end;
+    }
+
+    for (; bit + 8 <= lenBits; bit += 8) {
+        crc = (crc << 8) ^ crc16nrf24Table[((crc >> 8) ^ buf[bit >> 3]) & 0xff];
+    }
+
+    // trailing bits of an incomplete byte
+    if (bit < lenBits) {
+        crc = crc16nrf24Bits(crc, buf[bit >> 3], 0, lenBits - bit);
+    }
+
+    return crc;
+}
+
+#else
+
 uint8_t crc8(const uint8_t buf[], uint8_t len)
 {
     uint8_t crc = CRC8_INIT;
@@ -47,4 +141,6 @@ uint16_t crc16nrf24(const uint8_t buf[], uint16_t lenBits, uint16_t startBit, ui
     }
 
     return crc;
-}
\ No newline at end of file
+}
+
+#endif
@@ -127,10 +127,6 @@ bool HM_Abstract::sendActivePowerControlRequest(float limit, PowerLimitControlTy
         return false;
     }
 
-    if (CMD_PENDING == SystemConfigPara()->getLastLimitCommandSuccess()) {
-        return false;
-    }
-
     if (type == PowerLimitControlType::RelativNonPersistent || type == PowerLimitControlType::RelativPersistent) {
         limit = min<float>(100, limit);
     }
@@ -141,7 +137,7 @@ bool HM_Abstract::sendActivePowerControlRequest(float limit, PowerLimitControlTy
     auto cmd = _radio->prepareCommand<ActivePowerControlCommand>();
     cmd->setActivePowerLimit(limit, type);
     cmd->setTargetAddress(serial());
-    SystemConfigPara()->setLastLimitCommandSuccess(CMD_PENDING);
+    cmd->setStatusId(SystemConfigPara()->setLastLimitCommandPending());
     _radio->enqueCommand(cmd);
 
     return true;
@@ -158,10 +154,6 @@ bool HM_Abstract::sendPowerControlRequest(bool turnOn)
         return false;
     }
 
-    if (CMD_PENDING == PowerCommand()->getLastPowerCommandSuccess()) {
-        return false;
-    }
-
     if (turnOn) {
         _powerState = 1;
     } else {
@@ -171,7 +163,7 @@ bool HM_Abstract::sendPowerControlRequest(bool turnOn)
     auto cmd = _radio->prepareCommand<PowerControlCommand>();
     cmd->setPowerOn(turnOn);
     cmd->setTargetAddress(serial());
-    PowerCommand()->setLastPowerCommandSuccess(CMD_PENDING);
+    cmd->setStatusId(PowerCommand()->setLastPowerCommandPending());
     _radio->enqueCommand(cmd);
 
     return true;
@@ -188,7 +180,7 @@ bool HM_Abstract::sendRestartControlRequest()
     auto cmd = _radio->prepareCommand<PowerControlCommand>();
     cmd->setRestart();
     cmd->setTargetAddress(serial());
-    PowerCommand()->setLastPowerCommandSuccess(CMD_PENDING);
+    cmd->setStatusId(PowerCommand()->setLastPowerCommandPending());
     _radio->enqueCommand(cmd);
 
     return true;
@@ -24,6 +24,10 @@ InverterAbstract::InverterAbstract(HoymilesRadio* radio, uint64_t serial)
     _powerCommandParser.reset(new PowerCommandParser());
     _statisticsParser.reset(new StatisticsParser());
     _systemConfigParaParser.reset(new SystemConfigParaParser());
+
+    for (auto& nextPoll : _pollSchedule.nextPoll) {
+        nextPoll = millis();
+    }
 }
 
 void InverterAbstract::init()
@@ -167,6 +171,26 @@ SystemConfigParaParser* InverterAbstract::SystemConfigPara()
     return _systemConfigParaParser.get();
 }
 
+void InverterAbstract::setPollPriority(bool highPriority)
+{
+    _pollPriority = highPriority;
+}
+
+bool InverterAbstract::getPollPriority()
+{
+    return _pollPriority;
+}
+
+uint32_t InverterAbstract::getStatsInterval()
+{
+    return _pollSchedule.statsInterval;
+}
+
+pollSchedule_t* InverterAbstract::PollSchedule()
+{
+    return &_pollSchedule;
+}
+
 void InverterAbstract::clearRxFragmentBuffer()
 {
     memset(_rxFragmentBuffer, 0, MAX_RF_FRAGMENT_COUNT * sizeof(fragment_t));
@@ -26,6 +26,20 @@ enum {
 
 #define MAX_RF_FRAGMENT_COUNT 13
 
+typedef enum {
+    POLL_STATS = 0,
+    POLL_ALARM_LOG,
+    POLL_DEV_INFO,
+    POLL_GRID_PROFILE,
+    POLL_TYPE_CNT
+} PollType_t;
+
+typedef struct {
+    uint32_t nextPoll[POLL_TYPE_CNT]; // millis() when the request is due
+    uint32_t lastStatsUpdate; // last statistics update seen by the scheduler
+    uint32_t statsInterval; // smoothed time between statistics updates in ms
+} pollSchedule_t;
+
 class CommandAbstract;
 
 class InverterAbstract {
@@ -58,6 +72,14 @@ public:
     void setZeroYieldDayOnMidnight(bool enabled);
     bool getZeroYieldDayOnMidnight();
 
+    // statistics of high priority inverters are polled at the poll interval,
+    // all other inverters share the remaining radio time.
+    void setPollPriority(bool highPriority);
+    bool getPollPriority();
+
+    // achieved interval between two statistics updates in ms, 0 if unknown
+    uint32_t getStatsInterval();
+
     void clearRxFragmentBuffer();
     void addRxFragment(uint8_t fragment[], uint8_t len);
     uint8_t verifyAllFragments(CommandAbstract* cmd);
@@ -83,6 +105,8 @@ public:
     StatisticsParser* Statistics();
     SystemConfigParaParser* SystemConfigPara();
 
+    pollSchedule_t* PollSchedule();
+
 protected:
     HoymilesRadio* _radio;
 
@@ -103,6 +127,9 @@ private:
     bool _zeroValuesIfUnreachable = false;
     bool _zeroYieldDayOnMidnight = false;
 
+    bool _pollPriority = false;
+    pollSchedule_t _pollSchedule = {};
+
     std::unique_ptr<AlarmLogParser> _alarmLogParser;
     std::unique_ptr<DevInfoParser> _devInfoParser;
     std::unique_ptr<GridProfileParser> _gridProfileParser;
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 #include <Arduino.h>
+#include <atomic>
 #include <cstdint>
 
 #define HOY_SEMAPHORE_TAKE() \
@@ -27,5 +28,7 @@ protected:
     SemaphoreHandle_t _xSemaphore;
 
 private:
-    uint32_t _lastUpdate = 0;
+    // written by the radio task after the parsed data is complete, other
+    // tasks must check it before accessing the data.
+    std::atomic<uint32_t> _lastUpdate = 0;
 };
\ No newline at end of file
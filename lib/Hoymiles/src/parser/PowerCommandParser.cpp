@@ -4,9 +4,22 @@
  */
 #include "PowerCommandParser.h"
 
-void PowerCommandParser::setLastPowerCommandSuccess(LastCommandSuccess status)
+uint32_t PowerCommandParser::setLastPowerCommandPending()
 {
-    _lastLimitCommandSuccess = status;
+    HOY_SEMAPHORE_TAKE();
+    uint32_t commandId = ++_lastPowerCommandId;
+    _lastLimitCommandSuccess = CMD_PENDING;
+    HOY_SEMAPHORE_GIVE();
+    return commandId;
+}
+
+void PowerCommandParser::setLastPowerCommandSuccess(LastCommandSuccess status, uint32_t commandId)
+{
+    HOY_SEMAPHORE_TAKE();
+    if (commandId == _lastPowerCommandId) {
+        _lastLimitCommandSuccess = status;
+    }
+    HOY_SEMAPHORE_GIVE();
 }
 
 LastCommandSuccess PowerCommandParser::getLastPowerCommandSuccess()
@@ -4,13 +4,18 @@
 
 class PowerCommandParser : public Parser {
 public:
-    void setLastPowerCommandSuccess(LastCommandSuccess status);
+    // a newer power command may be queued while an older one is on air.
+    // only the newest command, identified by the returned id, resolves
+    // the pending state.
+    uint32_t setLastPowerCommandPending();
+    void setLastPowerCommandSuccess(LastCommandSuccess status, uint32_t commandId);
     LastCommandSuccess getLastPowerCommandSuccess();
     uint32_t getLastUpdateCommand();
     void setLastUpdateCommand(uint32_t lastUpdate);
 
 private:
     LastCommandSuccess _lastLimitCommandSuccess = CMD_OK; // Set to OK because we have to assume nothing is done at startup
+    uint32_t _lastPowerCommandId = 0;
 
     uint32_t _lastUpdateCommand = 0;
 };
\ No newline at end of file
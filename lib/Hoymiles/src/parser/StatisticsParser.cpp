@@ -5,12 +5,12 @@
 #include "StatisticsParser.h"
 #include "../Hoymiles.h"
 
-static float calcYieldTotalCh0(StatisticsParser* iv, uint8_t arg0);
-static float calcYieldDayCh0(StatisticsParser* iv, uint8_t arg0);
-static float calcUdcCh(StatisticsParser* iv, uint8_t arg0);
-static float calcPowerDcCh0(StatisticsParser* iv, uint8_t arg0);
-static float calcEffiencyCh0(StatisticsParser* iv, uint8_t arg0);
-static float calcIrradiation(StatisticsParser* iv, uint8_t arg0);
+float calcYieldTotalCh0(StatisticsParser* iv, uint8_t arg0);
+float calcYieldDayCh0(StatisticsParser* iv, uint8_t arg0);
+float calcUdcCh(StatisticsParser* iv, uint8_t arg0);
+float calcPowerDcCh0(StatisticsParser* iv, uint8_t arg0);
+float calcEffiencyCh0(StatisticsParser* iv, uint8_t arg0);
+float calcIrradiation(StatisticsParser* iv, uint8_t arg0);
 
 using func_t = float(StatisticsParser*, uint8_t);
 
@@ -57,6 +57,7 @@ const FieldId_t dailyProductionFields[] = {
 StatisticsParser::StatisticsParser()
     : Parser()
 {
+    memset(_assignmentIndex, _noAssignment, sizeof(_assignmentIndex));
     clearBuffer();
 }
 
@@ -65,11 +66,43 @@ void StatisticsParser::setByteAssignment(const byteAssign_t* byteAssignment, uin
     _byteAssignment = byteAssignment;
     _byteAssignmentSize = size;
 
+    memset(_assignmentIndex, _noAssignment, sizeof(_assignmentIndex));
+    _assignmentSettings.assign(_byteAssignmentSize, nullptr);
+    for (auto& values : _fieldValues) {
+        values.assign(_byteAssignmentSize, 0);
+    }
+    for (auto& channels : _channelsByType) {
+        channels.clear();
+    }
+
     for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
-        if (_byteAssignment[i].div == CMD_CALC) {
+        const byteAssign_t& assignment = _byteAssignment[i];
+
+        // keep the first assignment of a field, like the former linear search did
+        if (getAssignmentIndex(assignment.type, assignment.ch, assignment.fieldId) == _noAssignment
+            && assignment.type < _channelTypeCount && assignment.ch < CH_CNT && assignment.fieldId < _fieldCount) {
+            _assignmentIndex[assignment.type][assignment.ch][assignment.fieldId] = i;
+        }
+
+        if (assignment.type < _channelTypeCount) {
+            _channelsByType[assignment.type].push_back(assignment.ch);
+        }
+
+        if (assignment.div == CMD_CALC) {
             continue;
         }
-        _expectedByteCount = max<uint8_t>(_expectedByteCount, _byteAssignment[i].start + _byteAssignment[i].num);
+        _expectedByteCount = max<uint8_t>(_expectedByteCount, assignment.start + assignment.num);
+    }
+
+    for (auto& channels : _channelsByType) {
+        channels.unique();
+    }
+
+    for (auto& setting : _fieldSettings) {
+        uint8_t idx = getAssignmentIndex(setting.type, setting.ch, setting.fieldId);
+        if (idx != _noAssignment) {
+            _assignmentSettings[idx] = &setting;
+        }
     }
 }
 
@@ -94,18 +127,31 @@ void StatisticsParser::appendFragment(uint8_t offset, uint8_t* payload, uint8_t
     _statisticLength += len;
 }
 
+uint8_t StatisticsParser::getAssignmentIndex(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId)
+{
+    if (type >= _channelTypeCount || channel >= CH_CNT || fieldId >= _fieldCount) {
+        return _noAssignment;
+    }
+    return _assignmentIndex[type][channel][fieldId];
+}
+
 const byteAssign_t* StatisticsParser::getAssignmentByChannelField(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId)
 {
-    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
-        if (_byteAssignment[i].type == type && _byteAssignment[i].ch == channel && _byteAssignment[i].fieldId == fieldId) {
-            return &_byteAssignment[i];
-        }
+    uint8_t idx = getAssignmentIndex(type, channel, fieldId);
+    if (idx == _noAssignment) {
+        return NULL;
     }
-    return NULL;
+    return &_byteAssignment[idx];
 }
 
 fieldSettings_t* StatisticsParser::getSettingByChannelField(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId)
 {
+    uint8_t idx = getAssignmentIndex(type, channel, fieldId);
+    if (idx != _noAssignment) {
+        return _assignmentSettings[idx];
+    }
+
+    // settings of fields without byte assignment are not indexed
     for (auto& i : _fieldSettings) {
         if (i.type == type && i.ch == channel && i.fieldId == fieldId) {
             return &i;
@@ -116,58 +162,103 @@ fieldSettings_t* StatisticsParser::getSettingByChannelField(ChannelType_t type,
 
 float StatisticsParser::getChannelFieldValue(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId)
 {
-    const byteAssign_t* pos = getAssignmentByChannelField(type, channel, fieldId);
-    fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
+    uint8_t idx = getAssignmentIndex(type, channel, fieldId);
+    if (idx == _noAssignment) {
+        return 0;
+    }
 
-    if (pos == NULL) {
+    // decoded once per update in updateFieldValues(), no need to take the
+    // semaphore. retry if a new version was published while reading.
+    float value;
+    uint32_t version;
+    do {
+        version = _fieldValuesVersion.load(std::memory_order_acquire);
+        value = _fieldValues[version & 1][idx];
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (version != _fieldValuesVersion.load(std::memory_order_relaxed));
+
+    return value;
+}
+
+float StatisticsParser::getUpdatingFieldValue(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId)
+{
+    uint8_t idx = getAssignmentIndex(type, channel, fieldId);
+    if (idx == _noAssignment) {
         return 0;
     }
 
+    // only called by updateFieldValues() which is the only writer
+    return _fieldValues[(_fieldValuesVersion.load(std::memory_order_relaxed) + 1) & 1][idx];
+}
+
+float StatisticsParser::decodeFieldValue(uint8_t idx)
+{
+    const byteAssign_t* pos = &_byteAssignment[idx];
+    fieldSettings_t* setting = _assignmentSettings[idx];
+
     uint8_t ptr = pos->start;
     uint8_t end = ptr + pos->num;
     uint16_t div = pos->div;
 
-    if (CMD_CALC != div) {
-        // Value is a static value
-        uint32_t val = 0;
-        HOY_SEMAPHORE_TAKE();
-        do {
-            val <<= 8;
-            val |= _payloadStatistic[ptr];
-        } while (++ptr != end);
-        HOY_SEMAPHORE_GIVE();
-
-        float result;
-        if (pos->isSigned && pos->num == 2) {
-            result = static_cast<float>(static_cast<int16_t>(val));
-        } else if (pos->isSigned && pos->num == 4) {
-            result = static_cast<float>(static_cast<int32_t>(val));
-        } else {
-            result = static_cast<float>(val);
+    uint32_t val = 0;
+    do {
+        val <<= 8;
+        val |= _payloadStatistic[ptr];
+    } while (++ptr != end);
+
+    float result;
+    if (pos->isSigned && pos->num == 2) {
+        result = static_cast<float>(static_cast<int16_t>(val));
+    } else if (pos->isSigned && pos->num == 4) {
+        result = static_cast<float>(static_cast<int32_t>(val));
+    } else {
+        result = static_cast<float>(val);
+    }
+
+    result /= static_cast<float>(div);
+    if (setting != NULL && _statisticLength > 0) {
+        result += setting->offset;
+    }
+    return result;
+}
+
+void StatisticsParser::updateFieldValues()
+{
+    HOY_SEMAPHORE_TAKE();
+
+    uint32_t version = _fieldValuesVersion.load(std::memory_order_relaxed) + 1;
+    std::vector<float>& values = _fieldValues[version & 1];
+
+    // readers of the previous version have to notice the writes below
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // static values first, the calculated values are derived from them
+    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
+        if (_byteAssignment[i].div != CMD_CALC) {
+            values[i] = decodeFieldValue(i);
         }
+    }
 
-        result /= static_cast<float>(div);
-        if (setting != NULL && _statisticLength > 0) {
-            result += setting->offset;
+    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
+        if (_byteAssignment[i].div == CMD_CALC) {
+            values[i] = calcFunctions[_byteAssignment[i].start].func(this, _byteAssignment[i].num);
         }
-        return result;
-    } else {
-        // Value has to be calculated
-        return calcFunctions[pos->start].func(this, pos->num);
     }
 
-    return 0;
+    _fieldValuesVersion.store(version, std::memory_order_release);
+
+    HOY_SEMAPHORE_GIVE();
 }
 
 bool StatisticsParser::setChannelFieldValue(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, float value)
 {
     const byteAssign_t* pos = getAssignmentByChannelField(type, channel, fieldId);
-    fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
-
     if (pos == NULL) {
         return false;
     }
 
+    fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
+
     uint8_t ptr = pos->start + pos->num - 1;
     uint8_t end = pos->start;
     uint16_t div = pos->div;
@@ -245,9 +336,18 @@ void StatisticsParser::setChannelFieldOffset(ChannelType_t type, ChannelNum_t ch
     fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
     if (setting != NULL) {
         setting->offset = offset;
-    } else {
-        _fieldSettings.push_back({ type, channel, fieldId, offset });
+        updateFieldValues();
+        return;
     }
+
+    _fieldSettings.push_back({ type, channel, fieldId, offset });
+
+    uint8_t idx = getAssignmentIndex(type, channel, fieldId);
+    if (idx != _noAssignment) {
+        _assignmentSettings[idx] = &_fieldSettings.back();
+    }
+
+    updateFieldValues();
 }
 
 std::list<ChannelType_t> StatisticsParser::getChannelTypes()
@@ -264,16 +364,13 @@ const char* StatisticsParser::getChannelTypeName(ChannelType_t type)
     return channelsTypes[type];
 }
 
-std::list<ChannelNum_t> StatisticsParser::getChannelsByType(ChannelType_t type)
+const std::list<ChannelNum_t>& StatisticsParser::getChannelsByType(ChannelType_t type)
 {
-    std::list<ChannelNum_t> l;
-    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
-        if (_byteAssignment[i].type == type) {
-            l.push_back(_byteAssignment[i].ch);
-        }
+    static const std::list<ChannelNum_t> none;
+    if (type >= _channelTypeCount) {
+        return none;
     }
-    l.unique();
-    return l;
+    return _channelsByType[type];
 }
 
 uint16_t StatisticsParser::getStringMaxPower(uint8_t channel)
@@ -285,6 +382,7 @@ void StatisticsParser::setStringMaxPower(uint8_t channel, uint16_t power)
 {
     if (channel < sizeof(_stringMaxPower) / sizeof(_stringMaxPower[0])) {
         _stringMaxPower[channel] = power;
+        updateFieldValues(); // irradiation depends on it
     }
 }
 
@@ -315,8 +413,8 @@ void StatisticsParser::zeroDailyData()
 
 void StatisticsParser::setLastUpdate(uint32_t lastUpdate)
 {
-    Parser::setLastUpdate(lastUpdate);
     setLastUpdateFromInternal(lastUpdate);
+    Parser::setLastUpdate(lastUpdate);
 }
 
 uint32_t StatisticsParser::getLastUpdateFromInternal()
@@ -326,6 +424,7 @@ uint32_t StatisticsParser::getLastUpdateFromInternal()
 
 void StatisticsParser::setLastUpdateFromInternal(uint32_t lastUpdate)
 {
+    updateFieldValues();
     _lastUpdateFromInternal = lastUpdate;
 }
 
@@ -344,50 +443,50 @@ void StatisticsParser::zeroFields(const FieldId_t* fields)
     setLastUpdateFromInternal(millis());
 }
 
-static float calcYieldTotalCh0(StatisticsParser* iv, uint8_t arg0)
+float calcYieldTotalCh0(StatisticsParser* iv, uint8_t arg0)
 {
     float yield = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_DC)) {
-        yield += iv->getChannelFieldValue(TYPE_DC, channel, FLD_YT);
+        yield += iv->getUpdatingFieldValue(TYPE_DC, channel, FLD_YT);
     }
     return yield;
 }
 
-static float calcYieldDayCh0(StatisticsParser* iv, uint8_t arg0)
+float calcYieldDayCh0(StatisticsParser* iv, uint8_t arg0)
 {
     float yield = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_DC)) {
-        yield += iv->getChannelFieldValue(TYPE_DC, channel, FLD_YD);
+        yield += iv->getUpdatingFieldValue(TYPE_DC, channel, FLD_YD);
     }
     return yield;
 }
 
 // arg0 = channel of source
-static float calcUdcCh(StatisticsParser* iv, uint8_t arg0)
+float calcUdcCh(StatisticsParser* iv, uint8_t arg0)
 {
-    return iv->getChannelFieldValue(TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_UDC);
+    return iv->getUpdatingFieldValue(TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_UDC);
 }
 
-static float calcPowerDcCh0(StatisticsParser* iv, uint8_t arg0)
+float calcPowerDcCh0(StatisticsParser* iv, uint8_t arg0)
 {
     float dcPower = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_DC)) {
-        dcPower += iv->getChannelFieldValue(TYPE_DC, channel, FLD_PDC);
+        dcPower += iv->getUpdatingFieldValue(TYPE_DC, channel, FLD_PDC);
     }
     return dcPower;
 }
 
 // arg0 = channel
-static float calcEffiencyCh0(StatisticsParser* iv, uint8_t arg0)
+float calcEffiencyCh0(StatisticsParser* iv, uint8_t arg0)
 {
     float acPower = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_AC)) {
-        acPower += iv->getChannelFieldValue(TYPE_AC, channel, FLD_PAC);
+        acPower += iv->getUpdatingFieldValue(TYPE_AC, channel, FLD_PAC);
     }
 
     float dcPower = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_DC)) {
-        dcPower += iv->getChannelFieldValue(TYPE_DC, channel, FLD_PDC);
+        dcPower += iv->getUpdatingFieldValue(TYPE_DC, channel, FLD_PDC);
     }
 
     if (dcPower > 0) {
@@ -397,11 +496,11 @@ static float calcEffiencyCh0(StatisticsParser* iv, uint8_t arg0)
 }
 
 // arg0 = channel
-static float calcIrradiation(StatisticsParser* iv, uint8_t arg0)
+float calcIrradiation(StatisticsParser* iv, uint8_t arg0)
 {
     if (NULL != iv) {
         if (iv->getStringMaxPower(arg0) > 0)
-            return iv->getChannelFieldValue(TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_PDC) / iv->getStringMaxPower(arg0) * 100.0f;
+            return iv->getUpdatingFieldValue(TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_PDC) / iv->getStringMaxPower(arg0) * 100.0f;
     }
     return 0.0;
 }
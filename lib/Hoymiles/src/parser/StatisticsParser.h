@@ -3,6 +3,7 @@
 #include "Parser.h"
 #include <cstdint>
 #include <list>
+#include <vector>
 
 #define STATISTIC_PACKET_SIZE (7 * 16)
 
@@ -129,7 +130,7 @@ public:
 
     std::list<ChannelType_t> getChannelTypes();
     const char* getChannelTypeName(ChannelType_t type);
-    std::list<ChannelNum_t> getChannelsByType(ChannelType_t type);
+    const std::list<ChannelNum_t>& getChannelsByType(ChannelType_t type);
 
     uint16_t getStringMaxPower(uint8_t channel);
     void setStringMaxPower(uint8_t channel, uint16_t power);
@@ -151,15 +152,47 @@ public:
 private:
     void zeroFields(const FieldId_t* fields);
 
+    static constexpr uint8_t _channelTypeCount = sizeof(channelsTypes) / sizeof(channelsTypes[0]);
+    static constexpr uint8_t _fieldCount = sizeof(fields) / sizeof(fields[0]);
+    static constexpr uint8_t _noAssignment = 0xff;
+
+    uint8_t getAssignmentIndex(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId);
+    float decodeFieldValue(uint8_t idx);
+    void updateFieldValues();
+
+    // the calculated fields are derived from the values which are currently
+    // being updated, not from the published ones
+    float getUpdatingFieldValue(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId);
+    friend float calcYieldTotalCh0(StatisticsParser* iv, uint8_t arg0);
+    friend float calcYieldDayCh0(StatisticsParser* iv, uint8_t arg0);
+    friend float calcUdcCh(StatisticsParser* iv, uint8_t arg0);
+    friend float calcPowerDcCh0(StatisticsParser* iv, uint8_t arg0);
+    friend float calcEffiencyCh0(StatisticsParser* iv, uint8_t arg0);
+    friend float calcIrradiation(StatisticsParser* iv, uint8_t arg0);
+
     uint8_t _payloadStatistic[STATISTIC_PACKET_SIZE] = {};
     uint8_t _statisticLength = 0;
     uint16_t _stringMaxPower[CH_CNT];
 
-    const byteAssign_t* _byteAssignment;
-    uint8_t _byteAssignmentSize;
+    const byteAssign_t* _byteAssignment = nullptr;
+    uint8_t _byteAssignmentSize = 0;
     uint8_t _expectedByteCount = 0;
     std::list<fieldSettings_t> _fieldSettings;
 
+    // lookup tables built once in setByteAssignment(): the index into
+    // _byteAssignment for every (type, channel, field), the settings of every
+    // byte assignment (nullptr if none) and the channels of every type.
+    uint8_t _assignmentIndex[_channelTypeCount][CH_CNT][_fieldCount];
+    std::vector<fieldSettings_t*> _assignmentSettings;
+    std::list<ChannelNum_t> _channelsByType[_channelTypeCount];
+
+    // all values of the byte assignment, decoded whenever the raw data or
+    // the settings change. updateFieldValues() fills the buffer which is not
+    // published and then bumps the version, readers retry if the version
+    // changed while they were reading (same scheme as the Datastore).
+    std::vector<float> _fieldValues[2];
+    std::atomic<uint32_t> _fieldValuesVersion = 0;
+
     uint32_t _rxFailureCount = 0;
-    uint32_t _lastUpdateFromInternal = 0;
+    std::atomic<uint32_t> _lastUpdateFromInternal = 0;
 };
\ No newline at end of file
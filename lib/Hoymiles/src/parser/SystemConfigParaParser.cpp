@@ -44,9 +44,22 @@ void SystemConfigParaParser::setLimitPercent(float value)
     HOY_SEMAPHORE_GIVE();
 }
 
-void SystemConfigParaParser::setLastLimitCommandSuccess(LastCommandSuccess status)
+uint32_t SystemConfigParaParser::setLastLimitCommandPending()
 {
-    _lastLimitCommandSuccess = status;
+    HOY_SEMAPHORE_TAKE();
+    uint32_t commandId = ++_lastLimitCommandId;
+    _lastLimitCommandSuccess = CMD_PENDING;
+    HOY_SEMAPHORE_GIVE();
+    return commandId;
+}
+
+void SystemConfigParaParser::setLastLimitCommandSuccess(LastCommandSuccess status, uint32_t commandId)
+{
+    HOY_SEMAPHORE_TAKE();
+    if (commandId == _lastLimitCommandId) {
+        _lastLimitCommandSuccess = status;
+    }
+    HOY_SEMAPHORE_GIVE();
 }
 
 LastCommandSuccess SystemConfigParaParser::getLastLimitCommandSuccess()
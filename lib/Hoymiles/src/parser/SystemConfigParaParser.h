@@ -13,7 +13,11 @@ public:
     float getLimitPercent();
     void setLimitPercent(float value);
 
-    void setLastLimitCommandSuccess(LastCommandSuccess status);
+    // a newer limit command may be queued while an older one is on air.
+    // only the newest command, identified by the returned id, resolves
+    // the pending state.
+    uint32_t setLastLimitCommandPending();
+    void setLastLimitCommandSuccess(LastCommandSuccess status, uint32_t commandId);
     LastCommandSuccess getLastLimitCommandSuccess();
     uint32_t getLastUpdateCommand();
     void setLastUpdateCommand(uint32_t lastUpdate);
@@ -31,6 +35,7 @@ private:
     uint8_t _payloadLength;
 
     LastCommandSuccess _lastLimitCommandSuccess = CMD_OK; // Set to OK because we have to assume nothing is done at startup
+    uint32_t _lastLimitCommandId = 0;
     LastCommandSuccess _lastLimitRequestSuccess = CMD_NOK; // Set to NOK to fetch at startup
 
     uint32_t _lastUpdateCommand = 0;
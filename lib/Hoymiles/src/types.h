@@ -18,4 +18,5 @@ typedef struct {
     uint8_t channel;
     int8_t rssi;
     bool wasReceived;
+    uint32_t timestamp; // millis() when read from the radio module
 } fragment_t;
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// messages of a module are compiled in up to the module's build time log
+// level, which defaults to LOG_LEVEL. e.g. -DLOG_LEVEL=LOG_LEVEL_INFO removes
+// all verbose messages from the firmware, -DHOY_LOG_LEVEL=LOG_LEVEL_INFO only
+// those of the Hoymiles library.
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_VERBOSE 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_VERBOSE
+#endif
+
+// true if messages of the given level are compiled in and enabled at runtime
+#define LOG_ENABLED(level, buildLevel, enabled) ((level) <= (buildLevel) && (enabled))
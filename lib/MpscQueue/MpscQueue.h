@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <utility>
+
+// Bounded queue for any number of producers and a single consumer.
+//
+// Producers claim a slot with a compare-and-swap on the enqueue position,
+// every slot carries a sequence number telling whether it is free or
+// filled (D. Vyukov's bounded queue). Nothing is allocated after
+// construction. try_push() fails instead of blocking if the queue is full,
+// the consumer may wait for new items with pop().
+template <typename T, size_t N>
+class MpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    MpscQueue()
+    {
+        for (size_t i = 0; i < N; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        _itemAvailable = xSemaphoreCreateBinaryStatic(&_itemAvailableBuffer);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // any task. returns false if the queue is full.
+    bool try_push(T item)
+    {
+        Cell* cell;
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &_cells[pos & (N - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        updateHighWaterMark(pos + 1 - _dequeuePos.load(std::memory_order_relaxed));
+        xSemaphoreGive(_itemAvailable);
+        return true;
+    }
+
+    // consumer only. returns false if the queue is empty.
+    bool try_pop(T& item)
+    {
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &_cells[pos & (N - 1)];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+
+        item = std::move(cell->data);
+        cell->data = T(); // do not keep a reference to a popped item
+
+        // advanced before the slot is released, a producer claiming the
+        // slot must not count the popped item in the high-water mark
+        _dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        cell->sequence.store(pos + N, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only. waits up to ticksToWait for an item.
+    bool pop(T& item, TickType_t ticksToWait)
+    {
+        while (!try_pop(item)) {
+            if (xSemaphoreTake(_itemAvailable, ticksToWait) != pdTRUE) {
+                return try_pop(item);
+            }
+        }
+        return true;
+    }
+
+    // number of items, might be outdated as soon as it is returned
+    size_t size() const
+    {
+        size_t enqueuePos = _enqueuePos.load(std::memory_order_relaxed);
+        size_t dequeuePos = _dequeuePos.load(std::memory_order_relaxed);
+        return (enqueuePos > dequeuePos) ? enqueuePos - dequeuePos : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+    // maximum number of items ever queued at the same time
+    size_t getHighWaterMark() const
+    {
+        return _highWaterMark.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    void updateHighWaterMark(size_t size)
+    {
+        size_t highWaterMark = _highWaterMark.load(std::memory_order_relaxed);
+        while (size > highWaterMark
+            && !_highWaterMark.compare_exchange_weak(highWaterMark, size, std::memory_order_relaxed)) { }
+    }
+
+    Cell _cells[N];
+    std::atomic<size_t> _enqueuePos = 0;
+    std::atomic<size_t> _dequeuePos = 0;
+    std::atomic<size_t> _highWaterMark = 0;
+
+    StaticSemaphore_t _itemAvailableBuffer;
+    SemaphoreHandle_t _itemAvailable;
+};
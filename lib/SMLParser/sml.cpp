@@ -40,22 +40,7 @@ char logBuff[200];
   } while (0)
 #endif
 
-#define MAX_LIST_SIZE 80
-#define MAX_TREE_SIZE 10
-
-static sml_states_t currentState = SML_START;
-static char nodes[MAX_TREE_SIZE];
-static unsigned char currentLevel = 0;
-static unsigned short crc = 0xFFFF;
-static signed char sc;
-static unsigned short crcMine = 0xFFFF;
-static unsigned short crcReceived = 0x0000;
-static unsigned char len = 4;
-static unsigned char listBuffer[MAX_LIST_SIZE]; /* keeps a list
-                                                   as length + state + data  */
-static unsigned char listPos = 0;
-
-void crc16(unsigned char &byte)
+void SmlParser::crc16(unsigned char &byte)
 {
 #ifdef ARDUINO
   crc =
@@ -65,29 +50,29 @@ void crc16(unsigned char &byte)
 #endif
 }
 
-void setState(sml_states_t state, int byteLen)
+void SmlParser::setState(sml_states_t state, int byteLen)
 {
   currentState = state;
   len = byteLen;
 }
 
-void pushListBuffer(unsigned char byte)
+void SmlParser::pushListBuffer(unsigned char byte)
 {
-  if (listPos < MAX_LIST_SIZE) {
+  if (listPos < SML_MAX_LIST_SIZE) {
     listBuffer[listPos++] = byte;
   }
 }
 
-void reduceList()
+void SmlParser::reduceList()
 {
-  if (currentLevel <= MAX_TREE_SIZE && nodes[currentLevel] > 0)
+  if (currentLevel <= SML_MAX_TREE_SIZE && nodes[currentLevel] > 0)
     nodes[currentLevel]--;
 }
 
-void smlNewList(unsigned char size)
+void SmlParser::newList(unsigned char size)
 {
   reduceList();
-  if (currentLevel < MAX_TREE_SIZE)
+  if (currentLevel < SML_MAX_TREE_SIZE)
     currentLevel++;
   nodes[currentLevel] = size;
   SML_TREELOG(currentLevel, "LISTSTART on level %i with %i nodes\n",
@@ -96,7 +81,7 @@ void smlNewList(unsigned char size)
   // @todo workaround for lists inside obis lists
   if (size > 5) {
     listPos = 0;
-    memset(listBuffer, '\0', MAX_LIST_SIZE);
+    memset(listBuffer, '\0', SML_MAX_LIST_SIZE);
   }
   else {
     pushListBuffer(size);
@@ -104,7 +89,7 @@ void smlNewList(unsigned char size)
   }
 }
 
-void checkMagicByte(unsigned char &byte)
+void SmlParser::checkMagicByte(unsigned char &byte)
 {
   unsigned int size = 0;
   while (currentLevel > 0 && nodes[currentLevel] == 0) {
@@ -115,7 +100,7 @@ void checkMagicByte(unsigned char &byte)
   if (byte > 0x70 && byte <= 0x7F) {
     /* new list */
     size = byte & 0x0F;
-    smlNewList(size);
+    newList(size);
   }
   else if (byte >= 0x01 && byte <= 0x6F && nodes[currentLevel] > 0) {
     if (byte == 0x01) {
@@ -189,7 +174,7 @@ void checkMagicByte(unsigned char &byte)
   }
 }
 
-sml_states_t smlState(unsigned char &currentByte)
+sml_states_t SmlParser::state(unsigned char &currentByte)
 {
   unsigned char size;
   if (len > 0)
@@ -265,7 +250,7 @@ sml_states_t smlState(unsigned char &currentByte)
   case SML_LISTEXTENDED:
     size = len + (currentByte & 0x0F);
     SML_TREELOG(currentLevel, "Extended List with Size=%i\n", size);
-    smlNewList(size);
+    newList(size);
     break;
   case SML_DATA:
   case SML_DATA_SIGNED_INT:
@@ -295,12 +280,21 @@ sml_states_t smlState(unsigned char &currentByte)
   return currentState;
 }
 
-bool smlOBISCheck(const unsigned char *obis)
+bool SmlParser::obisCheck(const unsigned char *obis) const
 {
   return (memcmp(obis, &listBuffer[2], 6) == 0);
 }
 
-void smlOBISManufacturer(unsigned char *str, int maxSize)
+unsigned long long SmlParser::obisCode() const
+{
+  unsigned long long code = 0;
+  for (int i = 2; i < 8; i++) {
+    code = (code << 8) | listBuffer[i];
+  }
+  return code;
+}
+
+void SmlParser::obisManufacturer(unsigned char *str, int maxSize) const
 {
   int i = 0, pos = 0, size = 0;
   while (i < listPos) {
@@ -317,7 +311,7 @@ void smlOBISManufacturer(unsigned char *str, int maxSize)
   }
 }
 
-void smlPow(double &val, signed char &scaler)
+static void smlPow(double &val, signed char &scaler)
 {
   if (scaler < 0) {
     while (scaler++) {
@@ -331,11 +325,13 @@ void smlPow(double &val, signed char &scaler)
   }
 }
 
-void smlOBISByUnit(long long int &val, signed char &scaler, sml_units_t unit)
+void SmlParser::obisByUnit(long long int &val, signed char &scaler,
+                           sml_units_t unit) const
 {
   unsigned char i = 0, pos = 0, size = 0, y = 0, skip = 0;
   sml_states_t type;
   val = -1; /* unknown or error */
+  scaler = 0;
   while (i < listPos) {
     pos++;
     size = (int)listBuffer[i++];
@@ -372,34 +368,38 @@ void smlOBISByUnit(long long int &val, signed char &scaler, sml_units_t unit)
   }
 }
 
-void smlOBISWh(double &wh)
+void SmlParser::obisWh(double &wh) const
 {
   long long int val;
-  smlOBISByUnit(val, sc, SML_WATT_HOUR);
+  signed char sc;
+  obisByUnit(val, sc, SML_WATT_HOUR);
   wh = val;
   smlPow(wh, sc);
 }
 
-void smlOBISW(double &w)
+void SmlParser::obisW(double &w) const
 {
   long long int val;
-  smlOBISByUnit(val, sc, SML_WATT);
+  signed char sc;
+  obisByUnit(val, sc, SML_WATT);
   w = val;
   smlPow(w, sc);
 }
 
-void smlOBISVolt(double &v)
+void SmlParser::obisVolt(double &v) const
 {
   long long int val;
-  smlOBISByUnit(val, sc, SML_VOLT);
+  signed char sc;
+  obisByUnit(val, sc, SML_VOLT);
   v = val;
   smlPow(v, sc);
 }
 
-void smlOBISAmpere(double &a)
+void SmlParser::obisAmpere(double &a) const
 {
   long long int val;
-  smlOBISByUnit(val, sc, SML_AMPERE);
+  signed char sc;
+  obisByUnit(val, sc, SML_AMPERE);
   a = val;
   smlPow(a, sc);
 }
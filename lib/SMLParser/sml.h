@@ -92,15 +92,47 @@ typedef enum {
   SML_COUNT = 255
 } sml_units_t;
 
-sml_states_t smlState(unsigned char &byte);
-bool smlOBISCheck(const unsigned char *obis);
-void smlOBISManufacturer(unsigned char *str, int maxSize);
-void smlOBISByUnit(long long int &wh, signed char &scaler, sml_units_t unit);
+#define SML_MAX_LIST_SIZE 80
+#define SML_MAX_TREE_SIZE 10
 
-// Be aware that double on Arduino UNO is just 32 bit
-void smlOBISWh(double &wh);
-void smlOBISW(double &w);
-void smlOBISVolt(double &v);
-void smlOBISAmpere(double &a);
+/* keeps all parser state, so that multiple SML streams can be parsed at the
+ * same time by using one instance per stream. */
+class SmlParser {
+public:
+  sml_states_t state(unsigned char &byte);
+
+  /* the following operate on the list completed by the last SML_LISTEND */
+  bool obisCheck(const unsigned char *obis) const;
+  /* OBIS code packed into the lower 48 bits (A is the most significant) */
+  unsigned long long obisCode() const;
+  void obisManufacturer(unsigned char *str, int maxSize) const;
+  void obisByUnit(long long int &wh, signed char &scaler,
+                  sml_units_t unit) const;
+
+  // Be aware that double on Arduino UNO is just 32 bit
+  void obisWh(double &wh) const;
+  void obisW(double &w) const;
+  void obisVolt(double &v) const;
+  void obisAmpere(double &a) const;
+
+private:
+  void crc16(unsigned char &byte);
+  void setState(sml_states_t state, int byteLen);
+  void pushListBuffer(unsigned char byte);
+  void reduceList();
+  void newList(unsigned char size);
+  void checkMagicByte(unsigned char &byte);
+
+  sml_states_t currentState = SML_START;
+  char nodes[SML_MAX_TREE_SIZE] = {};
+  unsigned char currentLevel = 0;
+  unsigned short crc = 0xFFFF;
+  unsigned short crcMine = 0xFFFF;
+  unsigned short crcReceived = 0x0000;
+  unsigned char len = 4;
+  unsigned char listBuffer[SML_MAX_LIST_SIZE] = {}; /* keeps a list as
+                                                       length + state + data */
+  unsigned char listPos = 0;
+};
 
 #endif
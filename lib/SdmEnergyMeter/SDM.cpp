@@ -151,18 +151,100 @@ float SDM::readVal(uint16_t reg, uint8_t node) {
   if (sdmSer.available())                                                       //if serial rx buffer (after RESPONSE_TIMEOUT) still contains data then something spam rs485, check node(s) or increase RESPONSE_TIMEOUT
     readErr = SDM_ERR_TIMEOUT;                                                  //err debug (4) but returned value may be correct
 
-  if (readErr != SDM_ERR_NO_ERROR) {                                            //if error then copy temp error value to global val and increment global error counter
-    readingerrcode = readErr;
-    readingerrcount++; 
+  countReading(readErr);
+
+#if !defined ( USE_HARDWARESERIAL )
+  sdmSer.stopListening();                                                       //disable softserial rx interrupt
+#endif
+
+  return (res);
+}
+
+bool SDM::startBlockRead(uint16_t reg, uint8_t count, uint8_t node) {
+  uint16_t temp;
+  uint8_t sdmarr[FRAMESIZE - 1] = {node, SDM_B_02, 0, 0, 0, 0, 0, 0};
+
+  if (count == 0 || count > SDM_MAX_BLOCK_VALUES)
+    return false;
+
+  sdmarr[2] = highByte(reg);
+  sdmarr[3] = lowByte(reg);
+  sdmarr[5] = count * 2;                                                        //every value occupies two 16 bit registers
+
+  temp = calculateCRC(sdmarr, FRAMESIZE - 3);                                   //calculate out crc only from first 6 bytes
+
+  sdmarr[6] = lowByte(temp);
+  sdmarr[7] = highByte(temp);
+
+#if !defined ( USE_HARDWARESERIAL )
+  sdmSer.listen();                                                              //enable softserial rx interrupt
+#endif
+
+  flush();                                                                      //drop old data, but do not wait for RESPONSE_TIMEOUT
+
+  dereSet(HIGH);                                                                //transmit to SDM  -> DE Enable, /RE Disable (for control MAX485)
+
+  delay(2);                                                                     //fix for issue (nan reading) by sjfaustino: https://github.com/reaper7/SDM_Energy_Meter/issues/7#issuecomment-272111524
+
+  sdmSer.write(sdmarr, FRAMESIZE - 1);                                          //send 8 bytes
+
+  sdmSer.flush();                                                               //clear out tx buffer (~8 ms at 9600 baud)
+
+  dereSet(LOW);                                                                 //receive from SDM -> DE Disable, /RE Enable (for control MAX485)
+
+  blocknode = node;
+  blockcount = count;
+  blockstart = millis();
+
+  return true;
+}
+
+uint8_t SDM::pollBlockRead(float* values) {
+  uint8_t sdmarr[SDM_BLOCK_FRAMESIZE];
+  uint16_t readErr = SDM_ERR_NO_ERROR;
+
+  if (blockcount == 0)                                                          //no block read requested
+    return SDM_BLOCK_ERROR;
+
+  const uint8_t framesize = 5 + 4 * blockcount;
+
+  if (sdmSer.available() < framesize) {
+    if (millis() - blockstart <= msturnaround)
+      return SDM_BLOCK_PENDING;
+
+    readErr = sdmSer.available() ? SDM_ERR_NOT_ENOUGHT_BYTES : SDM_ERR_TIMEOUT; //err debug (3) or (4)
   } else {
-    ++readingsuccesscount;
+    for (uint8_t n = 0; n < framesize; n++) {
+      sdmarr[n] = sdmSer.read();
+    }
+
+    if (sdmarr[0] == blocknode && sdmarr[1] == SDM_B_02 && sdmarr[2] == blockcount * 4) {
+
+      if ((calculateCRC(sdmarr, framesize - 2)) == ((sdmarr[framesize - 1] << 8) | sdmarr[framesize - 2])) {
+        for (uint8_t i = 0; i < blockcount; i++) {
+          ((uint8_t*)&values[i])[3]= sdmarr[3 + 4 * i];
+          ((uint8_t*)&values[i])[2]= sdmarr[4 + 4 * i];
+          ((uint8_t*)&values[i])[1]= sdmarr[5 + 4 * i];
+          ((uint8_t*)&values[i])[0]= sdmarr[6 + 4 * i];
+        }
+      } else {
+        readErr = SDM_ERR_CRC_ERROR;                                            //err debug (1)
+      }
+
+    } else {
+      readErr = SDM_ERR_WRONG_BYTES;                                            //err debug (2)
+    }
   }
 
+  blockcount = 0;
+
+  countReading(readErr);
+
 #if !defined ( USE_HARDWARESERIAL )
   sdmSer.stopListening();                                                       //disable softserial rx interrupt
 #endif
 
-  return (res);
+  return (readErr == SDM_ERR_NO_ERROR) ? SDM_BLOCK_DONE : SDM_BLOCK_ERROR;
 }
 
 uint16_t SDM::getErrCode(bool _clear) {
@@ -239,6 +321,15 @@ uint16_t SDM::calculateCRC(uint8_t *array, uint8_t len) {
   return _crc;
 }
 
+void SDM::countReading(uint16_t readErr) {
+  if (readErr != SDM_ERR_NO_ERROR) {                                            //if error then copy temp error value to global val and increment global error counter
+    readingerrcode = readErr;
+    readingerrcount++; 
+  } else {
+    ++readingsuccesscount;
+  }
+}
+
 void SDM::flush(unsigned long _flushtime) {
   unsigned long flushstart = millis();
   while (sdmSer.available() || (millis() - flushstart < _flushtime)) {
@@ -92,6 +92,13 @@
 //------------------------------------------------------------------------------
 
 #define FRAMESIZE                                     9                         //  size of out/in array
+
+#define SDM_MAX_BLOCK_VALUES                          10                        //  max number of consecutive float values per block read
+#define SDM_BLOCK_FRAMESIZE                           (5 + 4 * SDM_MAX_BLOCK_VALUES)  //  size of in array for block reads
+
+#define SDM_BLOCK_PENDING                             0                         //  block read: response not yet complete
+#define SDM_BLOCK_DONE                                1                         //  block read: values received
+#define SDM_BLOCK_ERROR                               2                         //  block read: failed, see getErrCode()
 #define SDM_REPLY_BYTE_COUNT                          0x04                      //  number of bytes with data
 
 #define SDM_B_01                                      0x01                      //  BYTE 1 -> slave address (default value 1 read from node 1)
@@ -252,6 +259,8 @@ class SDM {
 
     void begin(void);
     float readVal(uint16_t reg, uint8_t node = SDM_B_01);                       //  read value from register = reg and from deviceId = node
+    bool startBlockRead(uint16_t reg, uint8_t count, uint8_t node = SDM_B_01);  //  non-blocking: request count consecutive values starting at register = reg
+    uint8_t pollBlockRead(float* values);                                       //  non-blocking: check for block response, fills values on SDM_BLOCK_DONE
     uint16_t getErrCode(bool _clear = false);                                   //  return last errorcode (optional clear this value, default flase)
     uint32_t getErrCount(bool _clear = false);                                  //  return total errors count (optional clear this value, default flase)
     uint32_t getSuccCount(bool _clear = false);                                 //  return total success count (optional clear this value, default false)
@@ -292,6 +301,10 @@ class SDM {
     uint16_t mstimeout = RESPONSE_TIMEOUT;
     uint32_t readingerrcount = 0;                                               //  total errors counter
     uint32_t readingsuccesscount = 0;                                           //  total success counter
+    uint8_t blocknode = SDM_B_01;                                               //  node of pending block read
+    uint8_t blockcount = 0;                                                     //  number of values of pending block read, 0 if none
+    unsigned long blockstart = 0;                                               //  time the pending block read was requested
+    void countReading(uint16_t readErr);
     uint16_t calculateCRC(uint8_t *array, uint8_t len);
     void flush(unsigned long _flushtime = 0);                                   //  read serial if any old data is available or for a given time in ms
     void dereSet(bool _state = LOW);                                            //  for control MAX485 DE/RE pins, LOW receive from SDM, HIGH transmit to SDM
@@ -114,7 +114,7 @@ void VeDirectFrameHandler::loop()
 	// to decode a new frame once more data arrives.
 	if (IDLE != _state && _lastByteMillis + 500 < millis()) {
 		_msgOut->printf("[VE.Direct] Resetting state machine (was %d) after timeout\r\n", _state);
-		if (_verboseLogging) { dumpDebugBuffer(); }
+		if (isVerboseLogging()) { dumpDebugBuffer(); }
 		_checksum = 0;
 		_state = IDLE;
 	}
@@ -127,7 +127,7 @@ void VeDirectFrameHandler::loop()
  */
 void VeDirectFrameHandler::rxData(uint8_t inbyte)
 {
-	if (_verboseLogging) {
+	if (isVerboseLogging()) {
 		_debugBuffer[_debugIn] = inbyte;
 		_debugIn = (_debugIn + 1) % _debugBuffer.size();
 		if (0 == _debugIn) {
@@ -211,7 +211,7 @@ void VeDirectFrameHandler::rxData(uint8_t inbyte)
 		if (!valid) {
 			_msgOut->printf("[VE.Direct] checksum 0x%02x != 0, invalid frame\r\n", _checksum);
 		}
-		if (_verboseLogging) { dumpDebugBuffer(); }
+		if (isVerboseLogging()) { dumpDebugBuffer(); }
 		_checksum = 0;
 		_state = IDLE;
 		frameEndEvent(valid);
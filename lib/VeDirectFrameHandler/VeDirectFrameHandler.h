@@ -12,12 +12,17 @@
 #pragma once
 
 #include <Arduino.h>
+#include <LogLevel.h>
 #include <array>
 #include <memory>
 
 #define VE_MAX_VALUE_LEN 33 // VE.Direct Protocol: max value size is 33 including /0
 #define VE_MAX_HEX_LEN 100 // Maximum size of hex frame - max payload 34 byte (=68 char) + safe buffer
 
+#ifndef VEDIRECT_LOG_LEVEL
+#define VEDIRECT_LOG_LEVEL LOG_LEVEL
+#endif
+
 typedef struct {
     uint16_t PID = 0;               // product id
     char SER[VE_MAX_VALUE_LEN];     // serial number
@@ -41,6 +46,7 @@ public:
 
 protected:
     void textRxEvent(char *, char *, veStruct& );
+    bool isVerboseLogging() const { return LOG_ENABLED(LOG_LEVEL_VERBOSE, VEDIRECT_LOG_LEVEL, _verboseLogging); }
 
     bool _verboseLogging;
     Print* _msgOut;
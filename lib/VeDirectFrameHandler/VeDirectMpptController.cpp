@@ -11,7 +11,7 @@ void VeDirectMpptController::init(int8_t rx, int8_t tx, int8_t num, Print* msgOu
 {
 	VeDirectFrameHandler::init(rx, tx, msgOut, verboseLogging, 1+num);
 	_isInit = true;
-	if (_verboseLogging) { _msgOut->println("Finished init MPPTController"); }
+	if (isVerboseLogging()) { _msgOut->println("Finished init MPPTController"); }
 }
 
 bool VeDirectMpptController::isDataValid() {
@@ -23,7 +23,7 @@ bool VeDirectMpptController::isInit() {
 }
 
 void VeDirectMpptController::textRxEvent(char * name, char * value) {
-	if (_verboseLogging) { _msgOut->printf("[Victron MPPT] Received Text Event %s: Value: %s\r\n", name, value ); }
+	if (isVerboseLogging()) { _msgOut->printf("[Victron MPPT] Received Text Event %s: Value: %s\r\n", name, value ); }
 	VeDirectFrameHandler::textRxEvent(name, value, _tmpFrame);
 	if (strcmp(name, "LOAD") == 0) {
 		if (strcmp(value, "ON") == 0)
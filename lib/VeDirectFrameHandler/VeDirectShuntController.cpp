@@ -10,7 +10,7 @@ VeDirectShuntController::VeDirectShuntController()
 void VeDirectShuntController::init(int8_t rx, int8_t tx, Print* msgOut, bool verboseLogging)
 {
 	VeDirectFrameHandler::init(rx, tx, msgOut, verboseLogging, 2);
-	if (_verboseLogging) {
+	if (isVerboseLogging()) {
 		_msgOut->println("Finished init ShuntController");
 	}
 }
@@ -18,7 +18,7 @@ void VeDirectShuntController::init(int8_t rx, int8_t tx, Print* msgOut, bool ver
 void VeDirectShuntController::textRxEvent(char* name, char* value)
 {
 	VeDirectFrameHandler::textRxEvent(name, value, _tmpFrame);
-	if (_verboseLogging) { 
+	if (isVerboseLogging()) { 
 		_msgOut->printf("[Victron SmartShunt] Received Text Event %s: Value: %s\r\n", name, value ); 
 	}
 	if (strcmp(name, "T") == 0) {
@@ -7,21 +7,457 @@
 #include "defaults.h"
 #include <ArduinoJson.h>
 #include <LittleFS.h>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <esp_rom_crc.h>
+#include <initializer_list>
 
 CONFIG_T config;
 
+// header of the binary configuration files, followed by the payload
+struct ConfigFileHeader {
+    uint32_t Magic;
+    uint16_t FormatVersion;
+    uint16_t HeaderSize;
+    uint32_t SchemaVersion;
+    uint32_t PayloadSize;
+    uint32_t PayloadLayout;
+    uint32_t PayloadCrc;
+};
+
+#define CONFIG_BINARY_MAGIC 0x47464344 // "DCFG"
+#define CONFIG_BINARY_FORMAT_VERSION 2
+
+// FNV-1a over the size of a structure and the offset and size of all its
+// members. a file is rejected if the layout of its payload changed, even if
+// CONFIG_VERSION and the total size did not. new members have to be added
+// to the lists below.
+static constexpr uint32_t layoutHash(std::initializer_list<size_t> values)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t value : values) {
+        hash = (hash ^ static_cast<uint32_t>(value)) * 16777619u;
+    }
+    return hash;
+}
+
+#define LAYOUT_MEMBER(type, member) offsetof(type, member), sizeof(type::member)
+
+static constexpr uint32_t CHANNEL_LAYOUT = layoutHash({
+    sizeof(CHANNEL_CONFIG_T),
+    LAYOUT_MEMBER(CHANNEL_CONFIG_T, MaxChannelPower),
+    LAYOUT_MEMBER(CHANNEL_CONFIG_T, Name),
+    LAYOUT_MEMBER(CHANNEL_CONFIG_T, YieldTotalOffset),
+});
+
+static constexpr uint32_t INVERTER_LAYOUT = layoutHash({
+    sizeof(INVERTER_CONFIG_T),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, Serial),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, Name),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, Order),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, Poll_Enable),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, Poll_Enable_Night),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, Command_Enable),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, Command_Enable_Night),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, ReachableThreshold),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, ZeroRuntimeDataIfUnrechable),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, ZeroYieldDayOnMidnight),
+    LAYOUT_MEMBER(INVERTER_CONFIG_T, channel), CHANNEL_LAYOUT,
+});
+
+static constexpr uint32_t POWERMETER_HTTP_PHASE_LAYOUT = layoutHash({
+    sizeof(POWERMETER_HTTP_PHASE_CONFIG_T),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_CONFIG_T, Enabled),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_CONFIG_T, AuthType),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_CONFIG_T, Username),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_CONFIG_T, Password),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_CONFIG_T, Timeout),
+});
+
+static constexpr uint32_t CONFIG_LAYOUT = layoutHash({
+    sizeof(CONFIG_T),
+    LAYOUT_MEMBER(CONFIG_T, Cfg_Version),
+    LAYOUT_MEMBER(CONFIG_T, Cfg_SaveCount),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Ssid),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Password),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Ip),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Netmask),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Gateway),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Dns1),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Dns2),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Dhcp),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_Hostname),
+    LAYOUT_MEMBER(CONFIG_T, WiFi_ApTimeout),
+    LAYOUT_MEMBER(CONFIG_T, Ntp_Server),
+    LAYOUT_MEMBER(CONFIG_T, Ntp_Timezone),
+    LAYOUT_MEMBER(CONFIG_T, Ntp_TimezoneDescr),
+    LAYOUT_MEMBER(CONFIG_T, Ntp_Longitude),
+    LAYOUT_MEMBER(CONFIG_T, Ntp_Latitude),
+    LAYOUT_MEMBER(CONFIG_T, Ntp_SunsetType),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Enabled),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Hostname),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_VerboseLogging),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Port),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Username),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Password),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Topic),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Retain),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_LwtTopic),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_LwtValue_Online),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_LwtValue_Offline),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_PublishInterval),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_CleanSession),
+    LAYOUT_MEMBER(CONFIG_T, Inverter), INVERTER_LAYOUT,
+    LAYOUT_MEMBER(CONFIG_T, Dtu_Serial),
+    LAYOUT_MEMBER(CONFIG_T, Dtu_PollInterval),
+    LAYOUT_MEMBER(CONFIG_T, Dtu_VerboseLogging),
+    LAYOUT_MEMBER(CONFIG_T, Dtu_NrfPaLevel),
+    LAYOUT_MEMBER(CONFIG_T, Dtu_CmtPaLevel),
+    LAYOUT_MEMBER(CONFIG_T, Dtu_CmtFrequency),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Hass_Enabled),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Hass_Retain),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Hass_Topic),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Hass_IndividualPanels),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Hass_Expire),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_Tls),
+    LAYOUT_MEMBER(CONFIG_T, Mqtt_TlsCertLogin),
+    LAYOUT_MEMBER(CONFIG_T, Vedirect_Enabled),
+    LAYOUT_MEMBER(CONFIG_T, Vedirect_VerboseLogging),
+    LAYOUT_MEMBER(CONFIG_T, Vedirect_UpdatesOnly),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_Enabled),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_VerboseLogging),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_Interval),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_Source),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_MqttTopicPowerMeter1),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_MqttTopicPowerMeter2),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_MqttTopicPowerMeter3),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_SdmBaudrate),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_SdmAddress),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_HttpInterval),
+    LAYOUT_MEMBER(CONFIG_T, PowerMeter_HttpIndividualRequests),
+    LAYOUT_MEMBER(CONFIG_T, Powermeter_Http_Phase), POWERMETER_HTTP_PHASE_LAYOUT,
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_Enabled),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_VerboseLogging),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_SolarPassThroughEnabled),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_SolarPassThroughLosses),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_BatteryDrainStategy),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_Interval),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_IsInverterBehindPowerMeter),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_InverterId),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_InverterChannelId),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_TargetPowerConsumption),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_TargetPowerConsumptionHysteresis),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_LowerPowerLimit),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_UpperPowerLimit),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_BatterySocStartThreshold),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_BatterySocStopThreshold),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_VoltageStartThreshold),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_VoltageStopThreshold),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_VoltageLoadCorrectionFactor),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_RestartHour),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_FullSolarPassThroughSoc),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_FullSolarPassThroughStartVoltage),
+    LAYOUT_MEMBER(CONFIG_T, PowerLimiter_FullSolarPassThroughStopVoltage),
+    LAYOUT_MEMBER(CONFIG_T, Battery_Enabled),
+    LAYOUT_MEMBER(CONFIG_T, Battery_VerboseLogging),
+    LAYOUT_MEMBER(CONFIG_T, Battery_Provider),
+    LAYOUT_MEMBER(CONFIG_T, Battery_JkBmsInterface),
+    LAYOUT_MEMBER(CONFIG_T, Battery_JkBmsPollingInterval),
+    LAYOUT_MEMBER(CONFIG_T, Huawei_Enabled),
+    LAYOUT_MEMBER(CONFIG_T, Huawei_Auto_Power_Enabled),
+    LAYOUT_MEMBER(CONFIG_T, Huawei_Auto_Power_Voltage_Limit),
+    LAYOUT_MEMBER(CONFIG_T, Huawei_Auto_Power_Enable_Voltage_Limit),
+    LAYOUT_MEMBER(CONFIG_T, Huawei_Auto_Power_Lower_Power_Limit),
+    LAYOUT_MEMBER(CONFIG_T, Huawei_Auto_Power_Upper_Power_Limit),
+    LAYOUT_MEMBER(CONFIG_T, Security_Password),
+    LAYOUT_MEMBER(CONFIG_T, Security_AllowReadonly),
+    LAYOUT_MEMBER(CONFIG_T, Dev_PinMapping),
+    LAYOUT_MEMBER(CONFIG_T, Display_PowerSafe),
+    LAYOUT_MEMBER(CONFIG_T, Display_ScreenSaver),
+    LAYOUT_MEMBER(CONFIG_T, Display_Rotation),
+    LAYOUT_MEMBER(CONFIG_T, Display_Contrast),
+    LAYOUT_MEMBER(CONFIG_T, Display_Language),
+});
+
+static constexpr uint32_t MQTT_TLS_LAYOUT = layoutHash({
+    sizeof(MQTT_TLS_CONFIG_T),
+    LAYOUT_MEMBER(MQTT_TLS_CONFIG_T, RootCaCert),
+    LAYOUT_MEMBER(MQTT_TLS_CONFIG_T, ClientCert),
+    LAYOUT_MEMBER(MQTT_TLS_CONFIG_T, ClientKey),
+});
+
+static constexpr uint32_t POWERMETER_HTTP_PHASE_TEXT_LAYOUT = layoutHash({
+    sizeof(POWERMETER_HTTP_PHASE_TEXT_T),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_TEXT_T, Url),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_TEXT_T, HeaderKey),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_TEXT_T, HeaderValue),
+    LAYOUT_MEMBER(POWERMETER_HTTP_PHASE_TEXT_T, JsonPath),
+});
+
+static constexpr uint32_t POWERMETER_HTTP_TEXT_LAYOUT = layoutHash({
+    sizeof(POWERMETER_HTTP_TEXT_T),
+    LAYOUT_MEMBER(POWERMETER_HTTP_TEXT_T, Phase), POWERMETER_HTTP_PHASE_TEXT_LAYOUT,
+});
+
+ConfigurationClass::WriteGuard::WriteGuard(std::mutex& mutex)
+    : _lock(mutex)
+{
+}
+
+CONFIG_T& ConfigurationClass::WriteGuard::getConfig()
+{
+    return config;
+}
+
 void ConfigurationClass::init()
 {
     memset(&config, 0x0, sizeof(config));
 }
 
+void ConfigurationClass::loop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        if (!_writePending) {
+            return;
+        }
+
+        uint32_t now = millis();
+        if (now - _lastWriteRequest < CONFIG_WRITE_QUIET_PERIOD
+            && now - _firstWriteRequest < CONFIG_WRITE_MAX_DELAY) {
+            return;
+        }
+    }
+
+    flush();
+}
+
+void ConfigurationClass::requestWrite()
+{
+    std::lock_guard<std::mutex> lock(_writeMutex);
+
+    uint32_t now = millis();
+    if (!_writePending) {
+        _writePending = true;
+        _firstWriteRequest = now;
+    }
+    _lastWriteRequest = now;
+    _writeStatistics.Requests++;
+}
+
+bool ConfigurationClass::flush()
+{
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    if (!_writePending) {
+        return true;
+    }
+
+    if (!write()) {
+        // retry after the quiet period
+        _lastWriteRequest = millis();
+        _firstWriteRequest = _lastWriteRequest;
+        return false;
+    }
+
+    // the JSON file is the fallback if the binary file is rejected, e.g.
+    // after an update changed CONFIG_T. it is refreshed with every deferred
+    // write, so it is never older than the last saved settings.
+    if (!exportJson()) {
+        MessageOutput.printf("[Configuration] ERROR: Failed to export %s\r\n", CONFIG_FILENAME);
+    }
+
+    _writePending = false;
+    return true;
+}
+
+ConfigWriteStatistics_t ConfigurationClass::getWriteStatistics()
+{
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    ConfigWriteStatistics_t stats = _writeStatistics;
+    stats.Pending = _writePending;
+    return stats;
+}
+
+std::unique_ptr<CONFIG_T> ConfigurationClass::copyConfig(bool save)
+{
+    // the web API keeps changing the configuration while it is written,
+    // a copy taken under the guard is written instead
+    std::unique_ptr<CONFIG_T> copy(new (std::nothrow) CONFIG_T);
+    if (!copy) {
+        MessageOutput.println("[Configuration] Not enough memory to write the configuration");
+        return nullptr;
+    }
+
+    auto guard = getWriteGuard();
+    CONFIG_T& current = guard.getConfig();
+    if (save) {
+        current.Cfg_SaveCount++;
+    }
+    *copy = current;
+    return copy;
+}
+
 bool ConfigurationClass::write()
 {
-    File f = LittleFS.open(CONFIG_FILENAME, "w");
+    uint32_t start = micros();
+
+    std::unique_ptr<CONFIG_T> copy = copyConfig(true);
+    if (!copy) {
+        return false;
+    }
+
+    bool success = writeBinaryFile(CONFIG_BINARY_FILENAME, copy.get(), sizeof(*copy), CONFIG_LAYOUT);
+
+    _writeStatistics.Writes++;
+    _writeStatistics.LastWriteUs = micros() - start;
+    _writeStatistics.MaxWriteUs = std::max(_writeStatistics.MaxWriteUs, _writeStatistics.LastWriteUs);
+    return success;
+}
+
+bool ConfigurationClass::read()
+{
+    if (readBinary()) {
+        return true;
+    }
+
+    // first boot after an update from a JSON based firmware, after a change
+    // of CONFIG_T or after a JSON file was uploaded
+    if (LittleFS.exists(CONFIG_FILENAME)) {
+        MessageOutput.print("importing JSON... ");
+    }
+    importJson();
+    write();
+    return true;
+}
+
+bool ConfigurationClass::readBinary()
+{
+    if (!LittleFS.exists(CONFIG_BINARY_FILENAME)) {
+        return false;
+    }
+
+    if (!readBinaryFile(CONFIG_BINARY_FILENAME, &config, sizeof(config), CONFIG_LAYOUT)) {
+        MessageOutput.printf("\r\n[Configuration] WARNING: %s was rejected, the settings are imported from %s "
+                             "which might be older than the last saved settings\r\n",
+            CONFIG_BINARY_FILENAME, CONFIG_FILENAME);
+        init();
+        return false;
+    }
+    return true;
+}
+
+bool ConfigurationClass::writeBinaryFile(const char* filename, const void* data, size_t size, uint32_t layout)
+{
+    ConfigFileHeader header;
+    header.Magic = CONFIG_BINARY_MAGIC;
+    header.FormatVersion = CONFIG_BINARY_FORMAT_VERSION;
+    header.HeaderSize = sizeof(header);
+    header.SchemaVersion = CONFIG_VERSION;
+    header.PayloadSize = size;
+    header.PayloadLayout = layout;
+    header.PayloadCrc = esp_rom_crc32_le(0, static_cast<const uint8_t*>(data), size);
+
+    // the previous file stays intact until the new one is complete
+    String tmpFilename = String(filename) + ".tmp";
+    File f = LittleFS.open(tmpFilename, "w");
     if (!f) {
         return false;
     }
-    config.Cfg_SaveCount++;
+
+    bool success = f.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header)
+        && f.write(static_cast<const uint8_t*>(data), size) == size;
+    f.close();
+
+    if (!success) {
+        MessageOutput.println("Failed to write file");
+        LittleFS.remove(tmpFilename);
+        return false;
+    }
+
+    return LittleFS.rename(tmpFilename, filename);
+}
+
+bool ConfigurationClass::readBinaryFile(const char* filename, void* data, size_t size, uint32_t layout)
+{
+    File f = LittleFS.open(filename, "r", false);
+    if (!f) {
+        return false;
+    }
+
+    ConfigFileHeader header;
+    const char* error = nullptr;
+    if (f.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)
+        || header.Magic != CONFIG_BINARY_MAGIC
+        || header.FormatVersion != CONFIG_BINARY_FORMAT_VERSION
+        || header.HeaderSize != sizeof(header)) {
+        error = "unknown file format";
+    } else if (header.SchemaVersion != CONFIG_VERSION) {
+        error = "written by a different configuration version";
+    } else if (header.PayloadSize != size || header.PayloadLayout != layout) {
+        error = "layout of the settings changed";
+    } else if (f.read(static_cast<uint8_t*>(data), size) != size) {
+        error = "file is truncated";
+    } else if (esp_rom_crc32_le(0, static_cast<const uint8_t*>(data), size) != header.PayloadCrc) {
+        error = "checksum mismatch";
+    }
+    f.close();
+
+    if (error != nullptr) {
+        MessageOutput.printf("\r\n[Configuration] ERROR: Rejected %s: %s\r\n", filename, error);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<MQTT_TLS_CONFIG_T> ConfigurationClass::loadMqttTls()
+{
+    auto tls = std::make_unique<MQTT_TLS_CONFIG_T>();
+    if (!readBinaryFile(CONFIG_MQTT_TLS_FILENAME, tls.get(), sizeof(*tls), MQTT_TLS_LAYOUT)) {
+        *tls = {};
+        strlcpy(tls->RootCaCert, MQTT_ROOT_CA_CERT, sizeof(tls->RootCaCert));
+        strlcpy(tls->ClientCert, MQTT_TLSCLIENTCERT, sizeof(tls->ClientCert));
+        strlcpy(tls->ClientKey, MQTT_TLSCLIENTKEY, sizeof(tls->ClientKey));
+    }
+    return tls;
+}
+
+bool ConfigurationClass::writeMqttTls(const MQTT_TLS_CONFIG_T& tls)
+{
+    // the settings page sends the certificates on every save
+    if (!memcmp(loadMqttTls().get(), &tls, sizeof(tls))) {
+        return true;
+    }
+    return writeBinaryFile(CONFIG_MQTT_TLS_FILENAME, &tls, sizeof(tls), MQTT_TLS_LAYOUT);
+}
+
+std::unique_ptr<POWERMETER_HTTP_TEXT_T> ConfigurationClass::loadPowerMeterHttp()
+{
+    auto http = std::make_unique<POWERMETER_HTTP_TEXT_T>();
+    if (!readBinaryFile(CONFIG_POWERMETER_HTTP_FILENAME, http.get(), sizeof(*http), POWERMETER_HTTP_TEXT_LAYOUT)) {
+        *http = {};
+    }
+    return http;
+}
+
+bool ConfigurationClass::writePowerMeterHttp(const POWERMETER_HTTP_TEXT_T& http)
+{
+    if (!memcmp(loadPowerMeterHttp().get(), &http, sizeof(http))) {
+        return true;
+    }
+    return writeBinaryFile(CONFIG_POWERMETER_HTTP_FILENAME, &http, sizeof(http), POWERMETER_HTTP_TEXT_LAYOUT);
+}
+
+bool ConfigurationClass::exportJson()
+{
+    std::unique_ptr<CONFIG_T> copy = copyConfig(false);
+    return copy && exportJson(*copy);
+}
+
+bool ConfigurationClass::exportJson(const CONFIG_T& config)
+{
+    auto tls = loadMqttTls();
+    auto http = loadPowerMeterHttp();
 
     DynamicJsonDocument doc(JSON_BUFFER_SIZE);
 
@@ -68,10 +504,10 @@ bool ConfigurationClass::write()
 
     JsonObject mqtt_tls = mqtt.createNestedObject("tls");
     mqtt_tls["enabled"] = config.Mqtt_Tls;
-    mqtt_tls["root_ca_cert"] = config.Mqtt_RootCaCert;
+    mqtt_tls["root_ca_cert"] = tls->RootCaCert;
     mqtt_tls["certlogin"] = config.Mqtt_TlsCertLogin;
-    mqtt_tls["client_cert"] = config.Mqtt_ClientCert;
-    mqtt_tls["client_key"] = config.Mqtt_ClientKey;
+    mqtt_tls["client_cert"] = tls->ClientCert;
+    mqtt_tls["client_key"] = tls->ClientKey;
 
     JsonObject mqtt_hass = mqtt.createNestedObject("hass");
     mqtt_hass["enabled"] = config.Mqtt_Hass_Enabled;
@@ -147,14 +583,14 @@ bool ConfigurationClass::write()
         JsonObject powermeter_phase = powermeter_http_phases.createNestedObject();
 
         powermeter_phase["enabled"] = config.Powermeter_Http_Phase[i].Enabled;
-        powermeter_phase["url"] = config.Powermeter_Http_Phase[i].Url;
+        powermeter_phase["url"] = http->Phase[i].Url;
         powermeter_phase["auth_type"] = config.Powermeter_Http_Phase[i].AuthType;
         powermeter_phase["username"] = config.Powermeter_Http_Phase[i].Username;
         powermeter_phase["password"] = config.Powermeter_Http_Phase[i].Password;
-        powermeter_phase["header_key"] = config.Powermeter_Http_Phase[i].HeaderKey;
-        powermeter_phase["header_value"] = config.Powermeter_Http_Phase[i].HeaderValue;
+        powermeter_phase["header_key"] = http->Phase[i].HeaderKey;
+        powermeter_phase["header_value"] = http->Phase[i].HeaderValue;
         powermeter_phase["timeout"] = config.Powermeter_Http_Phase[i].Timeout;
-        powermeter_phase["json_path"] = config.Powermeter_Http_Phase[i].JsonPath;
+        powermeter_phase["json_path"] = http->Phase[i].JsonPath;
     }
 
     JsonObject powerlimiter = doc.createNestedObject("powerlimiter");
@@ -196,17 +632,24 @@ bool ConfigurationClass::write()
     huawei["lower_power_limit"] = config.Huawei_Auto_Power_Lower_Power_Limit;
     huawei["upper_power_limit"] = config.Huawei_Auto_Power_Upper_Power_Limit;
 
+    File f = LittleFS.open(CONFIG_TMP_FILENAME, "w");
+    if (!f) {
+        return false;
+    }
+
     // Serialize JSON to file
     if (serializeJson(doc, f) == 0) {
         MessageOutput.println("Failed to write file");
+        f.close();
+        LittleFS.remove(CONFIG_TMP_FILENAME);
         return false;
     }
 
     f.close();
-    return true;
+    return LittleFS.rename(CONFIG_TMP_FILENAME, CONFIG_FILENAME);
 }
 
-bool ConfigurationClass::read()
+bool ConfigurationClass::importJson()
 {
     File f = LittleFS.open(CONFIG_FILENAME, "r", false);
 
@@ -291,10 +734,14 @@ bool ConfigurationClass::read()
 
     JsonObject mqtt_tls = mqtt["tls"];
     config.Mqtt_Tls = mqtt_tls["enabled"] | MQTT_TLS;
-    strlcpy(config.Mqtt_RootCaCert, mqtt_tls["root_ca_cert"] | MQTT_ROOT_CA_CERT, sizeof(config.Mqtt_RootCaCert));
     config.Mqtt_TlsCertLogin = mqtt_tls["certlogin"] | MQTT_TLSCERTLOGIN;
-    strlcpy(config.Mqtt_ClientCert, mqtt_tls["client_cert"] | MQTT_TLSCLIENTCERT, sizeof(config.Mqtt_ClientCert));
-    strlcpy(config.Mqtt_ClientKey, mqtt_tls["client_key"] | MQTT_TLSCLIENTKEY, sizeof(config.Mqtt_ClientKey));
+
+    auto tls = std::make_unique<MQTT_TLS_CONFIG_T>();
+    strlcpy(tls->RootCaCert, mqtt_tls["root_ca_cert"] | MQTT_ROOT_CA_CERT, sizeof(tls->RootCaCert));
+    strlcpy(tls->ClientCert, mqtt_tls["client_cert"] | MQTT_TLSCLIENTCERT, sizeof(tls->ClientCert));
+    strlcpy(tls->ClientKey, mqtt_tls["client_key"] | MQTT_TLSCLIENTKEY, sizeof(tls->ClientKey));
+    writeMqttTls(*tls);
+    tls.reset();
 
     JsonObject mqtt_hass = mqtt["hass"];
     config.Mqtt_Hass_Enabled = mqtt_hass["enabled"] | MQTT_HASS_ENABLED;
@@ -367,20 +814,23 @@ bool ConfigurationClass::read()
     config.PowerMeter_SdmAddress =  powermeter["sdmaddress"] | POWERMETER_SDMADDRESS;
     config.PowerMeter_HttpIndividualRequests = powermeter["http_individual_requests"] | false;
 
+    auto http = std::make_unique<POWERMETER_HTTP_TEXT_T>();
     JsonArray powermeter_http_phases = powermeter["http_phases"];
     for (uint8_t i = 0; i < POWERMETER_MAX_PHASES; i++) {
         JsonObject powermeter_phase = powermeter_http_phases[i].as<JsonObject>();
 
         config.Powermeter_Http_Phase[i].Enabled = powermeter_phase["enabled"] | (i == 0);
-        strlcpy(config.Powermeter_Http_Phase[i].Url, powermeter_phase["url"] | "", sizeof(config.Powermeter_Http_Phase[i].Url));
+        strlcpy(http->Phase[i].Url, powermeter_phase["url"] | "", sizeof(http->Phase[i].Url));
         config.Powermeter_Http_Phase[i].AuthType = powermeter_phase["auth_type"] | Auth::none;
         strlcpy(config.Powermeter_Http_Phase[i].Username, powermeter_phase["username"] | "", sizeof(config.Powermeter_Http_Phase[i].Username));
         strlcpy(config.Powermeter_Http_Phase[i].Password, powermeter_phase["password"] | "", sizeof(config.Powermeter_Http_Phase[i].Password));
-        strlcpy(config.Powermeter_Http_Phase[i].HeaderKey, powermeter_phase["header_key"] | "", sizeof(config.Powermeter_Http_Phase[i].HeaderKey));
-        strlcpy(config.Powermeter_Http_Phase[i].HeaderValue, powermeter_phase["header_value"] | "", sizeof(config.Powermeter_Http_Phase[i].HeaderValue));
+        strlcpy(http->Phase[i].HeaderKey, powermeter_phase["header_key"] | "", sizeof(http->Phase[i].HeaderKey));
+        strlcpy(http->Phase[i].HeaderValue, powermeter_phase["header_value"] | "", sizeof(http->Phase[i].HeaderValue));
         config.Powermeter_Http_Phase[i].Timeout = powermeter_phase["timeout"] | POWERMETER_HTTP_TIMEOUT;
-        strlcpy(config.Powermeter_Http_Phase[i].JsonPath, powermeter_phase["json_path"] | "", sizeof(config.Powermeter_Http_Phase[i].JsonPath));
+        strlcpy(http->Phase[i].JsonPath, powermeter_phase["json_path"] | "", sizeof(http->Phase[i].JsonPath));
     }
+    writePowerMeterHttp(*http);
+    http.reset();
 
     JsonObject powerlimiter = doc["powerlimiter"];
     config.PowerLimiter_Enabled = powerlimiter["enabled"] | POWERLIMITER_ENABLED;
@@ -422,7 +872,7 @@ bool ConfigurationClass::read()
     config.Huawei_Auto_Power_Upper_Power_Limit = huawei["upper_power_limit"] | HUAWEI_AUTO_POWER_UPPER_POWER_LIMIT;
 
     f.close();
-    return true;
+    return !error;
 }
 
 void ConfigurationClass::migrate()
@@ -475,6 +925,11 @@ CONFIG_T& ConfigurationClass::get()
     return config;
 }
 
+ConfigurationClass::WriteGuard ConfigurationClass::getWriteGuard()
+{
+    return WriteGuard(_configMutex);
+}
+
 INVERTER_CONFIG_T* ConfigurationClass::getFreeInverterSlot()
 {
     for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
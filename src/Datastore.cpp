@@ -15,192 +15,162 @@ void DatastoreClass::init()
 
 void DatastoreClass::loop()
 {
-    if (Hoymiles.isAllRadioIdle() && _updateTimeout.occured()) {
+    bool changed = false;
 
-        uint8_t isProducing = 0;
-        uint8_t isReachable = 0;
-        uint8_t pollEnabledCount = 0;
-
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        _totalAcYieldTotalEnabled = 0;
-        _totalAcYieldTotalDigits = 0;
-
-        _totalAcYieldDayEnabled = 0;
-        _totalAcYieldDayDigits = 0;
-
-        _totalAcPowerEnabled = 0;
-        _totalAcPowerDigits = 0;
-
-        _totalDcPowerEnabled = 0;
-        _totalDcPowerDigits = 0;
+    size_t count = Hoymiles.getNumInverters();
+    if (_contributions.size() != count) {
+        _contributions.resize(count);
+        changed = true;
+    }
 
-        _totalDcPowerIrradiation = 0;
-        _totalDcIrradiationInstalled = 0;
+    // reachability changes without new statistics, e.g. if an inverter
+    // stops answering. the configuration might have changed as well.
+    bool refresh = _updateTimeout.occured();
 
-        _isAllEnabledProducing = true;
-        _isAllEnabledReachable = true;
+    for (uint8_t i = 0; i < count; i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+        if (inv == nullptr) {
+            continue;
+        }
 
-        for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
-            auto inv = Hoymiles.getInverterByPos(i);
-            if (inv == nullptr) {
-                continue;
-            }
+        Contribution& c = _contributions[i];
+        // also changes if the values were zeroed at night or midnight
+        uint32_t lastUpdate = inv->Statistics()->getLastUpdateFromInternal();
+        bool pollEnabled = inv->getEnablePolling();
 
+        if (refresh) {
             auto cfg = Configuration.getInverterConfig(inv->serial());
-            if (cfg == nullptr) {
-                continue;
-            }
-
-            if (inv->getEnablePolling()) {
-                pollEnabledCount++;
-            }
-
-            if (inv->isProducing()) {
-                isProducing++;
-            } else {
-                if (inv->getEnablePolling()) {
-                    _isAllEnabledProducing = false;
-                }
+            bool configured = cfg != nullptr;
+            bool configPollEnable = configured && cfg->Poll_Enable;
+            bool reachable = inv->isReachable();
+
+            if (c.configured != configured || c.configPollEnable != configPollEnable || c.reachable != reachable) {
+                c.configured = configured;
+                c.configPollEnable = configPollEnable;
+                c.reachable = reachable;
+                changed = true;
             }
+        }
 
-            if (inv->isReachable()) {
-                isReachable++;
-            } else {
-                if (inv->getEnablePolling()) {
-                    _isAllEnabledReachable = false;
-                }
-            }
+        // only walk the fields if the statistics changed
+        if (c.serial == inv->serial() && c.lastUpdate == lastUpdate && c.pollEnabled == pollEnabled) {
+            continue;
+        }
 
-            for (auto& c : inv->Statistics()->getChannelsByType(TYPE_AC)) {
-                if (cfg->Poll_Enable) {
-                    _totalAcYieldTotalEnabled += inv->Statistics()->getChannelFieldValue(TYPE_AC, c, FLD_YT);
-                    _totalAcYieldDayEnabled += inv->Statistics()->getChannelFieldValue(TYPE_AC, c, FLD_YD);
-
-                    _totalAcYieldTotalDigits = max<unsigned int>(_totalAcYieldTotalDigits, inv->Statistics()->getChannelFieldDigits(TYPE_AC, c, FLD_YT));
-                    _totalAcYieldDayDigits = max<unsigned int>(_totalAcYieldDayDigits, inv->Statistics()->getChannelFieldDigits(TYPE_AC, c, FLD_YD));
-                }
-                if (inv->getEnablePolling()) {
-                    _totalAcPowerEnabled += inv->Statistics()->getChannelFieldValue(TYPE_AC, c, FLD_PAC);
-                    _totalAcPowerDigits = max<unsigned int>(_totalAcPowerDigits, inv->Statistics()->getChannelFieldDigits(TYPE_AC, c, FLD_PAC));
-                }
-            }
+        auto cfg = Configuration.getInverterConfig(inv->serial());
+        c.serial = inv->serial();
+        c.lastUpdate = lastUpdate;
+        c.pollEnabled = pollEnabled;
+        c.configured = cfg != nullptr;
+        c.configPollEnable = c.configured && cfg->Poll_Enable;
+        c.producing = inv->isProducing();
+        c.reachable = inv->isReachable();
+
+        c.acYieldTotal = 0;
+        c.acYieldDay = 0;
+        c.acPower = 0;
+        c.dcPower = 0;
+        c.dcPowerIrradiation = 0;
+        c.dcIrradiationInstalled = 0;
+        c.acYieldTotalDigits = 0;
+        c.acYieldDayDigits = 0;
+        c.acPowerDigits = 0;
+        c.dcPowerDigits = 0;
+
+        for (auto& ch : inv->Statistics()->getChannelsByType(TYPE_AC)) {
+            c.acYieldTotal += inv->Statistics()->getChannelFieldValue(TYPE_AC, ch, FLD_YT);
+            c.acYieldDay += inv->Statistics()->getChannelFieldValue(TYPE_AC, ch, FLD_YD);
+            c.acPower += inv->Statistics()->getChannelFieldValue(TYPE_AC, ch, FLD_PAC);
+
+            c.acYieldTotalDigits = max<unsigned int>(c.acYieldTotalDigits, inv->Statistics()->getChannelFieldDigits(TYPE_AC, ch, FLD_YT));
+            c.acYieldDayDigits = max<unsigned int>(c.acYieldDayDigits, inv->Statistics()->getChannelFieldDigits(TYPE_AC, ch, FLD_YD));
+            c.acPowerDigits = max<unsigned int>(c.acPowerDigits, inv->Statistics()->getChannelFieldDigits(TYPE_AC, ch, FLD_PAC));
+        }
 
-            for (auto& c : inv->Statistics()->getChannelsByType(TYPE_DC)) {
-                if (inv->getEnablePolling()) {
-                    _totalDcPowerEnabled += inv->Statistics()->getChannelFieldValue(TYPE_DC, c, FLD_PDC);
-                    _totalDcPowerDigits = max<unsigned int>(_totalDcPowerDigits, inv->Statistics()->getChannelFieldDigits(TYPE_DC, c, FLD_PDC));
+        for (auto& ch : inv->Statistics()->getChannelsByType(TYPE_DC)) {
+            float power = inv->Statistics()->getChannelFieldValue(TYPE_DC, ch, FLD_PDC);
+            c.dcPower += power;
+            c.dcPowerDigits = max<unsigned int>(c.dcPowerDigits, inv->Statistics()->getChannelFieldDigits(TYPE_DC, ch, FLD_PDC));
 
-                    if (inv->Statistics()->getStringMaxPower(c) > 0) {
-                        _totalDcPowerIrradiation += inv->Statistics()->getChannelFieldValue(TYPE_DC, c, FLD_PDC);
-                        _totalDcIrradiationInstalled += inv->Statistics()->getStringMaxPower(c);
-                    }
-                }
+            if (inv->Statistics()->getStringMaxPower(ch) > 0) {
+                c.dcPowerIrradiation += power;
+                c.dcIrradiationInstalled += inv->Statistics()->getStringMaxPower(ch);
             }
         }
 
-        _isAtLeastOneProducing = isProducing > 0;
-        _isAtLeastOneReachable = isReachable > 0;
-        _isAtLeastOnePollEnabled = pollEnabledCount > 0;
-
-        _totalDcIrradiation = _totalDcIrradiationInstalled > 0 ? _totalDcPowerIrradiation / _totalDcIrradiationInstalled * 100.0f : 0;
+        changed = true;
+    }
 
+    if (refresh) {
         _updateTimeout.reset();
     }
-}
 
-float DatastoreClass::getTotalAcYieldTotalEnabled()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalAcYieldTotalEnabled;
+    if (changed) {
+        publish();
+    }
 }
 
-float DatastoreClass::getTotalAcYieldDayEnabled()
+void DatastoreClass::publish()
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalAcYieldDayEnabled;
-}
+    uint32_t version = _version.load(std::memory_order_relaxed) + 1;
+    Snapshot& s = _snapshots[version & 1];
 
-float DatastoreClass::getTotalAcPowerEnabled()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalAcPowerEnabled;
-}
+    // readers which loaded the previous version must see it changed once
+    // they could observe any of the writes below
+    std::atomic_thread_fence(std::memory_order_release);
 
-float DatastoreClass::getTotalDcPowerEnabled()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalDcPowerEnabled;
-}
+    s = Snapshot();
+    s.version = version;
+    s.isAllEnabledProducing = true;
+    s.isAllEnabledReachable = true;
 
-float DatastoreClass::getTotalDcPowerIrradiation()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalDcPowerIrradiation;
-}
+    for (auto const& c : _contributions) {
+        if (!c.configured) {
+            continue;
+        }
 
-float DatastoreClass::getTotalDcIrradiationInstalled()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalDcIrradiationInstalled;
-}
+        s.isAtLeastOnePollEnabled |= c.pollEnabled;
+        s.isAtLeastOneProducing |= c.producing;
+        s.isAtLeastOneReachable |= c.reachable;
 
-float DatastoreClass::getTotalDcIrradiation()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalDcIrradiation;
-}
+        if (c.pollEnabled) {
+            s.isAllEnabledProducing &= c.producing;
+            s.isAllEnabledReachable &= c.reachable;
+        }
 
-uint32_t DatastoreClass::getTotalAcYieldTotalDigits()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalAcYieldTotalDigits;
-}
+        if (c.configPollEnable) {
+            s.totalAcYieldTotalEnabled += c.acYieldTotal;
+            s.totalAcYieldDayEnabled += c.acYieldDay;
+            s.totalAcYieldTotalDigits = max<unsigned int>(s.totalAcYieldTotalDigits, c.acYieldTotalDigits);
+            s.totalAcYieldDayDigits = max<unsigned int>(s.totalAcYieldDayDigits, c.acYieldDayDigits);
+        }
 
-uint32_t DatastoreClass::getTotalAcYieldDayDigits()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalAcYieldDayDigits;
-}
+        if (c.pollEnabled) {
+            s.totalAcPowerEnabled += c.acPower;
+            s.totalAcPowerDigits = max<unsigned int>(s.totalAcPowerDigits, c.acPowerDigits);
 
-uint32_t DatastoreClass::getTotalAcPowerDigits()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalAcPowerDigits;
-}
+            s.totalDcPowerEnabled += c.dcPower;
+            s.totalDcPowerDigits = max<unsigned int>(s.totalDcPowerDigits, c.dcPowerDigits);
+            s.totalDcPowerIrradiation += c.dcPowerIrradiation;
+            s.totalDcIrradiationInstalled += c.dcIrradiationInstalled;
+        }
+    }
 
-uint32_t DatastoreClass::getTotalDcPowerDigits()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _totalDcPowerDigits;
-}
+    s.totalDcIrradiation = s.totalDcIrradiationInstalled > 0 ? s.totalDcPowerIrradiation / s.totalDcIrradiationInstalled * 100.0f : 0;
 
-bool DatastoreClass::getIsAtLeastOneReachable()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _isAtLeastOneReachable;
+    _version.store(version, std::memory_order_release);
 }
 
-bool DatastoreClass::getIsAtLeastOneProducing()
+DatastoreClass::Snapshot DatastoreClass::getSnapshot() const
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _isAtLeastOneProducing;
-}
+    Snapshot s;
+    uint32_t version;
 
-bool DatastoreClass::getIsAllEnabledProducing()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _isAllEnabledProducing;
-}
-
-bool DatastoreClass::getIsAllEnabledReachable()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _isAllEnabledReachable;
-}
+    do {
+        version = _version.load(std::memory_order_acquire);
+        s = _snapshots[version & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (version != _version.load(std::memory_order_relaxed));
 
-bool DatastoreClass::getIsAtLeastOnePollEnabled()
-{
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _isAtLeastOnePollEnabled;
-}
+    return s;
+}
\ No newline at end of file
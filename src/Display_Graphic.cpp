@@ -141,14 +141,15 @@ void DisplayGraphicClass::loop()
 
         _display->clearBuffer();
         bool displayPowerSave = false;
+        auto totals = Datastore.getSnapshot();
 
         //=====> Actual Production ==========
-        if (Datastore.getIsAtLeastOneReachable()) {
+        if (totals.isAtLeastOneReachable) {
             displayPowerSave = false;
-            if (Datastore.getTotalAcPowerEnabled() > 999) {
-                snprintf(_fmtText, sizeof(_fmtText), i18n_current_power_kw[_display_language], (Datastore.getTotalAcPowerEnabled() / 1000));
+            if (totals.totalAcPowerEnabled > 999) {
+                snprintf(_fmtText, sizeof(_fmtText), i18n_current_power_kw[_display_language], (totals.totalAcPowerEnabled / 1000));
             } else {
-                snprintf(_fmtText, sizeof(_fmtText), i18n_current_power_w[_display_language], Datastore.getTotalAcPowerEnabled());
+                snprintf(_fmtText, sizeof(_fmtText), i18n_current_power_w[_display_language], totals.totalAcPowerEnabled);
             }
             printText(_fmtText, 0);
             _previousMillis = millis();
@@ -166,10 +167,10 @@ void DisplayGraphicClass::loop()
         //<=======================
 
         //=====> Today & Total Production =======
-        snprintf(_fmtText, sizeof(_fmtText), i18n_yield_today_wh[_display_language], Datastore.getTotalAcYieldDayEnabled());
+        snprintf(_fmtText, sizeof(_fmtText), i18n_yield_today_wh[_display_language], totals.totalAcYieldDayEnabled);
         printText(_fmtText, 1);
 
-        snprintf(_fmtText, sizeof(_fmtText), i18n_yield_total_kwh[_display_language], Datastore.getTotalAcYieldTotalEnabled());
+        snprintf(_fmtText, sizeof(_fmtText), i18n_yield_total_kwh[_display_language], totals.totalAcYieldTotalEnabled);
         printText(_fmtText, 2);
         //<=======================
 
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#include "HassDiscoveryPublisher.h"
+#include "MqttSettings.h"
+#include <algorithm>
+
+uint32_t HassDiscoveryPublisher::hash(const char* s)
+{
+    // FNV-1a
+    uint32_t value = 2166136261u;
+    while (*s) {
+        value = (value ^ static_cast<uint8_t>(*s++)) * 16777619u;
+    }
+    return value;
+}
+
+void HassDiscoveryPublisher::begin(bool force)
+{
+    // a running burst is restarted, entities which were published already
+    // are skipped by their hash unless forced
+    _active = true;
+    _force = _force || force;
+    _cursor = 0;
+
+    _burstStart = millis();
+    _busyUs = 0;
+    _steps = 0;
+    _heapAtStart = ESP.getFreeHeap();
+    _minFreeHeap = _heapAtStart;
+}
+
+bool HassDiscoveryPublisher::beginStep()
+{
+    if (!_active) {
+        return false;
+    }
+
+    _index = 0;
+    _claimed = 0;
+    _budgetExhausted = false;
+    _stepStart = micros();
+    return true;
+}
+
+void HassDiscoveryPublisher::endStep()
+{
+    _busyUs += micros() - _stepStart;
+    _steps++;
+
+    if (_budgetExhausted) {
+        return;
+    }
+
+    // the handler enumerated all of its entities
+    _active = false;
+    _force = false;
+    _doc.reset();
+    _payload = std::string();
+
+    _statistics.LastBurstMs = millis() - _burstStart;
+    _statistics.LastBurstBusyUs = _busyUs;
+    _statistics.LastBurstSteps = _steps;
+    _statistics.LastBurstPeakHeap = _heapAtStart > _minFreeHeap ? _heapAtStart - _minFreeHeap : 0;
+}
+
+bool HassDiscoveryPublisher::claim()
+{
+    size_t index = _index++;
+    if (index < _cursor || _budgetExhausted) {
+        return false;
+    }
+
+    // at least one entity is handled per step, so every burst completes
+    if (_claimed > 0 && micros() - _stepStart > HASS_DISCOVERY_STEP_BUDGET_US) {
+        _budgetExhausted = true;
+        return false;
+    }
+
+    _claimed++;
+    _cursor++;
+    return true;
+}
+
+DynamicJsonDocument& HassDiscoveryPublisher::getDocument()
+{
+    if (!_doc) {
+        _doc = std::make_unique<DynamicJsonDocument>(HASS_DISCOVERY_JSON_DOC_SIZE);
+    }
+    _doc->clear();
+    return *_doc;
+}
+
+bool HassDiscoveryPublisher::isUnchanged(uint32_t topicHash, uint32_t payloadHash, bool retain) const
+{
+    // without retain the broker does not keep the configs for Home
+    // Assistant, they have to be sent on every connect
+    if (_force || !retain) {
+        return false;
+    }
+
+    auto it = _published.find(topicHash);
+    return it != _published.end() && it->second == payloadHash;
+}
+
+void HassDiscoveryPublisher::publish(const String& topic, const JsonDocument& doc, bool retain)
+{
+    size_t length = measureJson(doc);
+    _payload.resize(length);
+    serializeJson(doc, &_payload[0], length + 1);
+
+    send(topic, retain);
+}
+
+void HassDiscoveryPublisher::publish(const String& topic, const char* payload, bool retain)
+{
+    _payload = payload;
+
+    send(topic, retain);
+}
+
+void HassDiscoveryPublisher::send(const String& topic, bool retain)
+{
+    uint32_t topicHash = hash(topic.c_str());
+    uint32_t payloadHash = hash(_payload.c_str());
+    if (isUnchanged(topicHash, payloadHash, retain)) {
+        _statistics.Skipped++;
+        return;
+    }
+
+    if (!MqttSettings.publishGeneric(topic.c_str(), _payload.c_str(), retain)) {
+        // the client's outbox is full, retry this entity in the next step
+        _cursor--;
+        _budgetExhausted = true;
+        return;
+    }
+
+    _published[topicHash] = payloadHash;
+    _statistics.Published++;
+
+    _minFreeHeap = std::min(_minFreeHeap, ESP.getFreeHeap());
+}
@@ -7,42 +7,93 @@
 #include <Crypto.h>
 #include <SHA256.h>
 #include <base64.h>
-#include <memory>
+#include <algorithm>
+#include <iterator>
 
 void HttpPowerMeterClass::init()
 {
+    if (_taskHandle != nullptr) { return; }
+
+    for (uint8_t i = 0; i < POWERMETER_MAX_PHASES; i++) {
+        _pendingPower[i] = 0.0;
+    }
+
+    // TLS handshakes need a lot of stack
+    xTaskCreate(HttpPowerMeterClass::pollingLoopHelper, "HttpPowerMeter",
+            10240, this, 1, &_taskHandle);
+
+    if (_taskHandle == nullptr) {
+        MessageOutput.println("[HttpPowerMeter] Could not create polling task");
+    }
 }
 
-float HttpPowerMeterClass::getPower(int8_t phase)
+void HttpPowerMeterClass::requestUpdate()
 {
-    return power[phase - 1];
+    if (_taskHandle == nullptr) { return; }
+
+    // multiple requests while a poll is in progress collapse into one
+    xTaskNotifyGive(_taskHandle);
+}
+
+HttpPowerMeterClass::Reading HttpPowerMeterClass::getReading()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _reading;
+}
+
+void HttpPowerMeterClass::pollingLoopHelper(void* context)
+{
+    static_cast<HttpPowerMeterClass*>(context)->pollingLoop();
+}
+
+void HttpPowerMeterClass::pollingLoop()
+{
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        if (!updateValues()) { continue; }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reading.powerTotal = 0;
+        for (uint8_t i = 0; i < POWERMETER_MAX_PHASES; i++) {
+            _reading.power[i] = _pendingPower[i];
+            _reading.powerTotal += _pendingPower[i];
+        }
+        _reading.timestamp = millis();
+    }
 }
 
 bool HttpPowerMeterClass::updateValues()
 {
-    const CONFIG_T& config = Configuration.get();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto const& config = guard.getConfig();
+        std::copy(std::begin(config.Powermeter_Http_Phase), std::end(config.Powermeter_Http_Phase), _phaseConfig);
+        _individualRequests = config.PowerMeter_HttpIndividualRequests;
+    }
 
-    char response[2000],
-        errorMessage[256];
+    // released when this poll is done, the texts are not kept resident
+    auto http = Configuration.loadPowerMeterHttp();
 
     for (uint8_t i = 0; i < POWERMETER_MAX_PHASES; i++) {
-        POWERMETER_HTTP_PHASE_CONFIG_T phaseConfig = config.Powermeter_Http_Phase[i];
+        POWERMETER_HTTP_PHASE_CONFIG_T const& phaseConfig = _phaseConfig[i];
+        POWERMETER_HTTP_PHASE_TEXT_T const& phaseText = http->Phase[i];
 
         if (!phaseConfig.Enabled) {
-            power[i] = 0.0;
-            continue;	
-        } 
-
-        if (i == 0 || config.PowerMeter_HttpIndividualRequests) {
-            if (httpRequest(phaseConfig.Url, phaseConfig.AuthType, phaseConfig.Username, phaseConfig.Password, phaseConfig.HeaderKey, phaseConfig.HeaderValue, phaseConfig.Timeout,
-                response, sizeof(response), errorMessage, sizeof(errorMessage))) {
-                  if (!getFloatValueByJsonPath(response, phaseConfig.JsonPath, power[i])) {
-                      MessageOutput.printf("[HttpPowerMeter] Couldn't find a value with Json query \"%s\"\r\n", phaseConfig.JsonPath);
+            _pendingPower[i] = 0.0;
+            continue;
+        }
+
+        if (i == 0 || _individualRequests) {
+            if (httpRequest(_connections[i], phaseText.Url, phaseConfig.AuthType, phaseConfig.Username, phaseConfig.Password, phaseText.HeaderKey, phaseText.HeaderValue, phaseConfig.Timeout,
+                _response, sizeof(_response), _errorMessage, sizeof(_errorMessage))) {
+                  if (!getFloatValueByJsonPath(_response, phaseText.JsonPath, _pendingPower[i])) {
+                      MessageOutput.printf("[HttpPowerMeter] Couldn't find a value with Json query \"%s\"\r\n", phaseText.JsonPath);
                       return false;
                   }
             } else {
                 MessageOutput.printf("[HttpPowerMeter] Getting the power of phase %d failed. Error: %s\r\n",
-                    i + 1, errorMessage);
+                    i + 1, _errorMessage);
                 return false;
             }
         }
@@ -53,6 +104,44 @@ bool HttpPowerMeterClass::updateValues()
 
 bool HttpPowerMeterClass::httpRequest(const char* url, Auth authType, const char* username, const char* password, const char* httpHeader, const char* httpValue, uint32_t timeout,
         char* response, size_t responseSize, char* error, size_t errorSize)
+{
+    HttpConnection connection;
+    bool success = httpRequest(connection, url, authType, username, password, httpHeader, httpValue, timeout,
+        response, responseSize, error, errorSize);
+
+    if (connection.wifiClient) { connection.wifiClient->stop(); }
+
+    return success;
+}
+
+bool HttpPowerMeterClass::beginRequest(HttpConnection& connection, const char* url, uint32_t timeout, const char* httpHeader, const char* httpValue)
+{
+    HTTPClient& httpClient = connection.httpClient;
+
+    if (!httpClient.begin(*connection.wifiClient, url)) {
+        return false;
+    }
+
+    httpClient.setReuse(true);
+    httpClient.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+    httpClient.setUserAgent("OpenDTU-OnBattery");
+    httpClient.setConnectTimeout(timeout);
+    httpClient.setTimeout(timeout);
+    httpClient.addHeader("Content-Type", "application/json");
+    httpClient.addHeader("Accept", "application/json");
+
+    if (strlen(httpHeader) > 0) {
+        httpClient.addHeader(httpHeader, httpValue);
+    }
+
+    const char *headers[1] = {"WWW-Authenticate"};
+    httpClient.collectHeaders(headers, 1);
+
+    return true;
+}
+
+bool HttpPowerMeterClass::httpRequest(HttpConnection& connection, const char* url, Auth authType, const char* username, const char* password, const char* httpHeader, const char* httpValue, uint32_t timeout,
+        char* response, size_t responseSize, char* error, size_t errorSize)
 {
     String urlProtocol;
     String urlHostname;
@@ -62,28 +151,32 @@ bool HttpPowerMeterClass::httpRequest(const char* url, Auth authType, const char
     response[0] = '\0';
     error[0] = '\0';
 
-    // secureWifiClient MUST be created before HTTPClient
+    // the WiFiClient MUST outlive the HTTPClient using it
     // see discussion: https://github.com/helgeerbe/OpenDTU-OnBattery/issues/381
-    std::unique_ptr<WiFiClient> wifiClient;
-
-    if (urlProtocol == "https") {
-      auto secureWifiClient = std::make_unique<WiFiClientSecure>();
-      secureWifiClient->setInsecure();
-      wifiClient = std::move(secureWifiClient);
-    } else {
-      wifiClient = std::make_unique<WiFiClient>();
+    // it is kept across requests so the TCP connection (and TLS session) can
+    // be reused if the server supports keep-alive.
+    bool secure = (urlProtocol == "https");
+    if (!connection.wifiClient || connection.secure != secure) {
+        if (secure) {
+            auto secureWifiClient = std::make_unique<WiFiClientSecure>();
+            secureWifiClient->setInsecure();
+            connection.wifiClient = std::move(secureWifiClient);
+        } else {
+            connection.wifiClient = std::make_unique<WiFiClient>();
+        }
+        connection.secure = secure;
     }
 
-   
-    if (!httpClient.begin(*wifiClient, url)) {
-      snprintf_P(error, errorSize, "httpClient.begin(%s) failed", url);
-      return false;
+    HTTPClient& httpClient = connection.httpClient;
+
+    if (!beginRequest(connection, url, timeout, httpHeader, httpValue)) {
+        snprintf_P(error, errorSize, "httpClient.begin(%s) failed", url);
+        return false;
     }
-    prepareRequest(timeout, httpHeader, httpValue);
-    
-    if (authType == Auth::digest) {
-        const char *headers[1] = {"WWW-Authenticate"};
-        httpClient.collectHeaders(headers, 1);
+
+    if (authType == Auth::digest && connection.digestNonce.length() > 0) {
+        // answer the challenge we received before right away
+        httpClient.addHeader("Authorization", getDigestAuthorization(connection, urlUri, username, password));
     } else if (authType == Auth::basic) {
         String authString = username;
         authString += ":";
@@ -95,64 +188,17 @@ bool HttpPowerMeterClass::httpRequest(const char* url, Auth authType, const char
 
     int httpCode = httpClient.GET();
     if (httpCode == HTTP_CODE_UNAUTHORIZED && authType == Auth::digest) {
-        // Handle authentication challenge
-        char realm[256];  // Buffer to store the realm received from the server
-        char nonce[256];  // Buffer to store the nonce received from the server
-        if (httpClient.hasHeader("WWW-Authenticate")) {
-            String authHeader = httpClient.header("WWW-Authenticate");
-            if (authHeader.indexOf("Digest") != -1) {
-                int realmIndex = authHeader.indexOf("realm=\"");
-                int nonceIndex = authHeader.indexOf("nonce=\"");
-                if (realmIndex != -1 && nonceIndex != -1) {
-                    int realmEndIndex = authHeader.indexOf("\"", realmIndex + 7);
-                    int nonceEndIndex = authHeader.indexOf("\"", nonceIndex + 7);
-                    if (realmEndIndex != -1 && nonceEndIndex != -1) {
-                        authHeader.substring(realmIndex + 7, realmEndIndex).toCharArray(realm, sizeof(realm));
-                        authHeader.substring(nonceIndex + 7, nonceEndIndex).toCharArray(nonce, sizeof(nonce));
-                    }
-                }
-                String cnonce = String(random(1000)); // Generate client nonce
-                String str = username;
-                str += ":";
-                str += realm;
-                str += ":";
-                str += password;
-                String ha1 = sha256(str);
-                str = "GET:";
-                str += urlUri;
-                String ha2 = sha256(str);
-                str = ha1;
-                str += ":";
-                str += nonce;
-                str +=  ":00000001:";
-                str += cnonce;
-                str += ":auth:";
-                str +=  ha2;
-                String response = sha256(str);
-
-                String authorization = "Digest username=\""; 
-                authorization += username;
-                authorization += "\", realm=\"";
-                authorization += realm;
-                authorization += "\", nonce=\"";
-                authorization += nonce;
-                authorization += "\", uri=\"";
-                authorization += urlUri;
-                authorization += "\", cnonce=\"";
-                authorization += cnonce;
-                authorization += "\", nc=00000001, qop=auth, response=\"";
-                authorization += response;
-                authorization += "\", algorithm=SHA-256";
-                httpClient.end();
-                if (!httpClient.begin(*wifiClient, url)) {
-                    snprintf_P(error, errorSize, "httpClient.begin(%s) for digest auth failed", url);
-                    return false;
-                }
-                prepareRequest(timeout, httpHeader, httpValue);
-                httpClient.addHeader("Authorization", authorization);
-                httpCode = httpClient.GET();
+        // no or stale nonce: handle authentication challenge
+        if (parseDigestChallenge(connection)) {
+            String authorization = getDigestAuthorization(connection, urlUri, username, password);
+            httpClient.end();
+            if (!beginRequest(connection, url, timeout, httpHeader, httpValue)) {
+                snprintf_P(error, errorSize, "httpClient.begin(%s) for digest auth failed", url);
+                return false;
             }
-        }        
+            httpClient.addHeader("Authorization", authorization);
+            httpCode = httpClient.GET();
+        }
     }
 
     if (httpCode == HTTP_CODE_OK) {
@@ -170,15 +216,89 @@ bool HttpPowerMeterClass::httpRequest(const char* url, Auth authType, const char
         snprintf_P(error, errorSize, "Bad HTTP code: %d", httpCode);
     }
 
+    // keeps the connection open if the server allows it
     httpClient.end();
 
     if (error[0] != '\0') {
+        // start over with a fresh connection and challenge next time
+        connection.wifiClient->stop();
+        connection.digestNonce.clear();
         return false;
     }
 
     return true;
 }
 
+bool HttpPowerMeterClass::parseDigestChallenge(HttpConnection& connection)
+{
+    HTTPClient& httpClient = connection.httpClient;
+
+    connection.digestRealm.clear();
+    connection.digestNonce.clear();
+    connection.digestNonceCount = 0;
+
+    if (!httpClient.hasHeader("WWW-Authenticate")) { return false; }
+
+    String authHeader = httpClient.header("WWW-Authenticate");
+    if (authHeader.indexOf("Digest") == -1) { return false; }
+
+    int realmIndex = authHeader.indexOf("realm=\"");
+    int nonceIndex = authHeader.indexOf("nonce=\"");
+    if (realmIndex == -1 || nonceIndex == -1) { return false; }
+
+    int realmEndIndex = authHeader.indexOf("\"", realmIndex + 7);
+    int nonceEndIndex = authHeader.indexOf("\"", nonceIndex + 7);
+    if (realmEndIndex == -1 || nonceEndIndex == -1) { return false; }
+
+    connection.digestRealm = authHeader.substring(realmIndex + 7, realmEndIndex);
+    connection.digestNonce = authHeader.substring(nonceIndex + 7, nonceEndIndex);
+    return true;
+}
+
+String HttpPowerMeterClass::getDigestAuthorization(HttpConnection& connection, const String& uri, const char* username, const char* password)
+{
+    char nc[9];
+    snprintf(nc, sizeof(nc), "%08x", ++connection.digestNonceCount);
+
+    String cnonce = String(random(1000)); // Generate client nonce
+    String str = username;
+    str += ":";
+    str += connection.digestRealm;
+    str += ":";
+    str += password;
+    String ha1 = sha256(str);
+    str = "GET:";
+    str += uri;
+    String ha2 = sha256(str);
+    str = ha1;
+    str += ":";
+    str += connection.digestNonce;
+    str += ":";
+    str += nc;
+    str += ":";
+    str += cnonce;
+    str += ":auth:";
+    str += ha2;
+    String response = sha256(str);
+
+    String authorization = "Digest username=\"";
+    authorization += username;
+    authorization += "\", realm=\"";
+    authorization += connection.digestRealm;
+    authorization += "\", nonce=\"";
+    authorization += connection.digestNonce;
+    authorization += "\", uri=\"";
+    authorization += uri;
+    authorization += "\", cnonce=\"";
+    authorization += cnonce;
+    authorization += "\", nc=";
+    authorization += nc;
+    authorization += ", qop=auth, response=\"";
+    authorization += response;
+    authorization += "\", algorithm=SHA-256";
+    return authorization;
+}
+
 float HttpPowerMeterClass::getFloatValueByJsonPath(const char* jsonString, const char* jsonPath, float& value)
 {
     FirebaseJson firebaseJson;
@@ -248,17 +368,4 @@ String HttpPowerMeterClass::sha256(const String& data) {
   return hashStr;
 }
 
-void HttpPowerMeterClass::prepareRequest(uint32_t timeout, const char* httpHeader, const char* httpValue) {
-    httpClient.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-    httpClient.setUserAgent("OpenDTU-OnBattery");
-    httpClient.setConnectTimeout(timeout);
-    httpClient.setTimeout(timeout);
-    httpClient.addHeader("Content-Type", "application/json");
-    httpClient.addHeader("Accept", "application/json");
-
-    if (strlen(httpHeader) > 0) {
-        httpClient.addHeader(httpHeader, httpValue);
-    }
-}
-
 HttpPowerMeterClass HttpPowerMeter;
@@ -215,9 +215,11 @@ void HuaweiCanClass::loop()
       _autoPowerEnabled = 10;
     }
 
+    auto powerMeter = PowerMeter.getSample();
+
     if ((PowerLimiter.getPowerLimiterState() == PL_UI_STATE_INACTIVE ||
         PowerLimiter.getPowerLimiterState() == PL_UI_STATE_CHARGING) && 
-        PowerMeter.getLastPowerMeterUpdate() > _lastPowerMeterUpdateReceivedMillis &&
+        powerMeter.timestamp > _lastPowerMeterUpdateReceivedMillis &&
         _newOutputPowerReceived && 
         _autoPowerEnabled > 0) {
         // Power Limiter is inactive and we have received both: 
@@ -225,10 +227,10 @@ void HuaweiCanClass::loop()
         // So we're good to calculate a new limit
 
       _newOutputPowerReceived = false;
-      _lastPowerMeterUpdateReceivedMillis = PowerMeter.getLastPowerMeterUpdate();
+      _lastPowerMeterUpdateReceivedMillis = powerMeter.timestamp;
 
       // Calculate new power limit
-      float newPowerLimit = -1 * round(PowerMeter.getPowerTotal());
+      float newPowerLimit = -1 * round(powerMeter.powerTotal);
       newPowerLimit += _rp.output_power;
       MessageOutput.printf("[HuaweiCanClass::loop] PL: %f, OP: %f \r\n", newPowerLimit, _rp.output_power);
 
@@ -58,12 +58,13 @@ void LedSingleClass::loop()
 
         // Update inverter status
         _ledState[1] = LedState_t::Off;
-        if (Hoymiles.getNumInverters() && Datastore.getIsAtLeastOnePollEnabled()) {
+        auto totals = Datastore.getSnapshot();
+        if (Hoymiles.getNumInverters() && totals.isAtLeastOnePollEnabled) {
             // set LED status
-            if (Datastore.getIsAllEnabledReachable() && Datastore.getIsAllEnabledProducing()) {
+            if (totals.isAllEnabledReachable && totals.isAllEnabledProducing) {
                 _ledState[1] = LedState_t::On;
             }
-            if (Datastore.getIsAllEnabledReachable() && !Datastore.getIsAllEnabledProducing()) {
+            if (totals.isAllEnabledReachable && !totals.isAllEnabledProducing) {
                 _ledState[1] = LedState_t::Blink;
             }
         }
@@ -0,0 +1,299 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#include "LiveDataPublisher.h"
+#include <algorithm>
+#include <cstring>
+
+static constexpr char PROTOCOL_REQUEST[] = "protocol:2";
+static constexpr char RESYNC_REQUEST[] = "resync";
+
+LiveDataPublisher::LiveDataPublisher(AsyncWebSocket& ws)
+    : _ws(ws)
+{
+}
+
+size_t LiveDataPublisher::BufferWriter::write(uint8_t c)
+{
+    _buffer.push_back(c);
+    return 1;
+}
+
+size_t LiveDataPublisher::BufferWriter::write(const uint8_t* s, size_t n)
+{
+    _buffer.insert(_buffer.end(), s, s + n);
+    return n;
+}
+
+size_t LiveDataPublisher::BufferWriter::print(const char* s)
+{
+    return write(reinterpret_cast<const uint8_t*>(s), strlen(s));
+}
+
+size_t LiveDataPublisher::HashWriter::write(uint8_t c)
+{
+    hash = (hash ^ c) * 16777619u;
+    return 1;
+}
+
+size_t LiveDataPublisher::HashWriter::write(const uint8_t* s, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        write(s[i]);
+    }
+    return n;
+}
+
+void LiveDataPublisher::onWebsocketEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (type == WS_EVT_CONNECT) {
+        _clients[client->id()] = ClientState();
+        return;
+    }
+
+    if (type == WS_EVT_DISCONNECT) {
+        _clients.erase(client->id());
+        return;
+    }
+
+    if (type != WS_EVT_DATA) {
+        return;
+    }
+
+    // requests are short, only single frame text messages are considered
+    AwsFrameInfo* info = static_cast<AwsFrameInfo*>(arg);
+    if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_TEXT) {
+        return;
+    }
+
+    auto it = _clients.find(client->id());
+    if (it == _clients.end()) {
+        return;
+    }
+
+    if (len == strlen(PROTOCOL_REQUEST) && !memcmp(data, PROTOCOL_REQUEST, len)) {
+        it->second.delta = true;
+        it->second.snapshotPending = true;
+        _publishRequested = true;
+    } else if (len == strlen(RESYNC_REQUEST) && !memcmp(data, RESYNC_REQUEST, len) && it->second.delta) {
+        it->second.snapshotPending = true;
+        _publishRequested = true;
+    }
+}
+
+template <typename Visitor>
+void LiveDataPublisher::visitLeaves(JsonVariantConst var, char* path, size_t pathLen, size_t pathSize, Visitor& visitor)
+{
+    if (var.is<JsonObjectConst>()) {
+        for (JsonPairConst kv : var.as<JsonObjectConst>()) {
+            int len = snprintf(path + pathLen, pathSize - pathLen, "/%s", kv.key().c_str());
+            visitLeaves(kv.value(), path, std::min(pathLen + len, pathSize - 1), pathSize, visitor);
+        }
+        path[pathLen] = '\0';
+        return;
+    }
+
+    if (var.is<JsonArrayConst>()) {
+        size_t index = 0;
+        for (JsonVariantConst element : var.as<JsonArrayConst>()) {
+            int len = snprintf(path + pathLen, pathSize - pathLen, "/%u", static_cast<unsigned>(index++));
+            visitLeaves(element, path, std::min(pathLen + len, pathSize - 1), pathSize, visitor);
+        }
+        path[pathLen] = '\0';
+        return;
+    }
+
+    visitor(path, var);
+}
+
+bool LiveDataPublisher::updateLeaves(JsonVariantConst root, BufferWriter& delta, size_t& changes)
+{
+    HashWriter structure;
+    size_t index = 0;
+    bool structureChanged = !_baselineValid;
+
+    changes = 0;
+
+    // hashes every leaf and appends the changed ones to the delta, a single
+    // walk over the document. the delta is discarded if the leaves changed.
+    auto visitor = [&](char const* path, JsonVariantConst leaf) {
+        structure.write(reinterpret_cast<const uint8_t*>(path), strlen(path) + 1);
+
+        HashWriter value;
+        serializeJson(leaf, value);
+
+        if (index >= _leafHashes.size()) {
+            _leafHashes.push_back(value.hash);
+            structureChanged = true;
+        } else if (_leafHashes[index] != value.hash) {
+            _leafHashes[index] = value.hash;
+            if (!structureChanged) {
+                char id[16];
+                snprintf(id, sizeof(id), "%s[%u,", changes == 0 ? "" : ",", static_cast<unsigned>(index));
+                delta.print(id);
+                serializeJson(leaf, delta);
+                delta.write(']');
+                changes++;
+            }
+        }
+        index++;
+    };
+
+    char path[128] = "";
+    visitLeaves(root, path, 0, sizeof(path), visitor);
+
+    if (index != _leafHashes.size()) {
+        _leafHashes.resize(index);
+        structureChanged = true;
+    }
+
+    if (structure.hash != _structureHash) {
+        _structureHash = structure.hash;
+        structureChanged = true;
+    }
+
+    _baselineValid = true;
+    return structureChanged;
+}
+
+void LiveDataPublisher::writeSnapshot(JsonVariantConst root, buffer_t& buffer)
+{
+    BufferWriter writer(buffer);
+    char header[96];
+    snprintf(header, sizeof(header), "{\"protocol\":%u,\"type\":\"snapshot\",\"snapshot\":%u,\"seq\":%u,\"ids\":[",
+        PROTOCOL_VERSION, static_cast<unsigned>(_snapshotId), static_cast<unsigned>(_sequence));
+    writer.print(header);
+
+    bool first = true;
+    auto visitor = [&](char const* path, JsonVariantConst) {
+        if (!first) {
+            writer.write(',');
+        }
+        first = false;
+
+        // keys are generated by the firmware and never need to be escaped
+        writer.write('"');
+        writer.print(path);
+        writer.write('"');
+    };
+
+    char path[128] = "";
+    visitLeaves(root, path, 0, sizeof(path), visitor);
+
+    writer.print("],\"data\":");
+    serializeJson(root, writer);
+    writer.write('}');
+}
+
+std::shared_ptr<LiveDataPublisher::buffer_t> LiveDataPublisher::acquire(buffer_pool_t& pool)
+{
+    for (auto& buffer : pool) {
+        if (!buffer) {
+            buffer = std::make_shared<buffer_t>();
+        }
+        if (buffer.use_count() == 1) {
+            buffer->clear();
+            return buffer;
+        }
+    }
+    return nullptr;
+}
+
+void LiveDataPublisher::publish(JsonVariantConst root)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _publishRequested = false;
+        _lastPublishBytes = 0;
+
+        bool hasFullClients = false;
+        bool hasDeltaClients = false;
+        for (auto const& client : _clients) {
+            hasFullClients |= !client.second.delta;
+            hasDeltaClients |= client.second.delta;
+        }
+
+        // if all buffers of a type are still queued, the clients skip this
+        // publish and get the next one
+        std::shared_ptr<buffer_t> fullBuffer;
+        if (hasFullClients && (fullBuffer = acquire(_fullBuffers))) {
+            BufferWriter writer(*fullBuffer);
+            serializeJson(root, writer);
+            _lastPublishBytes += fullBuffer->size();
+        }
+
+        std::shared_ptr<buffer_t> deltaBuffer;
+        bool sendDelta = false;
+        bool hasSnapshotClients = false;
+        if (hasDeltaClients) {
+            // without a buffer the baseline is kept, the next delta then
+            // contains these changes as well
+            if ((deltaBuffer = acquire(_deltaBuffers))) {
+                BufferWriter delta(*deltaBuffer);
+                char header[96];
+                snprintf(header, sizeof(header), "{\"protocol\":%u,\"type\":\"delta\",\"snapshot\":%u,\"seq\":%u,\"changes\":[",
+                    PROTOCOL_VERSION, static_cast<unsigned>(_snapshotId), static_cast<unsigned>(_sequence + 1));
+                delta.print(header);
+
+                size_t changes;
+                if (updateLeaves(root, delta, changes)) {
+                    // the ids of the previous snapshot are no longer valid
+                    _snapshotId++;
+                    _sequence++;
+                    for (auto& client : _clients) {
+                        client.second.snapshotPending = client.second.delta;
+                    }
+                } else if (changes > 0) {
+                    delta.print("]}");
+                    _sequence++;
+                    _lastPublishBytes += deltaBuffer->size();
+                    sendDelta = true;
+                }
+            }
+
+            for (auto const& client : _clients) {
+                hasSnapshotClients |= client.second.snapshotPending;
+            }
+        } else {
+            // nobody tracks the current baseline, start over with a snapshot
+            _baselineValid = false;
+        }
+
+        std::shared_ptr<buffer_t> snapshotBuffer;
+        if (hasSnapshotClients) {
+            if ((snapshotBuffer = acquire(_snapshotBuffers))) {
+                writeSnapshot(root, *snapshotBuffer);
+                _lastPublishBytes += snapshotBuffer->size();
+            } else {
+                _publishRequested = true;
+            }
+        }
+
+        for (auto& client : _clients) {
+            if (!client.second.delta) {
+                if (fullBuffer) {
+                    _outbox.emplace_back(client.first, fullBuffer);
+                }
+            } else if (client.second.snapshotPending) {
+                if (snapshotBuffer) {
+                    _outbox.emplace_back(client.first, snapshotBuffer);
+                    client.second.snapshotPending = false;
+                }
+            } else if (sendDelta) {
+                _outbox.emplace_back(client.first, deltaBuffer);
+            }
+        }
+    }
+
+    for (auto& message : _outbox) {
+        AsyncWebSocketClient* client = _ws.client(message.first);
+        if (client != nullptr && client->status() == WS_CONNECTED) {
+            client->text(message.second);
+        }
+    }
+    _outbox.clear();
+}
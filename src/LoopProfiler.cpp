@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#include "LoopProfiler.h"
+#include <algorithm>
+
+LoopProfilerClass LoopProfiler;
+
+static const char* const SECTION_NAMES[] = {
+    "NetworkSettings",
+    "PowerMeter",
+    "PowerLimiter",
+    "InverterSettings",
+    "Datastore",
+    "VeDirectMppt",
+    "MqttSettings",
+    "MqttHandleDtu",
+    "MqttHandleInverter",
+    "MqttHandleInverterTotal",
+    "MqttHandleVedirect",
+    "MqttHandleHass",
+    "MqttHandleVedirectHass",
+    "MqttHandleHuawei",
+    "MqttHandlePowerLimiter",
+    "WebApi",
+    "Display",
+    "SunPosition",
+    "MessageOutput",
+    "Battery",
+    "MqttHandlePylontechHass",
+    "HuaweiCan",
+    "LedSingle",
+    "Configuration",
+    "Yield",
+};
+
+static_assert(sizeof(SECTION_NAMES) / sizeof(SECTION_NAMES[0]) == LoopProfilerClass::SECTION_COUNT,
+    "every section needs a name");
+
+void LoopProfilerClass::Histogram::add(uint32_t us)
+{
+    // index of the highest bit set plus one, i.e. the smallest i with us < 2^i
+    size_t bucket = (us == 0) ? 0 : 32 - __builtin_clz(us);
+    buckets[std::min(bucket, BUCKET_COUNT - 1)]++;
+
+    count++;
+    sumUs += us;
+    minUs = std::min(minUs, us);
+    maxUs = std::max(maxUs, us);
+}
+
+uint32_t LoopProfilerClass::Histogram::getPercentileUs(uint8_t percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (static_cast<uint64_t>(count) * percentile + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT - 1; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(getBucketBoundUs(i), maxUs);
+        }
+    }
+    return maxUs;
+}
+
+uint32_t LoopProfilerClass::getBucketBoundUs(size_t bucket)
+{
+    return (bucket < BUCKET_COUNT - 1) ? (1UL << bucket) : UINT32_MAX;
+}
+
+const char* LoopProfilerClass::getSectionName(Section section)
+{
+    return SECTION_NAMES[static_cast<size_t>(section)];
+}
+
+std::unique_ptr<LoopProfilerClass::Window> LoopProfilerClass::getLastWindow() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::make_unique<Window>(_lastWindow);
+}
+
+LoopProfilerClass::Total LoopProfilerClass::getTotal(Section section) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _totals[static_cast<size_t>(section)];
+}
+
+LoopProfilerClass::Total LoopProfilerClass::getLoopTotal() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _loopTotal;
+}
+
+void LoopProfilerClass::completeWindow(uint32_t now)
+{
+    _window.durationMs = (now - _windowStart) / 1000;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (size_t i = 0; i < SECTION_COUNT; i++) {
+            _totals[i].sumUs += _window.sections[i].sumUs;
+            _totals[i].count += _window.sections[i].count;
+        }
+        _loopTotal.sumUs += _window.loop.sumUs;
+        _loopTotal.count += _window.loop.count;
+
+        _window.number = _lastWindow.number + 1;
+        _lastWindow = _window;
+    }
+
+    _window = Window();
+    _windowStart = now;
+}
+
+void LoopProfilerClass::startLoop()
+{
+    uint32_t now = micros();
+
+    if (_running) {
+        _window.loop.add(now - _loopStart);
+        _loopsThisSecond++;
+    } else {
+        _secondStart = now;
+        _windowStart = now;
+        _running = true;
+    }
+
+    if (now - _windowStart >= WINDOW_US) {
+        completeWindow(now);
+    }
+
+    if (now - _secondStart >= 1000000) {
+        _loopsPerSecond = _loopsThisSecond;
+        _loopsThisSecond = 0;
+        _secondStart = now;
+    }
+
+    _loopStart = now;
+    _checkpoint = now;
+}
+
+void LoopProfilerClass::record(Section section, uint32_t now)
+{
+    uint32_t us = now - _checkpoint;
+    _checkpoint = now;
+
+    _window.sections[static_cast<size_t>(section)].add(us);
+
+    if (us > _window.stallUs) {
+        _window.stallUs = us;
+        _window.stallSection = section;
+    }
+}
+
+void LoopProfilerClass::endSection(Section section)
+{
+    record(section, micros());
+    yield();
+    record(Section::Yield, micros());
+}
@@ -4,74 +4,151 @@
  */
 #include <HardwareSerial.h>
 #include "MessageOutput.h"
+#include <algorithm>
+#include <cstring>
 
 MessageOutputClass MessageOutput;
 
-void MessageOutputClass::register_ws_output(AsyncWebSocket* output)
+// maximum size of a websocket message combining several lines
+static constexpr size_t WS_MESSAGE_SIZE = 1024;
+
+void MessageOutputClass::init()
 {
-    std::lock_guard<std::mutex> lock(_msgLock);
+    if (_taskHandle != nullptr) { return; }
 
-    _ws = output;
+    xTaskCreate(MessageOutputClass::outputLoopHelper, "MessageOutput",
+            4096, this, 1, &_taskHandle);
+
+    if (_taskHandle == nullptr) {
+        Serial.println("[MessageOutput] Could not create output task");
+        return;
+    }
+
+    // output whatever was written before the task existed
+    xTaskNotifyGive(_taskHandle);
 }
 
-void MessageOutputClass::serialWrite(MessageOutputClass::message_t const& m)
+void MessageOutputClass::register_ws_output(AsyncWebSocket* output)
 {
-    // on ESP32-S3, Serial.flush() blocks until a serial console is attached.
-    // operator bool() of HWCDC returns false if the device is not attached to
-    // a USB host. in general it makes sense to skip writing entirely if the
-    // default serial port is not ready.
-    if (!Serial) { return; }
+    _ws = output;
+}
 
-    size_t written = 0;
-    while (written < m.size()) {
-        written += Serial.write(m.data() + written, m.size() - written);
+void MessageOutputClass::requestHistory(uint32_t clientId)
+{
+    {
+        std::lock_guard<std::mutex> lock(_msgLock);
+        _historyClients.push_back(clientId);
     }
-    Serial.flush();
+
+    if (_taskHandle != nullptr) { xTaskNotifyGive(_taskHandle); }
 }
 
-size_t MessageOutputClass::write(uint8_t c)
+void MessageOutputClass::LineRing::copyIn(uint8_t* buffer, size_t pos, const uint8_t* data, size_t len)
 {
-    std::lock_guard<std::mutex> lock(_msgLock);
+    size_t offset = pos % _size;
+    size_t first = std::min(len, _size - offset);
+    memcpy(buffer + offset, data, first);
+    memcpy(buffer, data + first, len - first);
+}
 
-    auto res = _task_messages.emplace(xTaskGetCurrentTaskHandle(), message_t());
-    auto iter = res.first;
-    auto& message = iter->second;
+void MessageOutputClass::LineRing::copyOut(const uint8_t* buffer, size_t pos, uint8_t* data, size_t len) const
+{
+    size_t offset = pos % _size;
+    size_t first = std::min(len, _size - offset);
+    memcpy(data, buffer + offset, first);
+    memcpy(data + first, buffer, len - first);
+}
+
+size_t MessageOutputClass::LineRing::peekLength(const uint8_t* buffer) const
+{
+    uint8_t len[2];
+    copyOut(buffer, _tail, len, sizeof(len));
+    return len[0] | (len[1] << 8);
+}
+
+bool MessageOutputClass::LineRing::push(uint8_t* buffer, const uint8_t* line, size_t len)
+{
+    if (available() < len + 2) { return false; }
+
+    uint8_t header[2] = { static_cast<uint8_t>(len), static_cast<uint8_t>(len >> 8) };
+    copyIn(buffer, _head, header, sizeof(header));
+    copyIn(buffer, _head + sizeof(header), line, len);
+    _head += sizeof(header) + len;
+    return true;
+}
+
+size_t MessageOutputClass::LineRing::pop(const uint8_t* buffer, uint8_t* line)
+{
+    if (empty()) { return 0; }
+
+    size_t len = peekLength(buffer);
+    copyOut(buffer, _tail + 2, line, len);
+    _tail += 2 + len;
+    return len;
+}
+
+void MessageOutputClass::LineRing::dropOldest(const uint8_t* buffer)
+{
+    if (empty()) { return; }
 
-    message.push_back(c);
+    _tail += 2 + peekLength(buffer);
+}
 
-    if (c == '\n') {
-        serialWrite(message);
-        _lines.emplace(std::move(message));
-        _task_messages.erase(iter);
+MessageOutputClass::PendingLine* MessageOutputClass::getPendingLine(TaskHandle_t task)
+{
+    PendingLine* free = nullptr;
+    for (auto& line : _pendingLines) {
+        if (line.task == task) { return &line; }
+        if (line.task == nullptr && free == nullptr) { free = &line; }
     }
 
-    return 1;
+    if (free != nullptr) { free->task = task; }
+    return free;
+}
+
+void MessageOutputClass::commit(const uint8_t* data, size_t len)
+{
+    if (!_lines.push(_buffer, data, len)) { _droppedLines++; }
+}
+
+size_t MessageOutputClass::write(uint8_t c)
+{
+    return write(&c, 1);
 }
 
 size_t MessageOutputClass::write(const uint8_t *buffer, size_t size)
 {
-    std::lock_guard<std::mutex> lock(_msgLock);
+    bool committed = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_msgLock);
 
-    auto res = _task_messages.emplace(xTaskGetCurrentTaskHandle(), message_t());
-    auto iter = res.first;
-    auto& message = iter->second;
+        PendingLine* line = getPendingLine(xTaskGetCurrentTaskHandle());
 
-    message.reserve(message.size() + size);
+        if (line == nullptr) {
+            // too many tasks with partial lines, pass the text on as is
+            for (size_t idx = 0; idx < size; idx += LINE_SIZE) {
+                commit(buffer + idx, std::min(LINE_SIZE, size - idx));
+            }
+            committed = true;
+        } else {
+            for (size_t idx = 0; idx < size; ++idx) {
+                uint8_t c = buffer[idx];
 
-    for (size_t idx = 0; idx < size; ++idx) {
-        uint8_t c = buffer[idx];
+                line->data[line->len++] = c;
 
-        message.push_back(c);
+                if (c == '\n' || line->len == LINE_SIZE) {
+                    commit(line->data, line->len);
+                    line->len = 0;
+                    committed = true;
+                }
+            }
 
-        if (c == '\n') {
-            serialWrite(message);
-            _lines.emplace(std::move(message));
-            message.clear();
-            message.reserve(size - idx - 1);
+            if (line->len == 0) { line->task = nullptr; }
         }
     }
 
-    if (message.empty()) { _task_messages.erase(iter); }
+    if (committed && _taskHandle != nullptr) { xTaskNotifyGive(_taskHandle); }
 
     return size;
 }
@@ -81,25 +158,120 @@ void MessageOutputClass::loop()
     std::lock_guard<std::mutex> lock(_msgLock);
 
     // clean up (possibly filled) buffers of deleted tasks
-    auto map_iter = _task_messages.begin();
-    while (map_iter != _task_messages.end()) {
-        if (eTaskGetState(map_iter->first) == eDeleted) {
-            map_iter = _task_messages.erase(map_iter);
-            continue;
+    for (auto& line : _pendingLines) {
+        if (line.task != nullptr && eTaskGetState(line.task) == eDeleted) {
+            line.task = nullptr;
+            line.len = 0;
         }
+    }
+}
+
+void MessageOutputClass::serialWrite(const uint8_t* data, size_t len)
+{
+    // on ESP32-S3, Serial.flush() blocks until a serial console is attached.
+    // operator bool() of HWCDC returns false if the device is not attached to
+    // a USB host. in general it makes sense to skip writing entirely if the
+    // default serial port is not ready.
+    if (!Serial) { return; }
+
+    size_t written = 0;
+    while (written < len) {
+        written += Serial.write(data + written, len - written);
+    }
+}
+
+void MessageOutputClass::appendHistory(const uint8_t* line, size_t len)
+{
+    while (!_historyLines.push(_history, line, len)) {
+        _historyLines.dropOldest(_history);
+    }
+}
+
+void MessageOutputClass::sendHistory(AsyncWebSocket* ws)
+{
+    std::vector<uint32_t> clients;
+    {
+        std::lock_guard<std::mutex> lock(_msgLock);
+        std::swap(clients, _historyClients);
+    }
+
+    if (clients.empty() || ws == nullptr || _historyLines.empty()) { return; }
 
-        ++map_iter;
+    // copy the history without consuming it
+    LineRing history = _historyLines;
+    auto message = std::make_shared<message_t>();
+    message->reserve(HISTORY_SIZE);
+    uint8_t line[LINE_SIZE];
+    size_t len;
+    while ((len = history.pop(_history, line)) > 0) {
+        message->insert(message->end(), line, line + len);
     }
 
-    if (!_ws) {
-        while (!_lines.empty()) {
-            _lines.pop(); // do not hog memory
+    for (uint32_t id : clients) {
+        AsyncWebSocketClient* client = ws->client(id);
+        if (client != nullptr && client->status() == WS_CONNECTED) {
+            client->text(message);
         }
-        return;
     }
+}
+
+void MessageOutputClass::outputLoopHelper(void* context)
+{
+    auto pInstance = static_cast<MessageOutputClass*>(context);
+    pInstance->outputLoop();
+}
+
+void MessageOutputClass::sendToWs(AsyncWebSocket* ws, std::shared_ptr<message_t>& message, uint32_t& lines)
+{
+    if (ws->availableForWriteAll()) {
+        ws->textAll(message);
+    } else {
+        _droppedWsLines += lines;
+    }
+    message.reset();
+    lines = 0;
+}
 
-    while (!_lines.empty() && _ws->availableForWriteAll()) {
-        _ws->textAll(std::make_shared<message_t>(std::move(_lines.front())));
-        _lines.pop();
+void MessageOutputClass::outputLoop()
+{
+    uint8_t line[LINE_SIZE];
+    std::shared_ptr<message_t> message;
+    uint32_t messageLines = 0;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        AsyncWebSocket* ws = _ws;
+        sendHistory(ws);
+
+        while (true) {
+            size_t len;
+            {
+                std::lock_guard<std::mutex> lock(_msgLock);
+                len = _lines.pop(_buffer, line);
+            }
+            if (len == 0) { break; }
+
+            serialWrite(line, len);
+            appendHistory(line, len);
+
+            if (ws == nullptr || ws->count() == 0) { continue; }
+
+            // several lines are combined into one websocket message
+            if (!message) {
+                message = std::make_shared<message_t>();
+                message->reserve(WS_MESSAGE_SIZE);
+            }
+            message->insert(message->end(), line, line + len);
+            messageLines++;
+
+            if (message->size() + LINE_SIZE > WS_MESSAGE_SIZE) {
+                sendToWs(ws, message, messageLines);
+            }
+        }
+
+        if (message) {
+            sendToWs(ws, message, messageLines);
+        }
     }
 }
\ No newline at end of file
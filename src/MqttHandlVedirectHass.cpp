@@ -20,18 +20,23 @@ void MqttHandleVedirectHassClass::loop()
         return;
     }
     if (_updateForced) {
-        publishConfig();
+        _discovery.begin(true);
         _updateForced = false;
     }
 
     if (MqttSettings.getConnected() && !_wasConnected) {
         // Connection established
         _wasConnected = true;
-        publishConfig();
+        _discovery.begin(false);
     } else if (!MqttSettings.getConnected() && _wasConnected) {
         // Connection lost
         _wasConnected = false;
     }
+
+    if (_discovery.beginStep()) {
+        publishConfig();
+        _discovery.endStep();
+    }
 }
 
 void MqttHandleVedirectHassClass::forceUpdate()
@@ -89,6 +94,10 @@ void MqttHandleVedirectHassClass::publishConfig()
 
 void MqttHandleVedirectHassClass::publishSensor(String serial, String pid, const char* caption, const char* icon, const char* subTopic, const char* deviceClass, const char* stateClass, const char* unitOfMeasurement )
 {
+    if (!_discovery.claim()) {
+        return;
+    }
+
     String sensorId = caption;
     sensorId.replace(" ", "_");
     sensorId.replace(".", "");
@@ -105,7 +114,7 @@ void MqttHandleVedirectHassClass::publishSensor(String serial, String pid, const
     statTopic.concat("/");
     statTopic.concat(subTopic);
 
-    DynamicJsonDocument root(1024);
+    DynamicJsonDocument& root = _discovery.getDocument();
     root[F("name")] = caption;
     root[F("stat_t")] = statTopic;
     root[F("uniq_id")] = serial + "_" + sensorId;
@@ -131,13 +140,15 @@ void MqttHandleVedirectHassClass::publishSensor(String serial, String pid, const
         root[F("stat_cla")] = stateClass;
     }
 
-    char buffer[512];
-    serializeJson(root, buffer);
-    publish(configTopic, buffer);
+    publish(configTopic, root);
 }
 
 void MqttHandleVedirectHassClass::publishBinarySensor(String serial, String pid, const char* caption, const char* icon, const char* subTopic, const char* payload_on, const char* payload_off)
 {
+    if (!_discovery.claim()) {
+        return;
+    }
+
     String sensorId = caption;
     sensorId.replace(" ", "_");
     sensorId.replace(".", "");
@@ -154,7 +165,7 @@ void MqttHandleVedirectHassClass::publishBinarySensor(String serial, String pid,
     statTopic.concat("/");
     statTopic.concat(subTopic);
 
-    DynamicJsonDocument root(1024);
+    DynamicJsonDocument& root = _discovery.getDocument();
     root[F("name")] = caption;
     root[F("uniq_id")] = serial + "_" + sensorId;
     root[F("stat_t")] = statTopic;
@@ -168,9 +179,7 @@ void MqttHandleVedirectHassClass::publishBinarySensor(String serial, String pid,
     JsonObject deviceObj = root.createNestedObject("dev");
     createDeviceInfo(serial, pid, deviceObj);
 
-    char buffer[512];
-    serializeJson(root, buffer);
-    publish(configTopic, buffer);
+    publish(configTopic, root);
 }
 
 void MqttHandleVedirectHassClass::createDeviceInfo(String serial, String pid, JsonObject& object)
@@ -183,9 +192,9 @@ void MqttHandleVedirectHassClass::createDeviceInfo(String serial, String pid, Js
     object[F("sw")] = AUTO_GIT_HASH;
 }
 
-void MqttHandleVedirectHassClass::publish(const String& subtopic, const String& payload)
+void MqttHandleVedirectHassClass::publish(const String& subtopic, const JsonDocument& doc)
 {
     String topic = Configuration.get().Mqtt_Hass_Topic;
     topic += subtopic;
-    MqttSettings.publishGeneric(topic.c_str(), payload.c_str(), Configuration.get().Mqtt_Hass_Retain);
+    _discovery.publish(topic, doc, Configuration.get().Mqtt_Hass_Retain);
 }
\ No newline at end of file
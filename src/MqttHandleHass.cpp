@@ -16,18 +16,23 @@ void MqttHandleHassClass::init()
 void MqttHandleHassClass::loop()
 {
     if (_updateForced) {
-        publishConfig();
+        _discovery.begin(true);
         _updateForced = false;
     }
 
     if (MqttSettings.getConnected() && !_wasConnected) {
         // Connection established
         _wasConnected = true;
-        publishConfig();
+        _discovery.begin(false);
     } else if (!MqttSettings.getConnected() && _wasConnected) {
         // Connection lost
         _wasConnected = false;
     }
+
+    if (_discovery.beginStep()) {
+        publishConfig();
+        _discovery.endStep();
+    }
 }
 
 void MqttHandleHassClass::forceUpdate()
@@ -87,6 +92,10 @@ void MqttHandleHassClass::publishField(std::shared_ptr<InverterAbstract> inv, Ch
         return;
     }
 
+    if (!_discovery.claim()) {
+        return;
+    }
+
     String serial = inv->serialString();
 
     String fieldName;
@@ -120,7 +129,7 @@ void MqttHandleHassClass::publishField(std::shared_ptr<InverterAbstract> inv, Ch
             name = String(inv->name()) + " CH" + chanNum + " " + fieldName;
         }
 
-        DynamicJsonDocument root(1024);
+        DynamicJsonDocument& root = _discovery.getDocument();
         root["name"] = name;
         root["stat_t"] = stateTopic;
         root["uniq_id"] = serial + "_ch" + chanNum + "_" + fieldName;
@@ -143,9 +152,7 @@ void MqttHandleHassClass::publishField(std::shared_ptr<InverterAbstract> inv, Ch
             root["stat_cla"] = stateCls;
         }
 
-        String buffer;
-        serializeJson(root, buffer);
-        publish(configTopic, buffer);
+        publish(configTopic, root);
     } else {
         publish(configTopic, "");
     }
@@ -153,6 +160,10 @@ void MqttHandleHassClass::publishField(std::shared_ptr<InverterAbstract> inv, Ch
 
 void MqttHandleHassClass::publishInverterButton(std::shared_ptr<InverterAbstract> inv, const char* caption, const char* icon, const char* category, const char* deviceClass, const char* subTopic, const char* payload)
 {
+    if (!_discovery.claim()) {
+        return;
+    }
+
     String serial = inv->serialString();
 
     String buttonId = caption;
@@ -165,7 +176,7 @@ void MqttHandleHassClass::publishInverterButton(std::shared_ptr<InverterAbstract
 
     String cmdTopic = MqttSettings.getPrefix() + serial + "/" + subTopic;
 
-    DynamicJsonDocument root(1024);
+    DynamicJsonDocument& root = _discovery.getDocument();
     root["name"] = String(inv->name()) + " " + caption;
     root["uniq_id"] = serial + "_" + buttonId;
     if (strcmp(icon, "")) {
@@ -181,9 +192,7 @@ void MqttHandleHassClass::publishInverterButton(std::shared_ptr<InverterAbstract
     JsonObject deviceObj = root.createNestedObject("dev");
     createDeviceInfo(deviceObj, inv);
 
-    String buffer;
-    serializeJson(root, buffer);
-    publish(configTopic, buffer);
+    publish(configTopic, root);
 }
 
 void MqttHandleHassClass::publishInverterNumber(
@@ -191,6 +200,10 @@ void MqttHandleHassClass::publishInverterNumber(
     const char* commandTopic, const char* stateTopic, const char* unitOfMeasure,
     int16_t min, int16_t max)
 {
+    if (!_discovery.claim()) {
+        return;
+    }
+
     String serial = inv->serialString();
 
     String buttonId = caption;
@@ -204,7 +217,7 @@ void MqttHandleHassClass::publishInverterNumber(
     String cmdTopic = MqttSettings.getPrefix() + serial + "/" + commandTopic;
     String statTopic = MqttSettings.getPrefix() + serial + "/" + stateTopic;
 
-    DynamicJsonDocument root(1024);
+    DynamicJsonDocument& root = _discovery.getDocument();
     root["name"] = String(inv->name()) + " " + caption;
     root["uniq_id"] = serial + "_" + buttonId;
     if (strcmp(icon, "")) {
@@ -220,13 +233,15 @@ void MqttHandleHassClass::publishInverterNumber(
     JsonObject deviceObj = root.createNestedObject("dev");
     createDeviceInfo(deviceObj, inv);
 
-    String buffer;
-    serializeJson(root, buffer);
-    publish(configTopic, buffer);
+    publish(configTopic, root);
 }
 
 void MqttHandleHassClass::publishInverterBinarySensor(std::shared_ptr<InverterAbstract> inv, const char* caption, const char* subTopic, const char* payload_on, const char* payload_off)
 {
+    if (!_discovery.claim()) {
+        return;
+    }
+
     String serial = inv->serialString();
 
     String sensorId = caption;
@@ -239,7 +254,7 @@ void MqttHandleHassClass::publishInverterBinarySensor(std::shared_ptr<InverterAb
 
     String statTopic = MqttSettings.getPrefix() + serial + "/" + subTopic;
 
-    DynamicJsonDocument root(1024);
+    DynamicJsonDocument& root = _discovery.getDocument();
     root["name"] = String(inv->name()) + " " + caption;
     root["uniq_id"] = serial + "_" + sensorId;
     root["stat_t"] = statTopic;
@@ -249,9 +264,7 @@ void MqttHandleHassClass::publishInverterBinarySensor(std::shared_ptr<InverterAb
     JsonObject deviceObj = root.createNestedObject("dev");
     createDeviceInfo(deviceObj, inv);
 
-    String buffer;
-    serializeJson(root, buffer);
-    publish(configTopic, buffer);
+    publish(configTopic, root);
 }
 
 void MqttHandleHassClass::createDeviceInfo(JsonObject& object, std::shared_ptr<InverterAbstract> inv)
@@ -264,9 +277,16 @@ void MqttHandleHassClass::createDeviceInfo(JsonObject& object, std::shared_ptr<I
     object["sw"] = AUTO_GIT_HASH;
 }
 
-void MqttHandleHassClass::publish(const String& subtopic, const String& payload)
+void MqttHandleHassClass::publish(const String& subtopic, const JsonDocument& doc)
+{
+    String topic = Configuration.get().Mqtt_Hass_Topic;
+    topic += subtopic;
+    _discovery.publish(topic, doc, Configuration.get().Mqtt_Hass_Retain);
+}
+
+void MqttHandleHassClass::publish(const String& subtopic, const char* payload)
 {
     String topic = Configuration.get().Mqtt_Hass_Topic;
     topic += subtopic;
-    MqttSettings.publishGeneric(topic.c_str(), payload.c_str(), Configuration.get().Mqtt_Hass_Retain);
+    _discovery.publish(topic, payload, Configuration.get().Mqtt_Hass_Retain);
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "MqttHandleInverter.h"
 #include "MessageOutput.h"
 #include "MqttSettings.h"
+#include <algorithm>
+#include <cmath>
 #include <ctime>
 
 #define TOPIC_SUB_LIMIT_PERSISTENT_RELATIVE "limit_persistent_relative"
@@ -14,8 +16,6 @@
 #define TOPIC_SUB_POWER "power"
 #define TOPIC_SUB_RESTART "restart"
 
-#define PUBLISH_MAX_INTERVAL 60000
-
 MqttHandleInverterClass MqttHandleInverter;
 
 void MqttHandleInverterClass::init()
@@ -38,17 +38,40 @@ void MqttHandleInverterClass::init()
 
 void MqttHandleInverterClass::loop()
 {
-    if (!MqttSettings.getConnected() || !Hoymiles.isAllRadioIdle()) {
+    if (!MqttSettings.getConnected()) {
+        _connected = false;
         return;
     }
 
     const CONFIG_T& config = Configuration.get();
 
+    if (!_connected || _topicPrefix != config.Mqtt_Topic) {
+        // the broker might have lost our retained messages or the topics
+        // changed, start over with a fresh cache
+        for (auto& state : _inverters) {
+            state = InverterState();
+        }
+        _topicPrefix = config.Mqtt_Topic;
+        _connected = true;
+    }
+
+    if (!Hoymiles.isAllRadioIdle()) {
+        return;
+    }
+
     if (millis() - _lastPublish > (config.Mqtt_PublishInterval * 1000)) {
+        uint32_t cycleStart = micros();
+
         // Loop all inverters
         for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
             auto inv = Hoymiles.getInverterByPos(i);
 
+            InverterState& state = _inverters[i];
+            if (state.serial != inv->serial()) {
+                state = InverterState();
+                state.serial = inv->serial();
+            }
+
             String subtopic = inv->serialString();
 
             // Name
@@ -94,41 +117,103 @@ void MqttHandleInverterClass::loop()
             }
 
             uint32_t lastUpdateInternal = inv->Statistics()->getLastUpdateFromInternal();
-            if (inv->Statistics()->getLastUpdate() > 0 && (lastUpdateInternal != _lastPublishStats[i])) {
-                _lastPublishStats[i] = lastUpdateInternal;
-
-                // Loop all channels
-                for (auto& t : inv->Statistics()->getChannelTypes()) {
-                    for (auto& c : inv->Statistics()->getChannelsByType(t)) {
-                        if (t == TYPE_DC) {
-                            INVERTER_CONFIG_T* inv_cfg = Configuration.getInverterConfig(inv->serial());
-                            if (inv_cfg != nullptr) {
-                                // TODO(tbnobody)
-                                MqttSettings.publish(inv->serialString() + "/" + String(static_cast<uint8_t>(c) + 1) + "/name", inv_cfg->channel[c].Name);
-                            }
-                        }
-                        for (uint8_t f = 0; f < sizeof(_publishFields) / sizeof(FieldId_t); f++) {
-                            publishField(inv, t, c, _publishFields[f]);
-                        }
-                    }
+            if (inv->Statistics()->getLastUpdate() > 0 && (lastUpdateInternal != state.lastPublishStats)) {
+                state.lastPublishStats = lastUpdateInternal;
+
+                if (state.fields.empty()) {
+                    buildTopicTable(inv, state);
+                }
+
+                publishChannelNames(inv, state);
+
+                for (auto& field : state.fields) {
+                    publishField(inv, field, config.Mqtt_Retain);
                 }
             }
 
             yield();
         }
 
+        _statistics.LastCycleUs = micros() - cycleStart;
+        _statistics.MaxCycleUs = std::max(_statistics.MaxCycleUs, _statistics.LastCycleUs);
+
         _lastPublish = millis();
     }
 }
 
-void MqttHandleInverterClass::publishField(std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId)
+void MqttHandleInverterClass::buildTopicTable(std::shared_ptr<InverterAbstract> inv, InverterState& state)
+{
+    state.fields.clear();
+
+    for (auto& t : inv->Statistics()->getChannelTypes()) {
+        for (auto& c : inv->Statistics()->getChannelsByType(t)) {
+            for (auto& settings : _publishFields) {
+                String topic = getTopic(inv, t, c, settings.fieldId);
+                if (topic == "") {
+                    continue;
+                }
+
+                PublishedField field = {};
+                field.type = t;
+                field.channel = c;
+                field.settings = &settings;
+                field.topic = _topicPrefix;
+                field.topic += topic.c_str();
+                state.fields.push_back(field);
+            }
+        }
+    }
+}
+
+void MqttHandleInverterClass::publishChannelNames(std::shared_ptr<InverterAbstract> inv, InverterState& state)
 {
-    String topic = getTopic(inv, type, channel, fieldId);
-    if (topic == "") {
+    if (state.channelNamesPublished && millis() - state.lastChannelNames < PUBLISH_MAX_INTERVAL) {
+        return;
+    }
+
+    INVERTER_CONFIG_T* inv_cfg = Configuration.getInverterConfig(inv->serial());
+    if (inv_cfg == nullptr) {
+        return;
+    }
+
+    for (auto& c : inv->Statistics()->getChannelsByType(TYPE_DC)) {
+        // TODO(tbnobody)
+        MqttSettings.publish(inv->serialString() + "/" + String(static_cast<uint8_t>(c) + 1) + "/name", inv_cfg->channel[c].Name);
+    }
+
+    state.channelNamesPublished = true;
+    state.lastChannelNames = millis();
+}
+
+void MqttHandleInverterClass::publishField(std::shared_ptr<InverterAbstract> inv, PublishedField& field, bool retain)
+{
+    FieldId_t fieldId = field.settings->fieldId;
+    float value = inv->Statistics()->getChannelFieldValue(field.type, field.channel, fieldId);
+    uint8_t digits = inv->Statistics()->getChannelFieldDigits(field.type, field.channel, fieldId);
+
+    char payload[sizeof(field.payload)];
+    snprintf(payload, sizeof(payload), "%.*f", digits, value);
+
+    if (field.published && millis() - field.lastPublish < field.settings->maxInterval) {
+        float deadband = std::max(field.settings->absoluteDeadband, field.settings->relativeDeadband * std::fabs(field.value));
+        if (!strcmp(payload, field.payload) || std::fabs(value - field.value) < deadband) {
+            _statistics.Suppressed++;
+            _statistics.BytesSaved += field.topic.length() + strlen(payload);
+            return;
+        }
+    }
+
+    // keep the cache if the client's outbox is full, so the value is
+    // published again in the next cycle
+    if (!MqttSettings.publishGeneric(field.topic.c_str(), payload, retain)) {
         return;
     }
 
-    MqttSettings.publish(topic, inv->Statistics()->getChannelFieldValueString(type, channel, fieldId));
+    field.value = value;
+    strlcpy(field.payload, payload, sizeof(field.payload));
+    field.lastPublish = millis();
+    field.published = true;
+    _statistics.Published++;
 }
 
 String MqttHandleInverterClass::getTopic(std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId)
@@ -22,13 +22,14 @@ void MqttHandleInverterTotalClass::loop()
     }
 
     if (_lastPublish.occured()) {
-        MqttSettings.publish("ac/power", String(Datastore.getTotalAcPowerEnabled(), Datastore.getTotalAcPowerDigits()));
-        MqttSettings.publish("ac/yieldtotal", String(Datastore.getTotalAcYieldTotalEnabled(), Datastore.getTotalAcYieldTotalDigits()));
-        MqttSettings.publish("ac/yieldday", String(Datastore.getTotalAcYieldDayEnabled(), Datastore.getTotalAcYieldDayDigits()));
-        MqttSettings.publish("ac/is_valid", String(Datastore.getIsAllEnabledReachable()));
-        MqttSettings.publish("dc/power", String(Datastore.getTotalDcPowerEnabled(), Datastore.getTotalDcPowerDigits()));
-        MqttSettings.publish("dc/irradiation", String(Datastore.getTotalDcIrradiation(), 3));
-        MqttSettings.publish("dc/is_valid", String(Datastore.getIsAllEnabledReachable()));
+        auto totals = Datastore.getSnapshot();
+        MqttSettings.publish("ac/power", String(totals.totalAcPowerEnabled, totals.totalAcPowerDigits));
+        MqttSettings.publish("ac/yieldtotal", String(totals.totalAcYieldTotalEnabled, totals.totalAcYieldTotalDigits));
+        MqttSettings.publish("ac/yieldday", String(totals.totalAcYieldDayEnabled, totals.totalAcYieldDayDigits));
+        MqttSettings.publish("ac/is_valid", String(totals.isAllEnabledReachable));
+        MqttSettings.publish("dc/power", String(totals.totalDcPowerEnabled, totals.totalDcPowerDigits));
+        MqttSettings.publish("dc/irradiation", String(totals.totalDcIrradiation, 3));
+        MqttSettings.publish("dc/is_valid", String(totals.isAllEnabledReachable));
 
         _lastPublish.set(Configuration.get().Mqtt_PublishInterval * 1000);
     }
@@ -20,18 +20,23 @@ void MqttHandlePylontechHassClass::loop()
         return;
     }
     if (_updateForced) {
-        publishConfig();
+        _discovery.begin(true);
         _updateForced = false;
     }
 
     if (MqttSettings.getConnected() && !_wasConnected) {
         // Connection established
         _wasConnected = true;
-        publishConfig();
+        _discovery.begin(false);
     } else if (!MqttSettings.getConnected() && _wasConnected) {
         // Connection lost
         _wasConnected = false;
     }
+
+    if (_discovery.beginStep()) {
+        publishConfig();
+        _discovery.endStep();
+    }
 }
 
 void MqttHandlePylontechHassClass::forceUpdate()
@@ -93,6 +98,10 @@ void MqttHandlePylontechHassClass::publishConfig()
 
 void MqttHandlePylontechHassClass::publishSensor(const char* caption, const char* icon, const char* subTopic, const char* deviceClass, const char* stateClass, const char* unitOfMeasurement )
 {
+    if (!_discovery.claim()) {
+        return;
+    }
+
     String sensorId = caption;
     sensorId.replace(" ", "_");
     sensorId.replace(".", "");
@@ -110,7 +119,7 @@ void MqttHandlePylontechHassClass::publishSensor(const char* caption, const char
     // statTopic.concat("/");
     statTopic.concat(subTopic);
 
-    DynamicJsonDocument root(1024);
+    DynamicJsonDocument& root = _discovery.getDocument();
     root[F("name")] = caption;
     root[F("stat_t")] = statTopic;
     root[F("uniq_id")] = serial + "_" + sensorId;
@@ -136,14 +145,16 @@ void MqttHandlePylontechHassClass::publishSensor(const char* caption, const char
         root[F("stat_cla")] = stateClass;
     }
 
-    char buffer[512];
-    serializeJson(root, buffer);
-    publish(configTopic, buffer);
+    publish(configTopic, root);
 
 }
 
 void MqttHandlePylontechHassClass::publishBinarySensor(const char* caption, const char* icon, const char* subTopic, const char* payload_on, const char* payload_off)
 {
+    if (!_discovery.claim()) {
+        return;
+    }
+
     String sensorId = caption;
     sensorId.replace(" ", "_");
     sensorId.replace(".", "");
@@ -161,7 +172,7 @@ void MqttHandlePylontechHassClass::publishBinarySensor(const char* caption, cons
     // statTopic.concat("/");
     statTopic.concat(subTopic);
 
-    DynamicJsonDocument root(1024);
+    DynamicJsonDocument& root = _discovery.getDocument();
     root[F("name")] = caption;
     root[F("uniq_id")] = serial + "_" + sensorId;
     root[F("stat_t")] = statTopic;
@@ -175,9 +186,7 @@ void MqttHandlePylontechHassClass::publishBinarySensor(const char* caption, cons
     JsonObject deviceObj = root.createNestedObject("dev");
     createDeviceInfo(deviceObj);
 
-    char buffer[512];
-    serializeJson(root, buffer);
-    publish(configTopic, buffer);
+    publish(configTopic, root);
 }
 
 void MqttHandlePylontechHassClass::createDeviceInfo(JsonObject& object)
@@ -190,9 +199,9 @@ void MqttHandlePylontechHassClass::createDeviceInfo(JsonObject& object)
     object[F("sw")] = AUTO_GIT_HASH;
 }
 
-void MqttHandlePylontechHassClass::publish(const String& subtopic, const String& payload)
+void MqttHandlePylontechHassClass::publish(const String& subtopic, const JsonDocument& doc)
 {
     String topic = Configuration.get().Mqtt_Hass_Topic;
     topic += subtopic;
-    MqttSettings.publishGeneric(topic.c_str(), payload.c_str(), Configuration.get().Mqtt_Hass_Retain);
+    _discovery.publish(topic, doc, Configuration.get().Mqtt_Hass_Retain);
 }
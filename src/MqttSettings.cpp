@@ -120,11 +120,12 @@ void MqttSettingsClass::performConnect()
         willTopic = getPrefix() + config.Mqtt_LwtTopic;
         clientId = NetworkSettings.getApName();
         if (config.Mqtt_Tls) {
-            static_cast<espMqttClientSecure*>(mqttClient)->setCACert(config.Mqtt_RootCaCert);
+            auto tls = Configuration.loadMqttTls();
+            static_cast<espMqttClientSecure*>(mqttClient)->setCACert(tls->RootCaCert);
             static_cast<espMqttClientSecure*>(mqttClient)->setServer(config.Mqtt_Hostname, config.Mqtt_Port);
             if (config.Mqtt_TlsCertLogin) {
-                static_cast<espMqttClientSecure*>(mqttClient)->setCertificate(config.Mqtt_ClientCert);
-                static_cast<espMqttClientSecure*>(mqttClient)->setPrivateKey(config.Mqtt_ClientKey);
+                static_cast<espMqttClientSecure*>(mqttClient)->setCertificate(tls->ClientCert);
+                static_cast<espMqttClientSecure*>(mqttClient)->setPrivateKey(tls->ClientKey);
             } else {
                 static_cast<espMqttClientSecure*>(mqttClient)->setCredentials(config.Mqtt_Username, config.Mqtt_Password);
             }
@@ -134,6 +135,7 @@ void MqttSettingsClass::performConnect()
             static_cast<espMqttClientSecure*>(mqttClient)->onConnect(std::bind(&MqttSettingsClass::onMqttConnect, this, _1));
             static_cast<espMqttClientSecure*>(mqttClient)->onDisconnect(std::bind(&MqttSettingsClass::onMqttDisconnect, this, _1));
             static_cast<espMqttClientSecure*>(mqttClient)->onMessage(std::bind(&MqttSettingsClass::onMqttMessage, this, _1, _2, _3, _4, _5, _6));
+            _tlsConfig = std::move(tls);
         } else {
             static_cast<espMqttClient*>(mqttClient)->setServer(config.Mqtt_Hostname, config.Mqtt_Port);
             static_cast<espMqttClient*>(mqttClient)->setCredentials(config.Mqtt_Username, config.Mqtt_Password);
@@ -208,6 +210,15 @@ void MqttSettingsClass::publishGeneric(const String& topic, const String& payloa
     mqttClient->publish(topic.c_str(), qos, retain, payload.c_str());
 }
 
+bool MqttSettingsClass::publishGeneric(const char* topic, const char* payload, bool retain, uint8_t qos)
+{
+    std::lock_guard<std::mutex> lock(_clientLock);
+    if (mqttClient == nullptr) {
+        return false;
+    }
+    return mqttClient->publish(topic, qos, retain, payload) != 0;
+}
+
 void MqttSettingsClass::init()
 {
     using std::placeholders::_1;
@@ -229,6 +240,7 @@ void MqttSettingsClass::createMqttClientObject()
         delete mqttClient;
         mqttClient = nullptr;
     }
+    _tlsConfig.reset();
     const CONFIG_T& config = Configuration.get();
     if (config.Mqtt_Tls) {
         mqttClient = new espMqttClientSecure(espMqttClientTypes::UseInternalTask::NO);
@@ -83,6 +83,7 @@ bool PowerLimiterClass::shutdown(PowerLimiterClass::Status status)
             (_shutdownTimeout > 0 && _shutdownTimeout < millis()) ) {
         // we are actually (already) done with shutting down the inverter,
         // or a shutdown attempt was initiated but it timed out.
+        if (_inverter != nullptr) { _inverter->setPollPriority(false); }
         _inverter = nullptr;
         _shutdownTimeout = 0;
         return false;
@@ -156,6 +157,9 @@ void PowerLimiterClass::loop()
     // update our pointer as the configuration might have changed
     _inverter = currentInverter;
 
+    // we need fresh statistics of the inverter we control as often as possible
+    _inverter->setPollPriority(true);
+
     // data polling is disabled or the inverter is deemed offline
     if (!_inverter->isReachable()) {
         return announceStatus(Status::InverterOffline);
@@ -197,7 +201,11 @@ void PowerLimiterClass::loop()
         return;
     }
 
-    if (millis() - PowerMeter.getLastPowerMeterUpdate() > (30 * 1000)) {
+    // all decisions below are based on this very reading, no matter when
+    // and how the power meter provides the next one.
+    auto const powerMeter = PowerMeter.getSample();
+
+    if (powerMeter.timestamp == 0 || powerMeter.getAgeMillis() > (30 * 1000)) {
         shutdown(Status::PowerMeterTimeout);
         return;
     }
@@ -217,7 +225,7 @@ void PowerLimiterClass::loop()
         return announceStatus(Status::InverterStatsPending);
     }
 
-    if (PowerMeter.getLastPowerMeterUpdate() <= settlingEnd) {
+    if (powerMeter.timestamp <= settlingEnd) {
         return announceStatus(Status::PowerMeterPending);
     }
 
@@ -227,7 +235,7 @@ void PowerLimiterClass::loop()
         return announceStatus(Status::Stable);
     }
 
-    if (_verboseLogging) {
+    if (isVerboseLogging()) {
         MessageOutput.println("[DPL::loop] ******************* ENTER **********************");
     }
 
@@ -283,7 +291,7 @@ void PowerLimiterClass::loop()
       }
     }
 
-    if (_verboseLogging) {
+    if (isVerboseLogging()) {
         MessageOutput.printf("[DPL::loop] battery interface %s, SoC: %d %%, StartTH: %d %%, StopTH: %d %%, SoC age: %d s\r\n",
                 (config.Battery_Enabled?"enabled":"disabled"),
                 Battery.getStats()->getSoC(),
@@ -306,17 +314,18 @@ void PowerLimiterClass::loop()
                 (config.PowerLimiter_SolarPassThroughEnabled?"enabled":"disabled"),
                 config.PowerLimiter_BatteryDrainStategy, (canUseDirectSolarPower()?"yes":"no"));
 
-        MessageOutput.printf("[DPL::loop] battery discharging %s, PowerMeter: %d W, target consumption: %d W\r\n",
+        MessageOutput.printf("[DPL::loop] battery discharging %s, PowerMeter: %d W (%u ms old), target consumption: %d W\r\n",
                 (_batteryDischargeEnabled?"allowed":"prevented"),
-                static_cast<int32_t>(round(PowerMeter.getPowerTotal())),
+                static_cast<int32_t>(round(powerMeter.powerTotal)),
+                powerMeter.getAgeMillis(),
                 config.PowerLimiter_TargetPowerConsumption);
     }
 
     // Calculate and set Power Limit (NOTE: might reset _inverter to nullptr!)
-    int32_t newPowerLimit = calcPowerLimit(_inverter, canUseDirectSolarPower(), _batteryDischargeEnabled);
+    int32_t newPowerLimit = calcPowerLimit(_inverter, powerMeter, canUseDirectSolarPower(), _batteryDischargeEnabled);
     bool limitUpdated = setNewPowerLimit(_inverter, newPowerLimit);
 
-    if (_verboseLogging) {
+    if (isVerboseLogging()) {
         MessageOutput.printf("[DPL::loop] ******************* Leaving PL, calculated limit: %d W, requested limit: %d W (%s)\r\n",
                 newPowerLimit, _lastRequestedPowerLimit,
                 (limitUpdated?"updated from calculated":"kept last requested"));
@@ -450,12 +459,12 @@ bool PowerLimiterClass::canUseDirectSolarPower()
 // | 4      | true                    | false             | true                    | PL = PowerMeter value                                       |
 // | 5      | true                    | true              | true                    | PL = max(PowerMeter value, Victron Power)                   |
 
-int32_t PowerLimiterClass::calcPowerLimit(std::shared_ptr<InverterAbstract> inverter, bool solarPowerEnabled, bool batteryDischargeEnabled)
+int32_t PowerLimiterClass::calcPowerLimit(std::shared_ptr<InverterAbstract> inverter, PowerMeterClass::Sample const& powerMeter, bool solarPowerEnabled, bool batteryDischargeEnabled)
 {
     CONFIG_T& config = Configuration.get();
     
     int32_t acPower = 0;
-    int32_t newPowerLimit = round(PowerMeter.getPowerTotal());
+    int32_t newPowerLimit = round(powerMeter.powerTotal);
 
     if (!solarPowerEnabled && !batteryDischargeEnabled) {
       // Case 1 - No energy sources available
@@ -499,7 +508,7 @@ int32_t PowerLimiterClass::calcPowerLimit(std::shared_ptr<InverterAbstract> inve
     // We should use Victron solar power only (corrected by efficiency factor)
     if (solarPowerEnabled && !batteryDischargeEnabled) {
         // Case 2 - Limit power to solar power only
-        if (_verboseLogging) {
+        if (isVerboseLogging()) {
             MessageOutput.printf("[DPL::loop] Consuming Solar Power Only -> adjustedVictronChargePower: %d W, newPowerLimit: %d W\r\n",
                 adjustedVictronChargePower, newPowerLimit);
         }
@@ -574,14 +583,14 @@ bool PowerLimiterClass::setNewPowerLimit(std::shared_ptr<InverterAbstract> inver
     // Check if the new value is within the limits of the hysteresis
     auto diff = std::abs(effPowerLimit - _lastRequestedPowerLimit);
     if ( diff < config.PowerLimiter_TargetPowerConsumptionHysteresis) {
-        if (_verboseLogging) {
+        if (isVerboseLogging()) {
             MessageOutput.printf("[DPL::setNewPowerLimit] reusing old limit: %d W, diff: %d W, hysteresis: %d W\r\n",
                     _lastRequestedPowerLimit, diff, config.PowerLimiter_TargetPowerConsumptionHysteresis);
         }
         return false;
     }
 
-    if (_verboseLogging) {
+    if (isVerboseLogging()) {
         MessageOutput.printf("[DPL::setNewPowerLimit] using new limit: %d W, requested power limit: %d W\r\n",
                 effPowerLimit, newPowerLimit);
     }
@@ -703,7 +712,7 @@ void PowerLimiterClass::calcNextInverterRestart()
             // next restart is on next day
             _nextInverterRestart = 1440 - dayMinutes + targetMinutes;
         }
-        if (_verboseLogging) {
+        if (isVerboseLogging()) {
             MessageOutput.printf("[DPL::calcNextInverterRestart] Localtime read %d %d / configured RestartHour %d\r\n", timeinfo.tm_hour, timeinfo.tm_min, config.PowerLimiter_RestartHour);
             MessageOutput.printf("[DPL::calcNextInverterRestart] dayMinutes %d / targetMinutes %d\r\n", dayMinutes, targetMinutes);
             MessageOutput.printf("[DPL::calcNextInverterRestart] next inverter restart in %d minutes\r\n", _nextInverterRestart);
@@ -21,11 +21,17 @@ SoftwareSerial inputSerial;
 void PowerMeterClass::init()
 {
     _lastPowerMeterCheck = 0;
-    _lastPowerMeterUpdate = 0;
+    _sdmBlocks = nullptr;
+    _lastHttpPowerMeterUpdate = 0;
 
     for (auto const& s: _mqttSubscriptions) { MqttSettings.unsubscribe(s.first); }
     _mqttSubscriptions.clear();
 
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _sample = {};
+    }
+
     CONFIG_T& config = Configuration.get();
 
     if (!config.PowerMeter_Enabled) {
@@ -85,30 +91,40 @@ void PowerMeterClass::onMqttMessage(const espMqttClientTypes::MessageProperties&
             return;
         }
 
+        publishSample();
+
         if (_verboseLogging) {
             MessageOutput.printf("PowerMeterClass: Updated from '%s', TotalPower: %5.2f\r\n",
                     topic, getPowerTotal());
         }
-
-        _lastPowerMeterUpdate = millis();
     }
 }
 
-float PowerMeterClass::getPowerTotal(bool forceUpdate)
+void PowerMeterClass::publishSample()
 {
-    if (forceUpdate) {
-        CONFIG_T& config = Configuration.get();
-        if (config.PowerMeter_Enabled
-                && (millis() - _lastPowerMeterUpdate) > (1000)) {
-            readPowerMeter();
-        }
-    }
-    return _powerMeter1Power + _powerMeter2Power + _powerMeter3Power;
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _sample.power[0] = _powerMeter1Power;
+    _sample.power[1] = _powerMeter2Power;
+    _sample.power[2] = _powerMeter3Power;
+    _sample.powerTotal = _powerMeter1Power + _powerMeter2Power + _powerMeter3Power;
+    _sample.timestamp = millis();
+}
+
+PowerMeterClass::Sample PowerMeterClass::getSample()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _sample;
+}
+
+float PowerMeterClass::getPowerTotal()
+{
+    return getSample().powerTotal;
 }
 
 uint32_t PowerMeterClass::getLastPowerMeterUpdate()
 {
-    return _lastPowerMeterUpdate;
+    return getSample().timestamp;
 }
 
 void PowerMeterClass::mqtt()
@@ -140,56 +156,166 @@ void PowerMeterClass::loop()
         }
     }
 
-    if (!config.PowerMeter_Enabled
-            || (millis() - _lastPowerMeterCheck) < (config.PowerMeter_Interval)) {
+    if (!config.PowerMeter_Enabled) {
+        return;
+    }
+
+    // SDM and HTTP readings are taken asynchronously (without blocking the
+    // main loop) and are published as soon as they completed.
+    bool asyncSource = false;
+    bool asyncReadingDone = false;
+    switch (config.PowerMeter_Source) {
+        case SOURCE_SDM1PH:
+        case SOURCE_SDM3PH:
+            asyncSource = true;
+            asyncReadingDone = sdmReadLoop();
+            break;
+        case SOURCE_HTTP:
+            asyncSource = true;
+            asyncReadingDone = readHttpPowerMeter();
+            break;
+    }
+
+    if (asyncReadingDone) {
+        MessageOutput.printf("PowerMeterClass: TotalPower: %5.2f\r\n", getPowerTotal());
+
+        mqtt();
+    }
+
+    if ((millis() - _lastPowerMeterCheck) < (config.PowerMeter_Interval)) {
         return;
     }
 
     readPowerMeter();
 
+    _lastPowerMeterCheck = millis();
+
+    if (asyncSource) { return; }
+
     MessageOutput.printf("PowerMeterClass: TotalPower: %5.2f\r\n", getPowerTotal());
 
     mqtt();
-
-    _lastPowerMeterCheck = millis();
 }
 
 void PowerMeterClass::readPowerMeter()
 {
     CONFIG_T& config = Configuration.get();
-    
-    uint8_t _address = config.PowerMeter_SdmAddress;
-
-    if (config.PowerMeter_Source == SOURCE_SDM1PH) {
-        _powerMeter1Power = static_cast<float>(sdm.readVal(SDM_PHASE_1_POWER, _address));
-        _powerMeter2Power = 0.0;
-        _powerMeter3Power = 0.0;
-        _powerMeter1Voltage = static_cast<float>(sdm.readVal(SDM_PHASE_1_VOLTAGE, _address));
-        _powerMeter2Voltage = 0.0;
-        _powerMeter3Voltage = 0.0;
-        _powerMeterImport = static_cast<float>(sdm.readVal(SDM_IMPORT_ACTIVE_ENERGY, _address));
-        _powerMeterExport = static_cast<float>(sdm.readVal(SDM_EXPORT_ACTIVE_ENERGY, _address));
-        _lastPowerMeterUpdate = millis();
-    }
-    else if (config.PowerMeter_Source == SOURCE_SDM3PH) {
-        _powerMeter1Power = static_cast<float>(sdm.readVal(SDM_PHASE_1_POWER, _address));
-        _powerMeter2Power = static_cast<float>(sdm.readVal(SDM_PHASE_2_POWER, _address));
-        _powerMeter3Power = static_cast<float>(sdm.readVal(SDM_PHASE_3_POWER, _address));
-        _powerMeter1Voltage = static_cast<float>(sdm.readVal(SDM_PHASE_1_VOLTAGE, _address));
-        _powerMeter2Voltage = static_cast<float>(sdm.readVal(SDM_PHASE_2_VOLTAGE, _address));
-        _powerMeter3Voltage = static_cast<float>(sdm.readVal(SDM_PHASE_3_VOLTAGE, _address));
-        _powerMeterImport = static_cast<float>(sdm.readVal(SDM_IMPORT_ACTIVE_ENERGY, _address));
-        _powerMeterExport = static_cast<float>(sdm.readVal(SDM_EXPORT_ACTIVE_ENERGY, _address));
-        _lastPowerMeterUpdate = millis();
+
+    if (config.PowerMeter_Source == SOURCE_SDM1PH
+            || config.PowerMeter_Source == SOURCE_SDM3PH) {
+        // does not block, the blocks are read one after another by sdmReadLoop()
+        if (_sdmBlocks != nullptr) { return; } // previous cycle still running
+
+        if (config.PowerMeter_Source == SOURCE_SDM3PH) {
+            _sdmBlocks = _sdm3phBlocks;
+        } else {
+            _sdmBlocks = _sdm1phBlocks;
+        }
+        _sdmReadEnergy = (_lastSdmEnergyRead == 0
+                || (millis() - _lastSdmEnergyRead) > _sdmEnergyIntervalMs);
+        _sdmBlockIdx = 0;
+        requestSdmBlock();
     }
     else if (config.PowerMeter_Source == SOURCE_HTTP) {
-        if (HttpPowerMeter.updateValues()) {
-            _powerMeter1Power = HttpPowerMeter.getPower(1);
-            _powerMeter2Power = HttpPowerMeter.getPower(2);
-            _powerMeter3Power = HttpPowerMeter.getPower(3);
-            _lastPowerMeterUpdate = millis();
-        }
+        // does not block, the values are picked up by readHttpPowerMeter()
+        HttpPowerMeter.requestUpdate();
+    }
+}
+
+// voltages (0x00..0x04), currents (0x06..0x0A) and active powers (0x0C..0x10)
+// of three phase meters are consecutive float registers, as are the import
+// and export energy counters (0x48, 0x4A). a single phase meter does not
+// necessarily implement the registers in between its values.
+const PowerMeterClass::SdmBlock PowerMeterClass::_sdm3phBlocks[] = {
+    { SDM_PHASE_1_VOLTAGE, 9, false, {
+            &PowerMeterClass::_powerMeter1Voltage,
+            &PowerMeterClass::_powerMeter2Voltage,
+            &PowerMeterClass::_powerMeter3Voltage,
+            nullptr, nullptr, nullptr,
+            &PowerMeterClass::_powerMeter1Power,
+            &PowerMeterClass::_powerMeter2Power,
+            &PowerMeterClass::_powerMeter3Power } },
+    { SDM_IMPORT_ACTIVE_ENERGY, 2, true, {
+            &PowerMeterClass::_powerMeterImport,
+            &PowerMeterClass::_powerMeterExport } },
+    { 0, 0, false, {} }
+};
+
+const PowerMeterClass::SdmBlock PowerMeterClass::_sdm1phBlocks[] = {
+    { SDM_PHASE_1_VOLTAGE, 1, false, { &PowerMeterClass::_powerMeter1Voltage } },
+    { SDM_PHASE_1_POWER, 1, false, { &PowerMeterClass::_powerMeter1Power } },
+    { SDM_IMPORT_ACTIVE_ENERGY, 2, true, {
+            &PowerMeterClass::_powerMeterImport,
+            &PowerMeterClass::_powerMeterExport } },
+    { 0, 0, false, {} }
+};
+
+bool PowerMeterClass::requestSdmBlock()
+{
+    // energy counters change slowly and are only read every once in a while
+    while (_sdmBlocks[_sdmBlockIdx].count > 0
+            && _sdmBlocks[_sdmBlockIdx].energy && !_sdmReadEnergy) {
+        ++_sdmBlockIdx;
+    }
+
+    SdmBlock const& block = _sdmBlocks[_sdmBlockIdx];
+    if (block.count == 0) { return false; }
+
+    sdm.startBlockRead(block.reg, block.count, Configuration.get().PowerMeter_SdmAddress);
+    return true;
+}
+
+bool PowerMeterClass::sdmReadLoop()
+{
+    if (_sdmBlocks == nullptr) { return false; }
+
+    SdmBlock const& block = _sdmBlocks[_sdmBlockIdx];
+    float values[SDM_MAX_BLOCK_VALUES];
+
+    switch (sdm.pollBlockRead(values)) {
+        case SDM_BLOCK_PENDING:
+            return false;
+
+        case SDM_BLOCK_DONE:
+            for (uint8_t i = 0; i < block.count; ++i) {
+                if (block.targets[i] == nullptr) { continue; }
+                this->*block.targets[i] = values[i];
+            }
+            break;
+
+        default:
+            if (_verboseLogging) {
+                MessageOutput.printf("PowerMeterClass: Reading SDM register 0x%04x failed, error %d\r\n",
+                        block.reg, sdm.getErrCode(true));
+            }
+            _sdmBlocks = nullptr;
+            return false;
     }
+
+    ++_sdmBlockIdx;
+    if (requestSdmBlock()) { return false; }
+
+    // cycle complete
+    _sdmBlocks = nullptr;
+    if (_sdmReadEnergy) { _lastSdmEnergyRead = millis(); }
+    publishSample();
+    return true;
+}
+
+bool PowerMeterClass::readHttpPowerMeter()
+{
+    // all phases have to be taken from the same poll
+    auto reading = HttpPowerMeter.getReading();
+    if (reading.timestamp == _lastHttpPowerMeterUpdate) {
+        return false;
+    }
+
+    _powerMeter1Power = reading.power[0];
+    _powerMeter2Power = reading.power[1];
+    _powerMeter3Power = reading.power[2];
+    _lastHttpPowerMeterUpdate = reading.timestamp;
+    publishSample();
+    return true;
 }
 
 bool PowerMeterClass::smlReadLoop()
@@ -197,15 +323,16 @@ bool PowerMeterClass::smlReadLoop()
     while (inputSerial.available()) {
         double readVal = 0;
         unsigned char smlCurrentChar = inputSerial.read();
-        sml_states_t smlCurrentState = smlState(smlCurrentChar);
+        sml_states_t smlCurrentState = _smlParser.state(smlCurrentChar);
         if (smlCurrentState == SML_LISTEND) {
-            for (auto& handler: smlHandlerList) {
-                if (smlOBISCheck(handler.OBIS)) {
-                    handler.Fn(readVal);
-                    *handler.Arg = readVal;
-                }
+            auto iter = _smlHandlers.find(_smlParser.obisCode());
+            if (iter != _smlHandlers.end()) {
+                OBISHandler const& handler = iter->second;
+                (_smlParser.*handler.Fn)(readVal);
+                *handler.Arg = readVal;
             }
         } else if (smlCurrentState == SML_FINAL) {
+            publishSample();
             return true;
         }
     }
@@ -3,6 +3,7 @@
  * Copyright (C) 2022 - 2023 Thomas Basler and others
  */
 #include "Utils.h"
+#include "Configuration.h"
 #include "Display_Graphic.h"
 #include "Led_Single.h"
 #include <Esp.h>
@@ -63,5 +64,6 @@ void Utils::restartDtu()
     yield();
     delay(1000);
     yield();
+    Configuration.flush();
     ESP.restart();
 }
@@ -68,6 +68,7 @@ void WebApiClass::loop()
     _webApiPower.loop();
     _webApiPowerMeter.loop();
     _webApiPowerLimiter.loop();
+    _webApiPrometheus.loop();
     _webApiSecurity.loop();
     _webApiSysstatus.loop();
     _webApiWebapp.loop();
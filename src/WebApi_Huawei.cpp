@@ -251,14 +251,17 @@ void WebApiHuaweiClass::onAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-    config.Huawei_Enabled = root[F("enabled")].as<bool>();
-    config.Huawei_Auto_Power_Enabled = root[F("auto_power_enabled")].as<bool>();
-    config.Huawei_Auto_Power_Voltage_Limit = root[F("voltage_limit")].as<float>();
-    config.Huawei_Auto_Power_Enable_Voltage_Limit = root[F("enable_voltage_limit")].as<float>();
-    config.Huawei_Auto_Power_Lower_Power_Limit = root[F("lower_power_limit")].as<float>();
-    config.Huawei_Auto_Power_Upper_Power_Limit = root[F("upper_power_limit")].as<float>();    
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        config.Huawei_Enabled = root[F("enabled")].as<bool>();
+        config.Huawei_Auto_Power_Enabled = root[F("auto_power_enabled")].as<bool>();
+        config.Huawei_Auto_Power_Voltage_Limit = root[F("voltage_limit")].as<float>();
+        config.Huawei_Auto_Power_Enable_Voltage_Limit = root[F("enable_voltage_limit")].as<float>();
+        config.Huawei_Auto_Power_Lower_Power_Limit = root[F("lower_power_limit")].as<float>();
+        config.Huawei_Auto_Power_Upper_Power_Limit = root[F("upper_power_limit")].as<float>();    
+    }
+    Configuration.requestWrite();
 
     retMsg[F("type")] = F("success");
     retMsg[F("message")] = F("Settings saved!");
@@ -267,6 +270,7 @@ void WebApiHuaweiClass::onAdminPost(AsyncWebServerRequest* request)
     response->setLength();
     request->send(response);
 
+    const CONFIG_T& config = Configuration.get();
     const PinMapping_t& pin = PinMapping.get();
     // Properly turn this on
     if (config.Huawei_Enabled) {
@@ -100,13 +100,16 @@ void WebApiBatteryClass::onAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-    config.Battery_Enabled = root[F("enabled")].as<bool>();
-    config.Battery_VerboseLogging = root[F("verbose_logging")].as<bool>();
-    config.Battery_Provider = root[F("provider")].as<uint8_t>();
-    config.Battery_JkBmsInterface = root[F("jkbms_interface")].as<uint8_t>();
-    config.Battery_JkBmsPollingInterval = root[F("jkbms_polling_interval")].as<uint8_t>();
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        config.Battery_Enabled = root[F("enabled")].as<bool>();
+        config.Battery_VerboseLogging = root[F("verbose_logging")].as<bool>();
+        config.Battery_Provider = root[F("provider")].as<uint8_t>();
+        config.Battery_JkBmsInterface = root[F("jkbms_interface")].as<uint8_t>();
+        config.Battery_JkBmsPollingInterval = root[F("jkbms_polling_interval")].as<uint8_t>();
+    }
+    Configuration.requestWrite();
 
     retMsg[F("type")] = F("success");
     retMsg[F("message")] = F("Settings saved!");
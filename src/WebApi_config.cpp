@@ -39,6 +39,7 @@ void WebApiConfigClass::onConfigGet(AsyncWebServerRequest* request)
         return;
     }
 
+    // the JSON file is exported with every write of the configuration
     String requestFile = CONFIG_FILENAME;
     if (request->hasParam("file")) {
         String name = "/" + request->getParam("file")->value();
@@ -114,7 +115,12 @@ void WebApiConfigClass::onConfigDelete(AsyncWebServerRequest* request)
     response->setLength();
     request->send(response);
 
+    // nothing may be written after the files are gone
+    Configuration.flush();
     LittleFS.remove(CONFIG_FILENAME);
+    LittleFS.remove(CONFIG_BINARY_FILENAME);
+    LittleFS.remove(CONFIG_MQTT_TLS_FILENAME);
+    LittleFS.remove(CONFIG_POWERMETER_HTTP_FILENAME);
     Utils::restartDtu();
 }
 
@@ -174,6 +180,11 @@ void WebApiConfigClass::onConfigUpload(AsyncWebServerRequest* request, String fi
             return;
         }
         String name = "/" + request->getParam("file")->value();
+
+        // a pending write would export the JSON file over the upload
+        if (name == CONFIG_FILENAME) {
+            Configuration.flush();
+        }
         request->_tempFile = LittleFS.open(name, "w");
     }
 
@@ -185,5 +196,10 @@ void WebApiConfigClass::onConfigUpload(AsyncWebServerRequest* request, String fi
     if (final) {
         // close the file handle as the upload is now done
         request->_tempFile.close();
+
+        // an uploaded configuration is imported on the next boot
+        if (request->hasParam("file") && "/" + request->getParam("file")->value() == CONFIG_FILENAME) {
+            LittleFS.remove(CONFIG_BINARY_FILENAME);
+        }
     }
 }
\ No newline at end of file
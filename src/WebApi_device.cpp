@@ -166,23 +166,28 @@ void WebApiDeviceClass::onDeviceAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-    bool performRestart = root["curPin"]["name"].as<String>() != config.Dev_PinMapping;
-
-    strlcpy(config.Dev_PinMapping, root["curPin"]["name"].as<String>().c_str(), sizeof(config.Dev_PinMapping));
-    config.Display_Rotation = root["display"]["rotation"].as<uint8_t>();
-    config.Display_PowerSafe = root["display"]["power_safe"].as<bool>();
-    config.Display_ScreenSaver = root["display"]["screensaver"].as<bool>();
-    config.Display_Contrast = root["display"]["contrast"].as<uint8_t>();
-    config.Display_Language = root["display"]["language"].as<uint8_t>();
+    bool performRestart;
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        performRestart = root["curPin"]["name"].as<String>() != config.Dev_PinMapping;
+
+        strlcpy(config.Dev_PinMapping, root["curPin"]["name"].as<String>().c_str(), sizeof(config.Dev_PinMapping));
+        config.Display_Rotation = root["display"]["rotation"].as<uint8_t>();
+        config.Display_PowerSafe = root["display"]["power_safe"].as<bool>();
+        config.Display_ScreenSaver = root["display"]["screensaver"].as<bool>();
+        config.Display_Contrast = root["display"]["contrast"].as<uint8_t>();
+        config.Display_Language = root["display"]["language"].as<uint8_t>();
+    }
 
+    const CONFIG_T& config = Configuration.get();
     Display.setOrientation(config.Display_Rotation);
     Display.enablePowerSafe = config.Display_PowerSafe;
     Display.enableScreensaver = config.Display_ScreenSaver;
     Display.setContrast(config.Display_Contrast);
     Display.setLanguage(config.Display_Language);
 
-    Configuration.write();
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Settings saved!";
@@ -148,16 +148,19 @@ void WebApiDtuClass::onDtuAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-
-    // Interpret the string as a hex value and convert it to uint64_t
-    config.Dtu_Serial = strtoll(root["serial"].as<String>().c_str(), NULL, 16);
-    config.Dtu_PollInterval = root["pollinterval"].as<uint32_t>();
-    config.Dtu_VerboseLogging = root["verbose_logging"].as<bool>();
-    config.Dtu_NrfPaLevel = root["nrf_palevel"].as<uint8_t>();
-    config.Dtu_CmtPaLevel = root["cmt_palevel"].as<int8_t>();
-    config.Dtu_CmtFrequency = root["cmt_frequency"].as<uint32_t>();
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+
+        // Interpret the string as a hex value and convert it to uint64_t
+        config.Dtu_Serial = strtoll(root["serial"].as<String>().c_str(), NULL, 16);
+        config.Dtu_PollInterval = root["pollinterval"].as<uint32_t>();
+        config.Dtu_VerboseLogging = root["verbose_logging"].as<bool>();
+        config.Dtu_NrfPaLevel = root["nrf_palevel"].as<uint8_t>();
+        config.Dtu_CmtPaLevel = root["cmt_palevel"].as<int8_t>();
+        config.Dtu_CmtFrequency = root["cmt_frequency"].as<uint32_t>();
+    }
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Settings saved!";
@@ -166,6 +169,7 @@ void WebApiDtuClass::onDtuAdminPost(AsyncWebServerRequest* request)
     response->setLength();
     request->send(response);
 
+    const CONFIG_T& config = Configuration.get();
     Hoymiles.getRadioNrf()->setPALevel((rf24_pa_dbm_e)config.Dtu_NrfPaLevel);
     Hoymiles.getRadioCmt()->setPALevel(config.Dtu_CmtPaLevel);
     Hoymiles.getRadioNrf()->setDtuSerial(config.Dtu_Serial);
@@ -80,6 +80,10 @@ void WebApiFirmwareClass::onFirmwareUpdateUpload(AsyncWebServerRequest* request,
             Update.printError(Serial);
             return request->send(400, "text/plain", "Could not end OTA");
         }
+
+        // the new firmware imports the configuration from JSON if the
+        // layout of the binary configuration changed
+        Configuration.exportJson();
     } else {
         return;
     }
@@ -162,11 +162,15 @@ void WebApiInverterClass::onInverterAdd(AsyncWebServerRequest* request)
         return;
     }
 
-    // Interpret the string as a hex value and convert it to uint64_t
-    inverter->Serial = strtoll(root["serial"].as<String>().c_str(), NULL, 16);
+    {
+        auto guard = Configuration.getWriteGuard();
 
-    strncpy(inverter->Name, root["name"].as<String>().c_str(), INV_MAX_NAME_STRLEN);
-    Configuration.write();
+        // Interpret the string as a hex value and convert it to uint64_t
+        inverter->Serial = strtoll(root["serial"].as<String>().c_str(), NULL, 16);
+
+        strncpy(inverter->Name, root["name"].as<String>().c_str(), INV_MAX_NAME_STRLEN);
+    }
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Inverter created!";
@@ -272,27 +276,31 @@ void WebApiInverterClass::onInverterEdit(AsyncWebServerRequest* request)
     uint64_t new_serial = strtoll(root["serial"].as<String>().c_str(), NULL, 16);
     uint64_t old_serial = inverter.Serial;
 
-    // Interpret the string as a hex value and convert it to uint64_t
-    inverter.Serial = new_serial;
-    strncpy(inverter.Name, root["name"].as<String>().c_str(), INV_MAX_NAME_STRLEN);
-
-    uint8_t arrayCount = 0;
-    for (JsonVariant channel : channelArray) {
-        inverter.channel[arrayCount].MaxChannelPower = channel["max_power"].as<uint16_t>();
-        inverter.channel[arrayCount].YieldTotalOffset = channel["yield_total_offset"].as<float>();
-        strncpy(inverter.channel[arrayCount].Name, channel["name"] | "", sizeof(inverter.channel[arrayCount].Name));
-        inverter.Poll_Enable = root["poll_enable"] | true;
-        inverter.Poll_Enable_Night = root["poll_enable_night"] | true;
-        inverter.Command_Enable = root["command_enable"] | true;
-        inverter.Command_Enable_Night = root["command_enable_night"] | true;
-        inverter.ReachableThreshold = root["reachable_threshold"] | REACHABLE_THRESHOLD;
-        inverter.ZeroRuntimeDataIfUnrechable = root["zero_runtime"] | false;
-        inverter.ZeroYieldDayOnMidnight = root["zero_day"] | false;
-
-        arrayCount++;
+    {
+        auto guard = Configuration.getWriteGuard();
+
+        // Interpret the string as a hex value and convert it to uint64_t
+        inverter.Serial = new_serial;
+        strncpy(inverter.Name, root["name"].as<String>().c_str(), INV_MAX_NAME_STRLEN);
+
+        uint8_t arrayCount = 0;
+        for (JsonVariant channel : channelArray) {
+            inverter.channel[arrayCount].MaxChannelPower = channel["max_power"].as<uint16_t>();
+            inverter.channel[arrayCount].YieldTotalOffset = channel["yield_total_offset"].as<float>();
+            strncpy(inverter.channel[arrayCount].Name, channel["name"] | "", sizeof(inverter.channel[arrayCount].Name));
+            inverter.Poll_Enable = root["poll_enable"] | true;
+            inverter.Poll_Enable_Night = root["poll_enable_night"] | true;
+            inverter.Command_Enable = root["command_enable"] | true;
+            inverter.Command_Enable_Night = root["command_enable_night"] | true;
+            inverter.ReachableThreshold = root["reachable_threshold"] | REACHABLE_THRESHOLD;
+            inverter.ZeroRuntimeDataIfUnrechable = root["zero_runtime"] | false;
+            inverter.ZeroYieldDayOnMidnight = root["zero_day"] | false;
+
+            arrayCount++;
+        }
     }
 
-    Configuration.write();
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["code"] = WebApiError::InverterChanged;
@@ -390,9 +398,12 @@ void WebApiInverterClass::onInverterDelete(AsyncWebServerRequest* request)
 
     Hoymiles.removeInverterBySerial(inverter.Serial);
 
-    inverter.Serial = 0;
-    strncpy(inverter.Name, "", sizeof(inverter.Name));
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        inverter.Serial = 0;
+        strncpy(inverter.Name, "", sizeof(inverter.Name));
+    }
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Inverter deleted!";
@@ -454,16 +465,19 @@ void WebApiInverterClass::onInverterOrder(AsyncWebServerRequest* request)
     // The order array contains list or id in the right order
     JsonArray orderArray = root["order"].as<JsonArray>();
     uint8_t order = 0;
-    for (JsonVariant id : orderArray) {
-        uint8_t inverter_id = id.as<uint8_t>();
-        if (inverter_id < INV_MAX_COUNT) {
-            INVERTER_CONFIG_T& inverter = Configuration.get().Inverter[inverter_id];
-            inverter.Order = order;
+    {
+        auto guard = Configuration.getWriteGuard();
+        for (JsonVariant id : orderArray) {
+            uint8_t inverter_id = id.as<uint8_t>();
+            if (inverter_id < INV_MAX_COUNT) {
+                INVERTER_CONFIG_T& inverter = guard.getConfig().Inverter[inverter_id];
+                inverter.Order = order;
+            }
+            order++;
         }
-        order++;
     }
 
-    Configuration.write();
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Inverter order saved!";
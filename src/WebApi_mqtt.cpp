@@ -49,9 +49,12 @@ void WebApiMqttClass::onMqttStatus(AsyncWebServerRequest* request)
     root["mqtt_connected"] = MqttSettings.getConnected();
     root["mqtt_retain"] = config.Mqtt_Retain;
     root["mqtt_tls"] = config.Mqtt_Tls;
-    root["mqtt_root_ca_cert_info"] = getTlsCertInfo(config.Mqtt_RootCaCert);
+    {
+        auto tls = Configuration.loadMqttTls();
+        root["mqtt_root_ca_cert_info"] = getTlsCertInfo(tls->RootCaCert);
+        root["mqtt_client_cert_info"] = getTlsCertInfo(tls->ClientCert);
+    }
     root["mqtt_tls_cert_login"] = config.Mqtt_TlsCertLogin;
-    root["mqtt_client_cert_info"] = getTlsCertInfo(config.Mqtt_ClientCert);
     root["mqtt_lwt_topic"] = String(config.Mqtt_Topic) + config.Mqtt_LwtTopic;
     root["mqtt_publish_interval"] = config.Mqtt_PublishInterval;
     root["mqtt_clean_session"] = config.Mqtt_CleanSession;
@@ -84,10 +87,14 @@ void WebApiMqttClass::onMqttAdminGet(AsyncWebServerRequest* request)
     root["mqtt_topic"] = config.Mqtt_Topic;
     root["mqtt_retain"] = config.Mqtt_Retain;
     root["mqtt_tls"] = config.Mqtt_Tls;
-    root["mqtt_root_ca_cert"] = config.Mqtt_RootCaCert;
     root["mqtt_tls_cert_login"] = config.Mqtt_TlsCertLogin;
-    root["mqtt_client_cert"] = config.Mqtt_ClientCert;
-    root["mqtt_client_key"] = config.Mqtt_ClientKey;
+    {
+        // copied into the document as the loaded texts are released here
+        auto tls = Configuration.loadMqttTls();
+        root["mqtt_root_ca_cert"] = String(tls->RootCaCert);
+        root["mqtt_client_cert"] = String(tls->ClientCert);
+        root["mqtt_client_key"] = String(tls->ClientKey);
+    }
     root["mqtt_lwt_topic"] = config.Mqtt_LwtTopic;
     root["mqtt_lwt_online"] = config.Mqtt_LwtValue_Online;
     root["mqtt_lwt_offline"] = config.Mqtt_LwtValue_Offline;
@@ -306,31 +313,38 @@ void WebApiMqttClass::onMqttAdminPost(AsyncWebServerRequest* request)
         }
     }
 
-    CONFIG_T& config = Configuration.get();
-    config.Mqtt_Enabled = root["mqtt_enabled"].as<bool>();
-    config.Mqtt_VerboseLogging = root["mqtt_verbose_logging"].as<bool>();
-    config.Mqtt_Retain = root["mqtt_retain"].as<bool>();
-    config.Mqtt_Tls = root["mqtt_tls"].as<bool>();
-    strlcpy(config.Mqtt_RootCaCert, root["mqtt_root_ca_cert"].as<String>().c_str(), sizeof(config.Mqtt_RootCaCert));
-    config.Mqtt_TlsCertLogin = root["mqtt_tls_cert_login"].as<bool>();
-    strlcpy(config.Mqtt_ClientCert, root["mqtt_client_cert"].as<String>().c_str(), sizeof(config.Mqtt_ClientCert));
-    strlcpy(config.Mqtt_ClientKey, root["mqtt_client_key"].as<String>().c_str(), sizeof(config.Mqtt_ClientKey));
-    config.Mqtt_Port = root["mqtt_port"].as<uint>();
-    strlcpy(config.Mqtt_Hostname, root["mqtt_hostname"].as<String>().c_str(), sizeof(config.Mqtt_Hostname));
-    strlcpy(config.Mqtt_Username, root["mqtt_username"].as<String>().c_str(), sizeof(config.Mqtt_Username));
-    strlcpy(config.Mqtt_Password, root["mqtt_password"].as<String>().c_str(), sizeof(config.Mqtt_Password));
-    strlcpy(config.Mqtt_Topic, root["mqtt_topic"].as<String>().c_str(), sizeof(config.Mqtt_Topic));
-    strlcpy(config.Mqtt_LwtTopic, root["mqtt_lwt_topic"].as<String>().c_str(), sizeof(config.Mqtt_LwtTopic));
-    strlcpy(config.Mqtt_LwtValue_Online, root["mqtt_lwt_online"].as<String>().c_str(), sizeof(config.Mqtt_LwtValue_Online));
-    strlcpy(config.Mqtt_LwtValue_Offline, root["mqtt_lwt_offline"].as<String>().c_str(), sizeof(config.Mqtt_LwtValue_Offline));
-    config.Mqtt_PublishInterval = root["mqtt_publish_interval"].as<uint32_t>();
-    config.Mqtt_CleanSession = root["mqtt_clean_session"].as<bool>();
-    config.Mqtt_Hass_Enabled = root["mqtt_hass_enabled"].as<bool>();
-    config.Mqtt_Hass_Expire = root["mqtt_hass_expire"].as<bool>();
-    config.Mqtt_Hass_Retain = root["mqtt_hass_retain"].as<bool>();
-    config.Mqtt_Hass_IndividualPanels = root["mqtt_hass_individualpanels"].as<bool>();
-    strlcpy(config.Mqtt_Hass_Topic, root["mqtt_hass_topic"].as<String>().c_str(), sizeof(config.Mqtt_Hass_Topic));
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        config.Mqtt_Enabled = root["mqtt_enabled"].as<bool>();
+        config.Mqtt_VerboseLogging = root["mqtt_verbose_logging"].as<bool>();
+        config.Mqtt_Retain = root["mqtt_retain"].as<bool>();
+        config.Mqtt_Tls = root["mqtt_tls"].as<bool>();
+        config.Mqtt_TlsCertLogin = root["mqtt_tls_cert_login"].as<bool>();
+        config.Mqtt_Port = root["mqtt_port"].as<uint>();
+        strlcpy(config.Mqtt_Hostname, root["mqtt_hostname"].as<String>().c_str(), sizeof(config.Mqtt_Hostname));
+        strlcpy(config.Mqtt_Username, root["mqtt_username"].as<String>().c_str(), sizeof(config.Mqtt_Username));
+        strlcpy(config.Mqtt_Password, root["mqtt_password"].as<String>().c_str(), sizeof(config.Mqtt_Password));
+        strlcpy(config.Mqtt_Topic, root["mqtt_topic"].as<String>().c_str(), sizeof(config.Mqtt_Topic));
+        strlcpy(config.Mqtt_LwtTopic, root["mqtt_lwt_topic"].as<String>().c_str(), sizeof(config.Mqtt_LwtTopic));
+        strlcpy(config.Mqtt_LwtValue_Online, root["mqtt_lwt_online"].as<String>().c_str(), sizeof(config.Mqtt_LwtValue_Online));
+        strlcpy(config.Mqtt_LwtValue_Offline, root["mqtt_lwt_offline"].as<String>().c_str(), sizeof(config.Mqtt_LwtValue_Offline));
+        config.Mqtt_PublishInterval = root["mqtt_publish_interval"].as<uint32_t>();
+        config.Mqtt_CleanSession = root["mqtt_clean_session"].as<bool>();
+        config.Mqtt_Hass_Enabled = root["mqtt_hass_enabled"].as<bool>();
+        config.Mqtt_Hass_Expire = root["mqtt_hass_expire"].as<bool>();
+        config.Mqtt_Hass_Retain = root["mqtt_hass_retain"].as<bool>();
+        config.Mqtt_Hass_IndividualPanels = root["mqtt_hass_individualpanels"].as<bool>();
+        strlcpy(config.Mqtt_Hass_Topic, root["mqtt_hass_topic"].as<String>().c_str(), sizeof(config.Mqtt_Hass_Topic));
+    }
+    Configuration.requestWrite();
+
+    auto tls = std::make_unique<MQTT_TLS_CONFIG_T>();
+    strlcpy(tls->RootCaCert, root["mqtt_root_ca_cert"].as<String>().c_str(), sizeof(tls->RootCaCert));
+    strlcpy(tls->ClientCert, root["mqtt_client_cert"].as<String>().c_str(), sizeof(tls->ClientCert));
+    strlcpy(tls->ClientKey, root["mqtt_client_key"].as<String>().c_str(), sizeof(tls->ClientKey));
+    Configuration.writeMqttTls(*tls);
+    tls.reset();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Settings saved!";
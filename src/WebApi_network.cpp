@@ -206,37 +206,40 @@ void WebApiNetworkClass::onNetworkAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-    config.WiFi_Ip[0] = ipaddress[0];
-    config.WiFi_Ip[1] = ipaddress[1];
-    config.WiFi_Ip[2] = ipaddress[2];
-    config.WiFi_Ip[3] = ipaddress[3];
-    config.WiFi_Netmask[0] = netmask[0];
-    config.WiFi_Netmask[1] = netmask[1];
-    config.WiFi_Netmask[2] = netmask[2];
-    config.WiFi_Netmask[3] = netmask[3];
-    config.WiFi_Gateway[0] = gateway[0];
-    config.WiFi_Gateway[1] = gateway[1];
-    config.WiFi_Gateway[2] = gateway[2];
-    config.WiFi_Gateway[3] = gateway[3];
-    config.WiFi_Dns1[0] = dns1[0];
-    config.WiFi_Dns1[1] = dns1[1];
-    config.WiFi_Dns1[2] = dns1[2];
-    config.WiFi_Dns1[3] = dns1[3];
-    config.WiFi_Dns2[0] = dns2[0];
-    config.WiFi_Dns2[1] = dns2[1];
-    config.WiFi_Dns2[2] = dns2[2];
-    config.WiFi_Dns2[3] = dns2[3];
-    strlcpy(config.WiFi_Ssid, root["ssid"].as<String>().c_str(), sizeof(config.WiFi_Ssid));
-    strlcpy(config.WiFi_Password, root["password"].as<String>().c_str(), sizeof(config.WiFi_Password));
-    strlcpy(config.WiFi_Hostname, root["hostname"].as<String>().c_str(), sizeof(config.WiFi_Hostname));
-    if (root["dhcp"].as<bool>()) {
-        config.WiFi_Dhcp = true;
-    } else {
-        config.WiFi_Dhcp = false;
-    }
-    config.WiFi_ApTimeout = root["aptimeout"].as<uint>();
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        config.WiFi_Ip[0] = ipaddress[0];
+        config.WiFi_Ip[1] = ipaddress[1];
+        config.WiFi_Ip[2] = ipaddress[2];
+        config.WiFi_Ip[3] = ipaddress[3];
+        config.WiFi_Netmask[0] = netmask[0];
+        config.WiFi_Netmask[1] = netmask[1];
+        config.WiFi_Netmask[2] = netmask[2];
+        config.WiFi_Netmask[3] = netmask[3];
+        config.WiFi_Gateway[0] = gateway[0];
+        config.WiFi_Gateway[1] = gateway[1];
+        config.WiFi_Gateway[2] = gateway[2];
+        config.WiFi_Gateway[3] = gateway[3];
+        config.WiFi_Dns1[0] = dns1[0];
+        config.WiFi_Dns1[1] = dns1[1];
+        config.WiFi_Dns1[2] = dns1[2];
+        config.WiFi_Dns1[3] = dns1[3];
+        config.WiFi_Dns2[0] = dns2[0];
+        config.WiFi_Dns2[1] = dns2[1];
+        config.WiFi_Dns2[2] = dns2[2];
+        config.WiFi_Dns2[3] = dns2[3];
+        strlcpy(config.WiFi_Ssid, root["ssid"].as<String>().c_str(), sizeof(config.WiFi_Ssid));
+        strlcpy(config.WiFi_Password, root["password"].as<String>().c_str(), sizeof(config.WiFi_Password));
+        strlcpy(config.WiFi_Hostname, root["hostname"].as<String>().c_str(), sizeof(config.WiFi_Hostname));
+        if (root["dhcp"].as<bool>()) {
+            config.WiFi_Dhcp = true;
+        } else {
+            config.WiFi_Dhcp = false;
+        }
+        config.WiFi_ApTimeout = root["aptimeout"].as<uint>();
+    }
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Settings saved!";
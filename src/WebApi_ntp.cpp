@@ -172,14 +172,17 @@ void WebApiNtpClass::onNtpAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-    strlcpy(config.Ntp_Server, root["ntp_server"].as<String>().c_str(), sizeof(config.Ntp_Server));
-    strlcpy(config.Ntp_Timezone, root["ntp_timezone"].as<String>().c_str(), sizeof(config.Ntp_Timezone));
-    strlcpy(config.Ntp_TimezoneDescr, root["ntp_timezone_descr"].as<String>().c_str(), sizeof(config.Ntp_TimezoneDescr));
-    config.Ntp_Latitude = root["latitude"].as<double>();
-    config.Ntp_Longitude = root["longitude"].as<double>();
-    config.Ntp_SunsetType = root["sunsettype"].as<uint8_t>();
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        strlcpy(config.Ntp_Server, root["ntp_server"].as<String>().c_str(), sizeof(config.Ntp_Server));
+        strlcpy(config.Ntp_Timezone, root["ntp_timezone"].as<String>().c_str(), sizeof(config.Ntp_Timezone));
+        strlcpy(config.Ntp_TimezoneDescr, root["ntp_timezone_descr"].as<String>().c_str(), sizeof(config.Ntp_TimezoneDescr));
+        config.Ntp_Latitude = root["latitude"].as<double>();
+        config.Ntp_Longitude = root["longitude"].as<double>();
+        config.Ntp_SunsetType = root["sunsettype"].as<uint8_t>();
+    }
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Settings saved!";
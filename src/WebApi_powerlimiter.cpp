@@ -123,35 +123,35 @@ void WebApiPowerLimiterClass::onAdminPost(AsyncWebServerRequest* request)
     }
 
 
-    CONFIG_T& config = Configuration.get();
-    config.PowerLimiter_Enabled = root[F("enabled")].as<bool>();
-    PowerLimiter.setMode(PowerLimiterClass::Mode::Normal);  // User input sets PL to normal operation
-    config.PowerLimiter_VerboseLogging = root[F("verbose_logging")].as<bool>();
-    config.PowerLimiter_SolarPassThroughEnabled = root[F("solar_passthrough_enabled")].as<bool>();
-    config.PowerLimiter_SolarPassThroughLosses = root[F("solar_passthrough_losses")].as<uint8_t>();
-    config.PowerLimiter_BatteryDrainStategy= root[F("battery_drain_strategy")].as<uint8_t>();
-    config.PowerLimiter_IsInverterBehindPowerMeter = root[F("is_inverter_behind_powermeter")].as<bool>();
-    config.PowerLimiter_InverterId = root[F("inverter_id")].as<uint8_t>();
-    config.PowerLimiter_InverterChannelId = root[F("inverter_channel_id")].as<uint8_t>();
-    config.PowerLimiter_TargetPowerConsumption = root[F("target_power_consumption")].as<int32_t>();
-    config.PowerLimiter_TargetPowerConsumptionHysteresis = root[F("target_power_consumption_hysteresis")].as<int32_t>();
-    config.PowerLimiter_LowerPowerLimit = root[F("lower_power_limit")].as<int32_t>();
-    config.PowerLimiter_UpperPowerLimit = root[F("upper_power_limit")].as<int32_t>();
-    config.PowerLimiter_BatterySocStartThreshold = root[F("battery_soc_start_threshold")].as<uint32_t>();
-    config.PowerLimiter_BatterySocStopThreshold = root[F("battery_soc_stop_threshold")].as<uint32_t>();
-    config.PowerLimiter_VoltageStartThreshold = root[F("voltage_start_threshold")].as<float>();
-    config.PowerLimiter_VoltageStartThreshold = static_cast<int>(config.PowerLimiter_VoltageStartThreshold * 100) / 100.0;
-    config.PowerLimiter_VoltageStopThreshold = root[F("voltage_stop_threshold")].as<float>();
-    config.PowerLimiter_VoltageStopThreshold = static_cast<int>(config.PowerLimiter_VoltageStopThreshold * 100) / 100.0;
-    config.PowerLimiter_VoltageLoadCorrectionFactor = root[F("voltage_load_correction_factor")].as<float>();
-    config.PowerLimiter_RestartHour = root[F("inverter_restart_hour")].as<int8_t>();
-    config.PowerLimiter_FullSolarPassThroughSoc = root[F("full_solar_passthrough_soc")].as<uint32_t>();
-    config.PowerLimiter_FullSolarPassThroughStartVoltage = static_cast<int>(root[F("full_solar_passthrough_start_voltage")].as<float>() * 100) / 100.0;
-    config.PowerLimiter_FullSolarPassThroughStopVoltage = static_cast<int>(root[F("full_solar_passthrough_stop_voltage")].as<float>() * 100) / 100.0;
-
-
-
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        config.PowerLimiter_Enabled = root[F("enabled")].as<bool>();
+        PowerLimiter.setMode(PowerLimiterClass::Mode::Normal);  // User input sets PL to normal operation
+        config.PowerLimiter_VerboseLogging = root[F("verbose_logging")].as<bool>();
+        config.PowerLimiter_SolarPassThroughEnabled = root[F("solar_passthrough_enabled")].as<bool>();
+        config.PowerLimiter_SolarPassThroughLosses = root[F("solar_passthrough_losses")].as<uint8_t>();
+        config.PowerLimiter_BatteryDrainStategy= root[F("battery_drain_strategy")].as<uint8_t>();
+        config.PowerLimiter_IsInverterBehindPowerMeter = root[F("is_inverter_behind_powermeter")].as<bool>();
+        config.PowerLimiter_InverterId = root[F("inverter_id")].as<uint8_t>();
+        config.PowerLimiter_InverterChannelId = root[F("inverter_channel_id")].as<uint8_t>();
+        config.PowerLimiter_TargetPowerConsumption = root[F("target_power_consumption")].as<int32_t>();
+        config.PowerLimiter_TargetPowerConsumptionHysteresis = root[F("target_power_consumption_hysteresis")].as<int32_t>();
+        config.PowerLimiter_LowerPowerLimit = root[F("lower_power_limit")].as<int32_t>();
+        config.PowerLimiter_UpperPowerLimit = root[F("upper_power_limit")].as<int32_t>();
+        config.PowerLimiter_BatterySocStartThreshold = root[F("battery_soc_start_threshold")].as<uint32_t>();
+        config.PowerLimiter_BatterySocStopThreshold = root[F("battery_soc_stop_threshold")].as<uint32_t>();
+        config.PowerLimiter_VoltageStartThreshold = root[F("voltage_start_threshold")].as<float>();
+        config.PowerLimiter_VoltageStartThreshold = static_cast<int>(config.PowerLimiter_VoltageStartThreshold * 100) / 100.0;
+        config.PowerLimiter_VoltageStopThreshold = root[F("voltage_stop_threshold")].as<float>();
+        config.PowerLimiter_VoltageStopThreshold = static_cast<int>(config.PowerLimiter_VoltageStopThreshold * 100) / 100.0;
+        config.PowerLimiter_VoltageLoadCorrectionFactor = root[F("voltage_load_correction_factor")].as<float>();
+        config.PowerLimiter_RestartHour = root[F("inverter_restart_hour")].as<int8_t>();
+        config.PowerLimiter_FullSolarPassThroughSoc = root[F("full_solar_passthrough_soc")].as<uint32_t>();
+        config.PowerLimiter_FullSolarPassThroughStartVoltage = static_cast<int>(root[F("full_solar_passthrough_start_voltage")].as<float>() * 100) / 100.0;
+        config.PowerLimiter_FullSolarPassThroughStopVoltage = static_cast<int>(root[F("full_solar_passthrough_stop_voltage")].as<float>() * 100) / 100.0;
+    }
+    Configuration.requestWrite();
 
     PowerLimiter.calcNextInverterRestart();
 
@@ -13,6 +13,7 @@
 #include "PowerLimiter.h"
 #include "PowerMeter.h"
 #include "HttpPowerMeter.h"
+#include "Utils.h"
 #include "WebApi.h"
 #include "helper.h"
 
@@ -50,19 +51,20 @@ void WebApiPowerMeterClass::onStatus(AsyncWebServerRequest* request)
     root[F("http_individual_requests")] = config.PowerMeter_HttpIndividualRequests;
 
     JsonArray httpPhases = root.createNestedArray(F("http_phases"));
+    auto http = Configuration.loadPowerMeterHttp();
 
     for (uint8_t i = 0; i < POWERMETER_MAX_PHASES; i++) {
         JsonObject phaseObject = httpPhases.createNestedObject();
 
         phaseObject[F("index")] = i + 1;
         phaseObject[F("enabled")] = config.Powermeter_Http_Phase[i].Enabled;
-        phaseObject[F("url")] = String(config.Powermeter_Http_Phase[i].Url);
+        phaseObject[F("url")] = String(http->Phase[i].Url);
         phaseObject[F("auth_type")]= config.Powermeter_Http_Phase[i].AuthType;
         phaseObject[F("username")] = String(config.Powermeter_Http_Phase[i].Username);
         phaseObject[F("password")] = String(config.Powermeter_Http_Phase[i].Password);
-        phaseObject[F("header_key")] = String(config.Powermeter_Http_Phase[i].HeaderKey);
-        phaseObject[F("header_value")] = String(config.Powermeter_Http_Phase[i].HeaderValue);
-        phaseObject[F("json_path")] = String(config.Powermeter_Http_Phase[i].JsonPath);
+        phaseObject[F("header_key")] = String(http->Phase[i].HeaderKey);
+        phaseObject[F("header_value")] = String(http->Phase[i].HeaderValue);
+        phaseObject[F("json_path")] = String(http->Phase[i].JsonPath);
         phaseObject[F("timeout")] = config.Powermeter_Http_Phase[i].Timeout;
     }
 
@@ -168,34 +170,46 @@ void WebApiPowerMeterClass::onAdminPost(AsyncWebServerRequest* request)
         }
     }
 
-    CONFIG_T& config = Configuration.get();
-    config.PowerMeter_Enabled = root[F("enabled")].as<bool>();
-    config.PowerMeter_VerboseLogging = root[F("verbose_logging")].as<bool>();
-    config.PowerMeter_Source = root[F("source")].as<uint8_t>();
-    config.PowerMeter_Interval = root[F("interval")].as<uint32_t>();
-    strlcpy(config.PowerMeter_MqttTopicPowerMeter1, root[F("mqtt_topic_powermeter_1")].as<String>().c_str(), sizeof(config.PowerMeter_MqttTopicPowerMeter1));
-    strlcpy(config.PowerMeter_MqttTopicPowerMeter2, root[F("mqtt_topic_powermeter_2")].as<String>().c_str(), sizeof(config.PowerMeter_MqttTopicPowerMeter2));
-    strlcpy(config.PowerMeter_MqttTopicPowerMeter3, root[F("mqtt_topic_powermeter_3")].as<String>().c_str(), sizeof(config.PowerMeter_MqttTopicPowerMeter3));
-    config.PowerMeter_SdmBaudrate = root[F("sdmbaudrate")].as<uint32_t>();
-    config.PowerMeter_SdmAddress = root[F("sdmaddress")].as<uint8_t>();
-    config.PowerMeter_HttpIndividualRequests = root[F("http_individual_requests")].as<bool>();
-
     JsonArray http_phases = root[F("http_phases")];
+
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        config.PowerMeter_Enabled = root[F("enabled")].as<bool>();
+        config.PowerMeter_VerboseLogging = root[F("verbose_logging")].as<bool>();
+        config.PowerMeter_Source = root[F("source")].as<uint8_t>();
+        config.PowerMeter_Interval = root[F("interval")].as<uint32_t>();
+        strlcpy(config.PowerMeter_MqttTopicPowerMeter1, root[F("mqtt_topic_powermeter_1")].as<String>().c_str(), sizeof(config.PowerMeter_MqttTopicPowerMeter1));
+        strlcpy(config.PowerMeter_MqttTopicPowerMeter2, root[F("mqtt_topic_powermeter_2")].as<String>().c_str(), sizeof(config.PowerMeter_MqttTopicPowerMeter2));
+        strlcpy(config.PowerMeter_MqttTopicPowerMeter3, root[F("mqtt_topic_powermeter_3")].as<String>().c_str(), sizeof(config.PowerMeter_MqttTopicPowerMeter3));
+        config.PowerMeter_SdmBaudrate = root[F("sdmbaudrate")].as<uint32_t>();
+        config.PowerMeter_SdmAddress = root[F("sdmaddress")].as<uint8_t>();
+        config.PowerMeter_HttpIndividualRequests = root[F("http_individual_requests")].as<bool>();
+
+        for (uint8_t i = 0; i < http_phases.size(); i++) {
+            JsonObject phase = http_phases[i].as<JsonObject>();
+
+            config.Powermeter_Http_Phase[i].Enabled = (i == 0 ? true : phase[F("enabled")].as<bool>());
+            config.Powermeter_Http_Phase[i].AuthType = phase[F("auth_type")].as<Auth>();
+            strlcpy(config.Powermeter_Http_Phase[i].Username, phase[F("username")].as<String>().c_str(), sizeof(config.Powermeter_Http_Phase[i].Username));
+            strlcpy(config.Powermeter_Http_Phase[i].Password, phase[F("password")].as<String>().c_str(), sizeof(config.Powermeter_Http_Phase[i].Password));
+            config.Powermeter_Http_Phase[i].Timeout = phase[F("timeout")].as<uint16_t>();
+        }
+    }
+
+    auto http = Configuration.loadPowerMeterHttp();
     for (uint8_t i = 0; i < http_phases.size(); i++) {
         JsonObject phase = http_phases[i].as<JsonObject>();
 
-        config.Powermeter_Http_Phase[i].Enabled = (i == 0 ? true : phase[F("enabled")].as<bool>());
-        strlcpy(config.Powermeter_Http_Phase[i].Url, phase[F("url")].as<String>().c_str(), sizeof(config.Powermeter_Http_Phase[i].Url));
-        config.Powermeter_Http_Phase[i].AuthType = phase[F("auth_type")].as<Auth>();
-        strlcpy(config.Powermeter_Http_Phase[i].Username, phase[F("username")].as<String>().c_str(), sizeof(config.Powermeter_Http_Phase[i].Username));
-        strlcpy(config.Powermeter_Http_Phase[i].Password, phase[F("password")].as<String>().c_str(), sizeof(config.Powermeter_Http_Phase[i].Password));
-        strlcpy(config.Powermeter_Http_Phase[i].HeaderKey, phase[F("header_key")].as<String>().c_str(), sizeof(config.Powermeter_Http_Phase[i].HeaderKey));
-        strlcpy(config.Powermeter_Http_Phase[i].HeaderValue, phase[F("header_value")].as<String>().c_str(), sizeof(config.Powermeter_Http_Phase[i].HeaderValue));
-        config.Powermeter_Http_Phase[i].Timeout = phase[F("timeout")].as<uint16_t>();
-        strlcpy(config.Powermeter_Http_Phase[i].JsonPath, phase[F("json_path")].as<String>().c_str(), sizeof(config.Powermeter_Http_Phase[i].JsonPath));
+        strlcpy(http->Phase[i].Url, phase[F("url")].as<String>().c_str(), sizeof(http->Phase[i].Url));
+        strlcpy(http->Phase[i].HeaderKey, phase[F("header_key")].as<String>().c_str(), sizeof(http->Phase[i].HeaderKey));
+        strlcpy(http->Phase[i].HeaderValue, phase[F("header_value")].as<String>().c_str(), sizeof(http->Phase[i].HeaderValue));
+        strlcpy(http->Phase[i].JsonPath, phase[F("json_path")].as<String>().c_str(), sizeof(http->Phase[i].JsonPath));
     }
 
-    Configuration.write();
+    Configuration.writePowerMeterHttp(*http);
+    http.reset();
+    Configuration.requestWrite();
 
     retMsg[F("type")] = F("success");
     retMsg[F("message")] = F("Settings saved!");
@@ -203,10 +217,7 @@ void WebApiPowerMeterClass::onAdminPost(AsyncWebServerRequest* request)
     response->setLength();
     request->send(response);
 
-    yield();
-    delay(1000);
-    yield();
-    ESP.restart();
+    Utils::restartDtu();
 }
 
 void WebApiPowerMeterClass::onTestHttpRequest(AsyncWebServerRequest* request)
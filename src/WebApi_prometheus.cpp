@@ -1,15 +1,22 @@
-
 // SPDX-License-Identifier: GPL-2.0-or-later
 /*
  * Copyright (C) 2022 Thomas Basler and others
  */
 #include "WebApi_prometheus.h"
+#include "Battery.h"
 #include "Configuration.h"
+#include "Huawei_can.h"
+#include "LoopProfiler.h"
 #include "MessageOutput.h"
 #include "NetworkSettings.h"
+#include "PowerLimiter.h"
+#include "PowerMeter.h"
+#include "VeDirectMpptController.h"
 #include "WebApi.h"
 #include <Hoymiles.h>
-#include "MessageOutput.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
 
 void WebApiPrometheusClass::init(AsyncWebServer* server)
 {
@@ -22,89 +29,338 @@ void WebApiPrometheusClass::init(AsyncWebServer* server)
 
 void WebApiPrometheusClass::loop()
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // don't keep an outdated rendering around between scrapes
+    if (_cache && _cache.use_count() == 1 && millis() - _cacheTimestamp > PROMETHEUS_CACHE_TTL) {
+        _cache.reset();
+    }
+}
+
+void WebApiPrometheusClass::MetricsWriter::print(const char* s)
+{
+    _buffer.append(s);
+}
+
+void WebApiPrometheusClass::MetricsWriter::printf(const char* format, ...)
+{
+    char line[160];
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (len < 0) {
+        return;
+    }
+
+    if (static_cast<size_t>(len) < sizeof(line)) {
+        _buffer.append(line, len);
+        return;
+    }
+
+    // format again, directly into the buffer
+    size_t offset = _buffer.size();
+    _buffer.resize(offset + len + 1);
+    va_start(args, format);
+    vsnprintf(&_buffer[offset], len + 1, format, args);
+    va_end(args);
+    _buffer.resize(offset + len);
+}
+
+void WebApiPrometheusClass::MetricsWriter::header(const char* name, const char* help, const char* type)
+{
+    printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
 }
 
 void WebApiPrometheusClass::onPrometheusMetricsGet(AsyncWebServerRequest* request)
 {
     try {
-        auto stream = request->beginResponseStream("text/plain; charset=utf-8", 4096 * INV_MAX_COUNT); // TODO(helge) check if this calculation is correct
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (!_cache || millis() - _cacheTimestamp > PROMETHEUS_CACHE_TTL) {
+            // a rendering still being sent is left alone
+            if (!_cache || _cache.use_count() > 1) {
+                _cache = std::make_shared<std::string>();
+            }
+            _cache->clear();
+
+            // reserved up front so the string is not reallocated, which
+            // would briefly need about twice the size of the rendering
+            _cache->reserve(_lastRenderSize + PROMETHEUS_RENDER_MARGIN);
+
+            MetricsWriter stream(*_cache);
+            render(stream);
+            _cacheTimestamp = millis();
+            _lastRenderSize = _cache->size();
+        }
+
+        // the response copies slices of the rendering into the send buffer
+        std::shared_ptr<std::string> content = _cache;
+        lock.unlock();
 
-        stream->print("# HELP opendtu_build Build info\n");
-        stream->print("# TYPE opendtu_build gauge\n");
-        stream->printf("opendtu_build{name=\"%s\",id=\"%s\",version=\"%d.%d.%d\"} 1\n",
-            NetworkSettings.getHostname().c_str(), AUTO_GIT_HASH, CONFIG_VERSION >> 24 & 0xff, CONFIG_VERSION >> 16 & 0xff, CONFIG_VERSION >> 8 & 0xff);
+        AsyncWebServerResponse* response = request->beginResponse("text/plain; charset=utf-8", content->size(),
+            [content](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                size_t len = std::min(maxLen, content->size() - index);
+                memcpy(buffer, content->data() + index, len);
+                return len;
+            });
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
 
-        stream->print("# HELP opendtu_platform Platform info\n");
-        stream->print("# TYPE opendtu_platform gauge\n");
-        stream->printf("opendtu_platform{arch=\"%s\",mac=\"%s\"} 1\n", ESP.getChipModel(), NetworkSettings.macAddress().c_str());
+    } catch (std::bad_alloc& bad_alloc) {
+        MessageOutput.printf("Calling /api/prometheus/metrics has temporarily run out of resources. Reason: \"%s\".\r\n", bad_alloc.what());
 
-        stream->print("# HELP opendtu_uptime Uptime in seconds\n");
-        stream->print("# TYPE opendtu_uptime counter\n");
-        stream->printf("opendtu_uptime %lld\n", esp_timer_get_time() / 1000000);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cache.reset();
+        WebApi.sendTooManyRequests(request);
+    }
+}
 
-        stream->print("# HELP opendtu_heap_size System memory size\n");
-        stream->print("# TYPE opendtu_heap_size gauge\n");
-        stream->printf("opendtu_heap_size %zu\n", ESP.getHeapSize());
+void WebApiPrometheusClass::render(MetricsWriter& stream)
+{
+    const CONFIG_T& config = Configuration.get();
 
-        stream->print("# HELP opendtu_free_heap_size System free memory\n");
-        stream->print("# TYPE opendtu_free_heap_size gauge\n");
-        stream->printf("opendtu_free_heap_size %zu\n", ESP.getFreeHeap());
+    addSystemInfo(stream);
+    addInverters(stream);
 
-        stream->print("# HELP wifi_rssi WiFi RSSI\n");
-        stream->print("# TYPE wifi_rssi gauge\n");
-        stream->printf("wifi_rssi %d\n", WiFi.RSSI());
+    if (config.Vedirect_Enabled) {
+        addVedirect(stream);
+    }
+    if (config.Battery_Enabled) {
+        addBattery(stream);
+    }
+    if (config.Huawei_Enabled) {
+        addHuawei(stream);
+    }
+    if (config.PowerMeter_Enabled) {
+        addPowerMeter(stream);
+    }
+    if (config.PowerLimiter_Enabled) {
+        addPowerLimiter(stream);
+    }
 
-        stream->print("# HELP wifi_station WiFi Station info\n");
-        stream->print("# TYPE wifi_station gauge\n");
-        stream->printf("wifi_station{bssid=\"%s\"} 1\n", WiFi.BSSIDstr().c_str());
+    addLoopProfile(stream);
+}
 
-        for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
-            auto inv = Hoymiles.getInverterByPos(i);
+void WebApiPrometheusClass::addSystemInfo(MetricsWriter& stream)
+{
+    stream.header("opendtu_build", "Build info", "gauge");
+    stream.printf("opendtu_build{name=\"%s\",id=\"%s\",version=\"%d.%d.%d\"} 1\n",
+        NetworkSettings.getHostname().c_str(), AUTO_GIT_HASH, CONFIG_VERSION >> 24 & 0xff, CONFIG_VERSION >> 16 & 0xff, CONFIG_VERSION >> 8 & 0xff);
 
-            String serial = inv->serialString();
-            const char* name = inv->name();
-            if (i == 0) {
-                stream->print("# HELP opendtu_last_update last update from inverter in s\n");
-                stream->print("# TYPE opendtu_last_update gauge\n");
-            }
-            stream->printf("opendtu_last_update{serial=\"%s\",unit=\"%d\",name=\"%s\"} %d\n",
-                serial.c_str(), i, name, inv->Statistics()->getLastUpdate() / 1000);
-
-            // Loop all channels if Statistics have been updated at least once since DTU boot
-            if (inv->Statistics()->getLastUpdate() > 0) {
-                for (auto& t : inv->Statistics()->getChannelTypes()) {
-                    for (auto& c : inv->Statistics()->getChannelsByType(t)) {
-                        addPanelInfo(stream, serial, i, inv, t, c);
-                        for (uint8_t f = 0; f < sizeof(_publishFields) / sizeof(_publishFields[0]); f++) {
-                            if (t == TYPE_AC && _publishFields[f].field == FLD_PDC) {
-                                addField(stream, serial, i, inv, t, c, _publishFields[f].field, _metricTypes[_publishFields[f].type], "PowerDC");
-                            } else {
-                                addField(stream, serial, i, inv, t, c, _publishFields[f].field, _metricTypes[_publishFields[f].type]);
-                            }
+    stream.header("opendtu_platform", "Platform info", "gauge");
+    stream.printf("opendtu_platform{arch=\"%s\",mac=\"%s\"} 1\n", ESP.getChipModel(), NetworkSettings.macAddress().c_str());
+
+    stream.header("opendtu_uptime", "Uptime in seconds", "counter");
+    stream.printf("opendtu_uptime %lld\n", esp_timer_get_time() / 1000000);
+
+    stream.header("opendtu_heap_size", "System memory size", "gauge");
+    stream.printf("opendtu_heap_size %zu\n", ESP.getHeapSize());
+
+    stream.header("opendtu_free_heap_size", "System free memory", "gauge");
+    stream.printf("opendtu_free_heap_size %zu\n", ESP.getFreeHeap());
+
+    stream.header("wifi_rssi", "WiFi RSSI", "gauge");
+    stream.printf("wifi_rssi %d\n", WiFi.RSSI());
+
+    stream.header("wifi_station", "WiFi Station info", "gauge");
+    stream.printf("wifi_station{bssid=\"%s\"} 1\n", WiFi.BSSIDstr().c_str());
+}
+
+void WebApiPrometheusClass::addInverters(MetricsWriter& stream)
+{
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+
+        String serial = inv->serialString();
+        const char* name = inv->name();
+        if (i == 0) {
+            stream.header("opendtu_last_update", "last update from inverter in s", "gauge");
+        }
+        stream.printf("opendtu_last_update{serial=\"%s\",unit=\"%d\",name=\"%s\"} %d\n",
+            serial.c_str(), i, name, inv->Statistics()->getLastUpdate() / 1000);
+
+        // Loop all channels if Statistics have been updated at least once since DTU boot
+        if (inv->Statistics()->getLastUpdate() > 0) {
+            for (auto& t : inv->Statistics()->getChannelTypes()) {
+                for (auto& c : inv->Statistics()->getChannelsByType(t)) {
+                    addPanelInfo(stream, serial, i, inv, t, c);
+                    for (uint8_t f = 0; f < sizeof(_publishFields) / sizeof(_publishFields[0]); f++) {
+                        if (t == TYPE_AC && _publishFields[f].field == FLD_PDC) {
+                            addField(stream, serial, i, inv, t, c, _publishFields[f].field, _metricTypes[_publishFields[f].type], "PowerDC");
+                        } else {
+                            addField(stream, serial, i, inv, t, c, _publishFields[f].field, _metricTypes[_publishFields[f].type]);
                         }
                     }
                 }
             }
         }
-        stream->addHeader("Cache-Control", "no-cache");
-        request->send(stream);
+    }
+}
+
+void WebApiPrometheusClass::addVedirect(MetricsWriter& stream)
+{
+    using frame_t = VeDirectMpptController::veMpptStruct;
+
+    struct vedirect_metric_t {
+        const char* name;
+        const char* help;
+        const char* type;
+        double (*value)(const frame_t& frame);
+    };
+
+    static const vedirect_metric_t metrics[] = {
+        { "opendtu_vedirect_battery_voltage", "battery voltage in V", "gauge", [](const frame_t& f) -> double { return f.V; } },
+        { "opendtu_vedirect_battery_current", "battery current in A", "gauge", [](const frame_t& f) -> double { return f.I; } },
+        { "opendtu_vedirect_battery_power", "battery output power in W", "gauge", [](const frame_t& f) -> double { return f.P; } },
+        { "opendtu_vedirect_panel_voltage", "panel voltage in V", "gauge", [](const frame_t& f) -> double { return f.VPV; } },
+        { "opendtu_vedirect_panel_current", "panel current in A", "gauge", [](const frame_t& f) -> double { return f.IPV; } },
+        { "opendtu_vedirect_panel_power", "panel power in W", "gauge", [](const frame_t& f) -> double { return f.PPV; } },
+        { "opendtu_vedirect_efficiency", "efficiency in percent", "gauge", [](const frame_t& f) -> double { return f.E; } },
+        { "opendtu_vedirect_state", "state of operation", "gauge", [](const frame_t& f) -> double { return f.CS; } },
+        { "opendtu_vedirect_mppt_state", "state of the MPP tracker", "gauge", [](const frame_t& f) -> double { return f.MPPT; } },
+        { "opendtu_vedirect_error", "error code", "gauge", [](const frame_t& f) -> double { return f.ERR; } },
+        { "opendtu_vedirect_off_reason", "off reason", "gauge", [](const frame_t& f) -> double { return f.OR; } },
+        { "opendtu_vedirect_load", "load output state", "gauge", [](const frame_t& f) -> double { return f.LOAD; } },
+        { "opendtu_vedirect_yield_total", "yield total in kWh", "counter", [](const frame_t& f) -> double { return f.H19; } },
+        { "opendtu_vedirect_yield_today", "yield today in kWh", "gauge", [](const frame_t& f) -> double { return f.H20; } },
+        { "opendtu_vedirect_max_power_today", "maximum power today in W", "gauge", [](const frame_t& f) -> double { return f.H21; } },
+        { "opendtu_vedirect_yield_yesterday", "yield yesterday in kWh", "gauge", [](const frame_t& f) -> double { return f.H22; } },
+        { "opendtu_vedirect_max_power_yesterday", "maximum power yesterday in W", "gauge", [](const frame_t& f) -> double { return f.H23; } },
+    };
+
+    stream.header("opendtu_vedirect_data_valid", "1 if the charge controller data is current", "gauge");
+    for (uint8_t i = 0; i < VICTRON_COUNT; i++) {
+        if (!VeDirectMppt[i].isInit()) {
+            continue;
+        }
+        stream.printf("opendtu_vedirect_data_valid{unit=\"%d\",serial=\"%s\"} %d\n",
+            i, VeDirectMppt[i].veFrame.SER, VeDirectMppt[i].isDataValid() ? 1 : 0);
+    }
+
+    for (auto const& metric : metrics) {
+        stream.header(metric.name, metric.help, metric.type);
+        for (uint8_t i = 0; i < VICTRON_COUNT; i++) {
+            if (!VeDirectMppt[i].isInit() || !VeDirectMppt[i].isDataValid()) {
+                continue;
+            }
+            stream.printf("%s{unit=\"%d\",serial=\"%s\"} %g\n",
+                metric.name, i, VeDirectMppt[i].veFrame.SER, metric.value(VeDirectMppt[i].veFrame));
+        }
+    }
+}
 
-    } catch (std::bad_alloc& bad_alloc) {
-        MessageOutput.printf("Calling /api/prometheus/metrics has temporarily run out of resources. Reason: \"%s\".\r\n", bad_alloc.what());
+void WebApiPrometheusClass::addBattery(MetricsWriter& stream)
+{
+    auto stats = Battery.getStats();
 
-        WebApi.sendTooManyRequests(request);
+    stream.header("opendtu_battery_info", "Battery info", "gauge");
+    stream.printf("opendtu_battery_info{manufacturer=\"%s\",valid=\"%d\"} 1\n",
+        stats->getManufacturer().c_str(), stats->isValid() ? 1 : 0);
+
+    stream.header("opendtu_battery_data_age", "age of the battery data in s", "gauge");
+    stream.printf("opendtu_battery_data_age %u\n", static_cast<unsigned>(stats->getAgeSeconds()));
+
+    // every provider describes its values for the live view, the numeric
+    // ones are exported as they are
+    DynamicJsonDocument doc(2048);
+    JsonVariant var = doc;
+    stats->getLiveViewData(var);
+
+    stream.header("opendtu_battery_value", "battery value as shown in the live view", "gauge");
+    for (JsonPairConst kv : doc["values"].as<JsonObjectConst>()) {
+        JsonVariantConst value = kv.value()["v"];
+        if (!value.is<float>()) {
+            continue;
+        }
+        stream.printf("opendtu_battery_value{name=\"%s\",unit=\"%s\"} %g\n",
+            kv.key().c_str(), kv.value()["u"] | "", value.as<float>());
+    }
+
+    stream.header("opendtu_battery_issue", "battery warning (1) or alarm (2)", "gauge");
+    for (JsonPairConst kv : doc["issues"].as<JsonObjectConst>()) {
+        stream.printf("opendtu_battery_issue{name=\"%s\"} %d\n", kv.key().c_str(), kv.value().as<int>());
+    }
+}
+
+void WebApiPrometheusClass::addHuawei(MetricsWriter& stream)
+{
+    struct huawei_metric_t {
+        const char* name;
+        const char* help;
+        float RectifierParameters_t::*value;
+    };
+
+    static const huawei_metric_t metrics[] = {
+        { "opendtu_huawei_input_voltage", "input voltage in V", &RectifierParameters_t::input_voltage },
+        { "opendtu_huawei_input_frequency", "input frequency in Hz", &RectifierParameters_t::input_frequency },
+        { "opendtu_huawei_input_current", "input current in A", &RectifierParameters_t::input_current },
+        { "opendtu_huawei_input_power", "input power in W", &RectifierParameters_t::input_power },
+        { "opendtu_huawei_input_temperature", "input temperature in °C", &RectifierParameters_t::input_temp },
+        { "opendtu_huawei_efficiency", "efficiency in percent", &RectifierParameters_t::efficiency },
+        { "opendtu_huawei_output_voltage", "output voltage in V", &RectifierParameters_t::output_voltage },
+        { "opendtu_huawei_output_current", "output current in A", &RectifierParameters_t::output_current },
+        { "opendtu_huawei_max_output_current", "maximum output current in A", &RectifierParameters_t::max_output_current },
+        { "opendtu_huawei_output_power", "output power in W", &RectifierParameters_t::output_power },
+        { "opendtu_huawei_output_temperature", "output temperature in °C", &RectifierParameters_t::output_temp },
+        { "opendtu_huawei_amp_hour", "amp hours", &RectifierParameters_t::amp_hour },
+    };
+
+    stream.header("opendtu_huawei_data_age", "age of the charger data in s", "gauge");
+    stream.printf("opendtu_huawei_data_age %u\n", static_cast<unsigned>((millis() - HuaweiCan.getLastUpdate()) / 1000));
+
+    const RectifierParameters_t* rp = HuaweiCan.get();
+    for (auto const& metric : metrics) {
+        stream.header(metric.name, metric.help, "gauge");
+        stream.printf("%s %g\n", metric.name, rp->*metric.value);
+    }
+}
+
+void WebApiPrometheusClass::addPowerMeter(MetricsWriter& stream)
+{
+    PowerMeterClass::Sample sample = PowerMeter.getSample();
+    if (sample.timestamp == 0) {
+        return;
+    }
+
+    stream.header("opendtu_powermeter_data_age", "age of the power meter reading in ms", "gauge");
+    stream.printf("opendtu_powermeter_data_age %u\n", static_cast<unsigned>(sample.getAgeMillis()));
+
+    stream.header("opendtu_powermeter_power_total", "total power in W", "gauge");
+    stream.printf("opendtu_powermeter_power_total %g\n", sample.powerTotal);
+
+    stream.header("opendtu_powermeter_power", "power per phase in W", "gauge");
+    for (uint8_t i = 0; i < POWERMETER_MAX_PHASES; i++) {
+        stream.printf("opendtu_powermeter_power{phase=\"%d\"} %g\n", i + 1, sample.power[i]);
     }
 }
 
-void WebApiPrometheusClass::addField(AsyncResponseStream* stream, String& serial, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, const char* metricName, const char* channelName)
+void WebApiPrometheusClass::addPowerLimiter(MetricsWriter& stream)
+{
+    stream.header("opendtu_dpl_state", "dynamic power limiter state (0 inactive, 1 charging, 2 solar only, 3 solar and battery)", "gauge");
+    stream.printf("opendtu_dpl_state %d\n", PowerLimiter.getPowerLimiterState());
+
+    stream.header("opendtu_dpl_mode", "dynamic power limiter mode (0 normal, 1 disabled, 2 full solar passthrough)", "gauge");
+    stream.printf("opendtu_dpl_mode %u\n", static_cast<unsigned>(PowerLimiter.getMode()));
+
+    stream.header("opendtu_dpl_status", "dynamic power limiter status code", "gauge");
+    stream.printf("opendtu_dpl_status %u\n", static_cast<unsigned>(PowerLimiter.getStatus()));
+
+    stream.header("opendtu_dpl_limit", "last power limit requested by the dynamic power limiter in W", "gauge");
+    stream.printf("opendtu_dpl_limit %d\n", static_cast<int>(PowerLimiter.getLastRequestedPowerLimit()));
+}
+
+void WebApiPrometheusClass::addField(MetricsWriter& stream, String& serial, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, const char* metricName, const char* channelName)
 {
     if (inv->Statistics()->hasChannelFieldValue(type, channel, fieldId)) {
         const char* chanName = (channelName == NULL) ? inv->Statistics()->getChannelFieldName(type, channel, fieldId) : channelName;
         if (idx == 0 && type == TYPE_AC && channel == 0) {
-            stream->printf("# HELP opendtu_%s in %s\n", chanName, inv->Statistics()->getChannelFieldUnit(type, channel, fieldId));
-            stream->printf("# TYPE opendtu_%s %s\n", chanName, metricName);
+            stream.printf("# HELP opendtu_%s in %s\n", chanName, inv->Statistics()->getChannelFieldUnit(type, channel, fieldId));
+            stream.printf("# TYPE opendtu_%s %s\n", chanName, metricName);
         }
-        stream->printf("opendtu_%s{serial=\"%s\",unit=\"%d\",name=\"%s\",type=\"%s\",channel=\"%d\"} %s\n",
+        stream.printf("opendtu_%s{serial=\"%s\",unit=\"%d\",name=\"%s\",type=\"%s\",channel=\"%d\"} %s\n",
             chanName,
             serial.c_str(),
             idx,
@@ -115,7 +371,7 @@ void WebApiPrometheusClass::addField(AsyncResponseStream* stream, String& serial
     }
 }
 
-void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, String& serial, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel)
+void WebApiPrometheusClass::addPanelInfo(MetricsWriter& stream, String& serial, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel)
 {
     if (type != TYPE_DC) {
         return;
@@ -125,10 +381,10 @@ void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, String& se
 
     const bool printHelp = (idx == 0 && channel == 0);
     if (printHelp) {
-        stream->print("# HELP opendtu_PanelInfo panel information\n");
-        stream->print("# TYPE opendtu_PanelInfo gauge\n");
+        stream.print("# HELP opendtu_PanelInfo panel information\n");
+        stream.print("# TYPE opendtu_PanelInfo gauge\n");
     }
-    stream->printf("opendtu_PanelInfo{serial=\"%s\",unit=\"%d\",name=\"%s\",channel=\"%d\",panelname=\"%s\"} 1\n",
+    stream.printf("opendtu_PanelInfo{serial=\"%s\",unit=\"%d\",name=\"%s\",channel=\"%d\",panelname=\"%s\"} 1\n",
         serial.c_str(),
         idx,
         inv->name(),
@@ -136,10 +392,10 @@ void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, String& se
         config.Inverter[idx].channel[channel].Name);
 
     if (printHelp) {
-        stream->print("# HELP opendtu_MaxPower panel maximum output power\n");
-        stream->print("# TYPE opendtu_MaxPower gauge\n");
+        stream.print("# HELP opendtu_MaxPower panel maximum output power\n");
+        stream.print("# TYPE opendtu_MaxPower gauge\n");
     }
-    stream->printf("opendtu_MaxPower{serial=\"%s\",unit=\"%d\",name=\"%s\",channel=\"%d\"} %d\n",
+    stream.printf("opendtu_MaxPower{serial=\"%s\",unit=\"%d\",name=\"%s\",channel=\"%d\"} %d\n",
         serial.c_str(),
         idx,
         inv->name(),
@@ -147,13 +403,46 @@ void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, String& se
         config.Inverter[idx].channel[channel].MaxChannelPower);
 
     if (printHelp) {
-        stream->print("# HELP opendtu_YieldTotalOffset panel yield offset (for used inverters)\n");
-        stream->print("# TYPE opendtu_YieldTotalOffset gauge\n");
+        stream.print("# HELP opendtu_YieldTotalOffset panel yield offset (for used inverters)\n");
+        stream.print("# TYPE opendtu_YieldTotalOffset gauge\n");
     }
-    stream->printf("opendtu_YieldTotalOffset{serial=\"%s\",unit=\"%d\",name=\"%s\",channel=\"%d\"} %f\n",
+    stream.printf("opendtu_YieldTotalOffset{serial=\"%s\",unit=\"%d\",name=\"%s\",channel=\"%d\"} %f\n",
         serial.c_str(),
         idx,
         inv->name(),
         channel,
         config.Inverter[idx].channel[channel].YieldTotalOffset);
 }
+
+void WebApiPrometheusClass::addLoopProfile(MetricsWriter& stream)
+{
+    stream.header("opendtu_loop_frequency", "Main loop iterations per second", "gauge");
+    stream.printf("opendtu_loop_frequency %u\n", static_cast<unsigned>(LoopProfiler.getLoopsPerSecond()));
+
+    // the quantiles and the stall are those of the last completed window,
+    // sum and count are accumulated since boot
+    auto window = LoopProfiler.getLastWindow();
+
+    stream.header("opendtu_loop_stall_us", "Longest single main loop section call in microseconds", "gauge");
+    stream.printf("opendtu_loop_stall_us{section=\"%s\"} %u\n",
+        LoopProfilerClass::getSectionName(window->stallSection), static_cast<unsigned>(window->stallUs));
+
+    stream.header("opendtu_loop_duration_us", "Duration of main loop sections in microseconds", "summary");
+    for (size_t i = 0; i <= LoopProfilerClass::SECTION_COUNT; i++) {
+        const char* name = "loop";
+        const LoopProfilerClass::Histogram* histogram = &window->loop;
+        LoopProfilerClass::Total total = LoopProfiler.getLoopTotal();
+        if (i < LoopProfilerClass::SECTION_COUNT) {
+            auto section = static_cast<LoopProfilerClass::Section>(i);
+            name = LoopProfilerClass::getSectionName(section);
+            histogram = &window->getHistogram(section);
+            total = LoopProfiler.getTotal(section);
+        }
+
+        stream.printf("opendtu_loop_duration_us{section=\"%s\",quantile=\"0.5\"} %u\n", name, static_cast<unsigned>(histogram->getPercentileUs(50)));
+        stream.printf("opendtu_loop_duration_us{section=\"%s\",quantile=\"0.99\"} %u\n", name, static_cast<unsigned>(histogram->getPercentileUs(99)));
+        stream.printf("opendtu_loop_duration_us{section=\"%s\",quantile=\"1\"} %u\n", name, static_cast<unsigned>(histogram->maxUs));
+        stream.printf("opendtu_loop_duration_us_sum{section=\"%s\"} %llu\n", name, static_cast<unsigned long long>(total.sumUs));
+        stream.printf("opendtu_loop_duration_us_count{section=\"%s\"} %llu\n", name, static_cast<unsigned long long>(total.count));
+    }
+}
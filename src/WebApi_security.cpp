@@ -98,10 +98,13 @@ void WebApiSecurityClass::onSecurityPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-    strlcpy(config.Security_Password, root["password"].as<String>().c_str(), sizeof(config.Security_Password));
-    config.Security_AllowReadonly = root["allow_readonly"].as<bool>();
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        strlcpy(config.Security_Password, root["password"].as<String>().c_str(), sizeof(config.Security_Password));
+        config.Security_AllowReadonly = root["allow_readonly"].as<bool>();
+    }
+    Configuration.requestWrite();
 
     retMsg["type"] = "success";
     retMsg["message"] = "Settings saved!";
@@ -4,6 +4,11 @@
  */
 #include "WebApi_sysstatus.h"
 #include "Configuration.h"
+#include "MessageOutput.h"
+#include "MqttHandleHass.h"
+#include "MqttHandleInverter.h"
+#include "MqttHandlePylontechHass.h"
+#include "MqttHandleVedirectHass.h"
 #include "NetworkSettings.h"
 #include "PinMapping.h"
 #include "WebApi.h"
@@ -33,13 +38,71 @@ void WebApiSysstatusClass::loop()
 {
 }
 
+void WebApiSysstatusClass::addRadioStatistics(JsonObject& root, const RadioStatistics_t& stats)
+{
+    root["tx_request"] = stats.TxRequestData;
+    root["tx_re_request"] = stats.TxReRequestFragment;
+    root["tx_resend"] = stats.TxResendWhole;
+    root["tx_coalesced"] = stats.TxCoalesced;
+    root["tx_preempted"] = stats.TxPreempted;
+    root["tx_dropped"] = stats.TxDropped;
+    root["tx_queue_high_water"] = stats.TxQueueHighWater;
+    root["rx_fragments"] = stats.RxFragments;
+    root["rx_fragments_corrupt"] = stats.RxFragmentsCorrupt;
+    root["rx_fragments_dropped"] = stats.RxFragmentsDropped;
+    root["rx_success"] = stats.RxSuccess;
+    root["rx_fail_nothing"] = stats.RxFailNothing;
+    root["rx_fail_partial"] = stats.RxFailPartial;
+    root["rx_fail_corrupt"] = stats.RxFailCorrupt;
+}
+
+void WebApiSysstatusClass::addHistogram(JsonObject& root, const LoopProfilerClass::Histogram& histogram)
+{
+    root["count"] = histogram.count;
+    root["min_us"] = histogram.count > 0 ? histogram.minUs : 0;
+    root["p50_us"] = histogram.getPercentileUs(50);
+    root["p99_us"] = histogram.getPercentileUs(99);
+    root["max_us"] = histogram.maxUs;
+}
+
+void WebApiSysstatusClass::addDiscoveryStatistics(JsonObject& root, const HassDiscoveryStatistics_t& stats)
+{
+    root["published"] = stats.Published;
+    root["skipped"] = stats.Skipped;
+    root["burst_ms"] = stats.LastBurstMs;
+    root["burst_busy_us"] = stats.LastBurstBusyUs;
+    root["burst_steps"] = stats.LastBurstSteps;
+    root["burst_peak_heap"] = stats.LastBurstPeakHeap;
+}
+
+void WebApiSysstatusClass::addLoopStatistics(JsonObject& root)
+{
+    // the statistics are those of the last completed window
+    auto window = LoopProfiler.getLastWindow();
+
+    root["frequency"] = LoopProfiler.getLoopsPerSecond();
+    root["window_s"] = window->durationMs / 1000;
+    root["stall_us"] = window->stallUs;
+    root["stall_section"] = LoopProfilerClass::getSectionName(window->stallSection);
+
+    JsonObject duration = root.createNestedObject("duration");
+    addHistogram(duration, window->loop);
+
+    JsonObject sections = root.createNestedObject("sections");
+    for (size_t i = 0; i < LoopProfilerClass::SECTION_COUNT; i++) {
+        auto section = static_cast<LoopProfilerClass::Section>(i);
+        JsonObject obj = sections.createNestedObject(LoopProfilerClass::getSectionName(section));
+        addHistogram(obj, window->getHistogram(section));
+    }
+}
+
 void WebApiSysstatusClass::onSystemStatus(AsyncWebServerRequest* request)
 {
     if (!WebApi.checkCredentialsReadonly(request)) {
         return;
     }
 
-    AsyncJsonResponse* response = new AsyncJsonResponse();
+    AsyncJsonResponse* response = new AsyncJsonResponse(false, SYSSTATUS_JSON_DOC_SIZE);
     JsonObject root = response->getRoot();
 
     root["hostname"] = NetworkSettings.getHostname();
@@ -79,9 +142,46 @@ void WebApiSysstatusClass::onSystemStatus(AsyncWebServerRequest* request)
     root["nrf_configured"] = PinMapping.isValidNrf24Config();
     root["nrf_connected"] = Hoymiles.getRadioNrf()->isConnected();
     root["nrf_pvariant"] = Hoymiles.getRadioNrf()->isPVariant();
+    JsonObject nrfStats = root.createNestedObject("nrf_statistics");
+    addRadioStatistics(nrfStats, Hoymiles.getRadioNrf()->getStatistics());
 
     root["cmt_configured"] = PinMapping.isValidCmt2300Config();
     root["cmt_connected"] = Hoymiles.getRadioCmt()->isConnected();
+    JsonObject cmtStats = root.createNestedObject("cmt_statistics");
+    addRadioStatistics(cmtStats, Hoymiles.getRadioCmt()->getStatistics());
+
+    root["livedata_bytes"] = WebApi.getWsLive().getLastPublishBytes();
+    root["livedata_us"] = WebApi.getWsLive().getLastPublishMicros();
+    root["log_dropped"] = MessageOutput.getDroppedLines();
+    root["log_dropped_ws"] = MessageOutput.getDroppedWsLines();
+
+    MqttInverterStatistics_t mqttStats = MqttHandleInverter.getStatistics();
+    JsonObject mqttInverter = root.createNestedObject("mqtt_inverter");
+    mqttInverter["published"] = mqttStats.Published;
+    mqttInverter["suppressed"] = mqttStats.Suppressed;
+    mqttInverter["bytes_saved"] = mqttStats.BytesSaved;
+    mqttInverter["cycle_us"] = mqttStats.LastCycleUs;
+    mqttInverter["cycle_max_us"] = mqttStats.MaxCycleUs;
+
+    ConfigWriteStatistics_t configStats = Configuration.getWriteStatistics();
+    JsonObject configWrites = root.createNestedObject("config_writes");
+    configWrites["writes"] = configStats.Writes;
+    configWrites["requests"] = configStats.Requests;
+    configWrites["pending"] = configStats.Pending;
+    configWrites["last_us"] = configStats.LastWriteUs;
+    configWrites["max_us"] = configStats.MaxWriteUs;
+    configWrites["resident_size"] = sizeof(CONFIG_T);
+
+    JsonObject hassDiscovery = root.createNestedObject("hass_discovery");
+    JsonObject hassInverter = hassDiscovery.createNestedObject("inverter");
+    addDiscoveryStatistics(hassInverter, MqttHandleHass.getDiscoveryStatistics());
+    JsonObject hassVedirect = hassDiscovery.createNestedObject("vedirect");
+    addDiscoveryStatistics(hassVedirect, MqttHandleVedirectHass.getDiscoveryStatistics());
+    JsonObject hassBattery = hassDiscovery.createNestedObject("battery");
+    addDiscoveryStatistics(hassBattery, MqttHandlePylontechHass.getDiscoveryStatistics());
+
+    JsonObject loopStats = root.createNestedObject("loop");
+    addLoopStatistics(loopStats);
 
     response->setLength();
     request->send(response);
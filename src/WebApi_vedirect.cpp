@@ -111,15 +111,18 @@ void WebApiVedirectClass::onVedirectAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-    config.Vedirect_Enabled = root[F("vedirect_enabled")].as<bool>();
-    config.Vedirect_VerboseLogging = root[F("verbose_logging")].as<bool>();
-    config.Vedirect_UpdatesOnly = root[F("vedirect_updatesonly")].as<bool>();
-    Configuration.write();
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        config.Vedirect_Enabled = root[F("vedirect_enabled")].as<bool>();
+        config.Vedirect_VerboseLogging = root[F("verbose_logging")].as<bool>();
+        config.Vedirect_UpdatesOnly = root[F("vedirect_updatesonly")].as<bool>();
+    }
+    Configuration.requestWrite();
 
     for (int8_t i = 0; i < VICTRON_COUNT; i++)
     {
-        VeDirectMppt[i].setVerboseLogging(config.Vedirect_VerboseLogging);
+        VeDirectMppt[i].setVerboseLogging(Configuration.get().Vedirect_VerboseLogging);
     }
 
     retMsg[F("type")] = F("success");
@@ -15,8 +15,16 @@ WebApiWsConsoleClass::WebApiWsConsoleClass()
 
 void WebApiWsConsoleClass::init(AsyncWebServer* server)
 {
+    using std::placeholders::_1;
+    using std::placeholders::_2;
+    using std::placeholders::_3;
+    using std::placeholders::_4;
+    using std::placeholders::_5;
+    using std::placeholders::_6;
+
     _server = server;
     _server->addHandler(&_ws);
+    _ws.onEvent(std::bind(&WebApiWsConsoleClass::onWebsocketEvent, this, _1, _2, _3, _4, _5, _6));
     MessageOutput.register_ws_output(&_ws);
 }
 
@@ -34,4 +42,11 @@ void WebApiWsConsoleClass::loop()
 
         _lastWsCleanup = millis();
     }
+}
+
+void WebApiWsConsoleClass::onWebsocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len)
+{
+    if (type == WS_EVT_CONNECT) {
+        MessageOutput.requestHistory(client->id());
+    }
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 
 WebApiWsLiveClass::WebApiWsLiveClass()
     : _ws("/livedata")
+    , _publisher(_ws)
 {
 }
 
@@ -63,33 +64,31 @@ void WebApiWsLiveClass::loop()
     }
 
     // Update on every inverter change or at least after 10 seconds
-    if (millis() - _lastWsPublish > (10 * 1000) || (maxTimeStamp != _newestInverterTimestamp)) {
+    if (millis() - _lastWsPublish > (10 * 1000) || (maxTimeStamp != _newestInverterTimestamp) || _publisher.isPublishRequested()) {
 
         try {
             std::lock_guard<std::mutex> lock(_mutex);
-            DynamicJsonDocument root(4096 * INV_MAX_COUNT);
-            JsonVariant var = root;
+            uint32_t start = micros();
+
+            DynamicJsonDocument& doc = getDocument();
+            JsonVariant var = doc;
             generateJsonResponse(var);
 
-            String buffer;
-            // free JsonDocument as soon as possible
-            {
-                DynamicJsonDocument root(4096 * INV_MAX_COUNT); // TODO(helge) check if this calculation is correct
-                JsonVariant var = root;
-                generateJsonResponse(var);
-                serializeJson(root, buffer);
+            if (doc.overflowed()) {
+                MessageOutput.println("Live data does not fit into the websocket document, payload is incomplete.");
             }
 
-            if (buffer) {
-                if (Configuration.get().Security_AllowReadonly) {
-                    _ws.setAuthentication("", "");
-                } else {
-                    _ws.setAuthentication(AUTH_USERNAME, Configuration.get().Security_Password);
-                }
-
-                _ws.textAll(buffer);
+            if (Configuration.get().Security_AllowReadonly) {
+                _ws.setAuthentication("", "");
+            } else {
+                _ws.setAuthentication(AUTH_USERNAME, Configuration.get().Security_Password);
             }
 
+            _publisher.publish(doc);
+
+            _lastPublishBytes = _publisher.getLastPublishBytes();
+            _lastPublishMicros = micros() - start;
+
         } catch (const std::bad_alloc& bad_alloc) {
             MessageOutput.printf("Calling /api/livedata/status has temporarily run out of resources. Reason: \"%s\".\r\n", bad_alloc.what());
         } catch (const std::exception& exc) {
@@ -122,6 +121,7 @@ void WebApiWsLiveClass::generateJsonResponse(JsonVariant& root)
         invObject["order"] = inv_cfg->Order;
         invObject["data_age"] = (millis() - inv->Statistics()->getLastUpdate()) / 1000;
         invObject["poll_enabled"] = inv->getEnablePolling();
+        invObject["poll_interval"] = inv->getStatsInterval();
         invObject["reachable"] = inv->isReachable();
         invObject["producing"] = inv->isProducing();
         invObject["limit_relative"] = inv->SystemConfigPara()->getLimitPercent();
@@ -174,9 +174,10 @@ void WebApiWsLiveClass::generateJsonResponse(JsonVariant& root)
     }
 
     JsonObject totalObj = root.createNestedObject("total");
-    addTotalField(totalObj, "Power", Datastore.getTotalAcPowerEnabled(), "W", Datastore.getTotalAcPowerDigits());
-    addTotalField(totalObj, "YieldDay", Datastore.getTotalAcYieldDayEnabled(), "Wh", Datastore.getTotalAcYieldDayDigits());
-    addTotalField(totalObj, "YieldTotal", Datastore.getTotalAcYieldTotalEnabled(), "kWh", Datastore.getTotalAcYieldTotalDigits());
+    auto totals = Datastore.getSnapshot();
+    addTotalField(totalObj, "Power", totals.totalAcPowerEnabled, "W", totals.totalAcPowerDigits);
+    addTotalField(totalObj, "YieldDay", totals.totalAcYieldDayEnabled, "Wh", totals.totalAcYieldDayDigits);
+    addTotalField(totalObj, "YieldTotal", totals.totalAcYieldTotalEnabled, "kWh", totals.totalAcYieldTotalDigits);
 
     JsonObject hintObj = root.createNestedObject("hints");
     struct tm timeinfo;
@@ -217,24 +218,43 @@ void WebApiWsLiveClass::generateJsonResponse(JsonVariant& root)
 
     JsonObject powerMeterObj = root.createNestedObject("power_meter");
     powerMeterObj[F("enabled")] = Configuration.get().PowerMeter_Enabled;
-    addTotalField(powerMeterObj, "Power", PowerMeter.getPowerTotal(false), "W", 1);
+    addTotalField(powerMeterObj, "Power", PowerMeter.getPowerTotal(), "W", 1);
 
 }
 
-void WebApiWsLiveClass::addField(JsonObject& root, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, String topic)
+DynamicJsonDocument& WebApiWsLiveClass::getDocument()
+{
+    // kept for the whole uptime, only reallocated if inverters were added
+    // or removed, so publishing does not fragment the heap
+    size_t size = getDocumentSize();
+    if (!_doc || _docSize != size) {
+        _doc.reset();
+        _doc = std::make_unique<DynamicJsonDocument>(size);
+        _docSize = size;
+    }
+    _doc->clear();
+    return *_doc;
+}
+
+size_t WebApiWsLiveClass::getDocumentSize()
+{
+    // TODO(helge) check if this calculation is correct
+    return 4096 * Hoymiles.getNumInverters() + 2048;
+}
+
+void WebApiWsLiveClass::addField(JsonObject& root, uint8_t idx, std::shared_ptr<InverterAbstract> inv, ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, const char* topic)
 {
     if (inv->Statistics()->hasChannelFieldValue(type, channel, fieldId)) {
-        String chanName;
-        if (topic == "") {
+        const char* chanName = topic;
+        if (chanName == nullptr) {
             chanName = inv->Statistics()->getChannelFieldName(type, channel, fieldId);
-        } else {
-            chanName = topic;
         }
-        String chanNum;
-        chanNum = channel;
-        root[chanNum][chanName]["v"] = inv->Statistics()->getChannelFieldValue(type, channel, fieldId);
-        root[chanNum][chanName]["u"] = inv->Statistics()->getChannelFieldUnit(type, channel, fieldId);
-        root[chanNum][chanName]["d"] = inv->Statistics()->getChannelFieldDigits(type, channel, fieldId);
+        char chanNum[4];
+        snprintf(chanNum, sizeof(chanNum), "%u", static_cast<uint8_t>(channel));
+        JsonObject fieldObj = root[chanNum].createNestedObject(chanName);
+        fieldObj["v"] = inv->Statistics()->getChannelFieldValue(type, channel, fieldId);
+        fieldObj["u"] = inv->Statistics()->getChannelFieldUnit(type, channel, fieldId);
+        fieldObj["d"] = inv->Statistics()->getChannelFieldDigits(type, channel, fieldId);
     }
 }
 
@@ -247,6 +267,8 @@ void WebApiWsLiveClass::addTotalField(JsonObject& root, String name, float value
 
 void WebApiWsLiveClass::onWebsocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len)
 {
+    _publisher.onWebsocketEvent(client, type, arg, data, len);
+
     if (type == WS_EVT_CONNECT) {
         MessageOutput.printf("Websocket: [%s][%u] connect\r\n", server->url(), client->id());
     } else if (type == WS_EVT_DISCONNECT) {
@@ -262,7 +284,7 @@ void WebApiWsLiveClass::onLivedataStatus(AsyncWebServerRequest* request)
 
     try {
         std::lock_guard<std::mutex> lock(_mutex);
-        AsyncJsonResponse* response = new AsyncJsonResponse(false, 4096 * INV_MAX_COUNT);
+        AsyncJsonResponse* response = new AsyncJsonResponse(false, getDocumentSize());
         JsonVariant root = response->getRoot();
 
         generateJsonResponse(root);
@@ -13,6 +13,7 @@
 
 WebApiWsVedirectLiveClass::WebApiWsVedirectLiveClass()
     : _ws("/vedirectlivedata")
+    , _publisher(_ws)
 {
 }
 
@@ -66,28 +67,21 @@ void WebApiWsVedirectLiveClass::loop()
     }
 
     // Update on ve.direct change or at least after 10 seconds
-    if (millis() - _lastWsPublish > (10 * 1000) || immediateUpdate) {
+    if (millis() - _lastWsPublish > (10 * 1000) || immediateUpdate || _publisher.isPublishRequested()) {
         
         try {
-            String buffer;
-            // free JsonDocument as soon as possible
-            {
-                DynamicJsonDocument root(_responseSize * VICTRON_COUNT);
-                JsonVariant var = root;
-                generateJsonResponse(var);
-                serializeJson(root, buffer);
-            }
-            
-            if (buffer) {        
-                if (Configuration.get().Security_AllowReadonly) {
-                    _ws.setAuthentication("", "");
-                } else {
-                    _ws.setAuthentication(AUTH_USERNAME, Configuration.get().Security_Password);
-                }
-
-                _ws.textAll(buffer);
+            DynamicJsonDocument root(_responseSize * VICTRON_COUNT);
+            JsonVariant var = root;
+            generateJsonResponse(var);
+
+            if (Configuration.get().Security_AllowReadonly) {
+                _ws.setAuthentication("", "");
+            } else {
+                _ws.setAuthentication(AUTH_USERNAME, Configuration.get().Security_Password);
             }
 
+            _publisher.publish(root);
+
         } catch (std::bad_alloc& bad_alloc) {
             MessageOutput.printf("Calling /api/vedirectlivedata/status has temporarily run out of resources. Reason: \"%s\".\r\n", bad_alloc.what());
         }
@@ -179,6 +173,8 @@ void WebApiWsVedirectLiveClass::generateJsonResponse(JsonVariant& root)
 
 void WebApiWsVedirectLiveClass::onWebsocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len)
 {
+    _publisher.onWebsocketEvent(client, type, arg, data, len);
+
     if (type == WS_EVT_CONNECT) {
         char str[64];
         snprintf(str, sizeof(str), "Websocket: [%s][%u] connect", server->url(), client->id());
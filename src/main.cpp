@@ -7,6 +7,7 @@
 #include "Display_Graphic.h"
 #include "InverterSettings.h"
 #include "Led_Single.h"
+#include "LoopProfiler.h"
 #include "MessageOutput.h"
 #include "VeDirectMpptController.h"
 #include "Battery.h"
@@ -44,6 +45,7 @@ void setup()
     while (!Serial)
         yield();
 #endif
+    MessageOutput.init();
     MessageOutput.println();
     MessageOutput.println("Starting OpenDTU");
 
@@ -195,56 +197,62 @@ void setup()
 
 void loop()
 {
+    using Section = LoopProfilerClass::Section;
+
+    LoopProfiler.startLoop();
+
     NetworkSettings.loop();
-    yield();
+    LoopProfiler.endSection(Section::NetworkSettings);
     PowerMeter.loop();
-    yield();
+    LoopProfiler.endSection(Section::PowerMeter);
     PowerLimiter.loop();
-    yield();
+    LoopProfiler.endSection(Section::PowerLimiter);
     InverterSettings.loop();
-    yield();
+    LoopProfiler.endSection(Section::InverterSettings);
     Datastore.loop();
-    yield();
+    LoopProfiler.endSection(Section::Datastore);
     // Vedirect_Enabled is unknown to lib. Therefor check has to be done here
     if (Configuration.get().Vedirect_Enabled) {
         for (int8_t i = 0; i < VICTRON_COUNT; i++)
         {
             VeDirectMppt[i].loop();
-            yield();
+            LoopProfiler.endSection(Section::VeDirectMppt);
         }    
     }
     MqttSettings.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttSettings);
     MqttHandleDtu.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandleDtu);
     MqttHandleInverter.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandleInverter);
     MqttHandleInverterTotal.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandleInverterTotal);
     MqttHandleVedirect.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandleVedirect);
     MqttHandleHass.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandleHass);
     MqttHandleVedirectHass.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandleVedirectHass);
     MqttHandleHuawei.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandleHuawei);
     MqttHandlePowerLimiter.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandlePowerLimiter);
     WebApi.loop();
-    yield();
+    LoopProfiler.endSection(Section::WebApi);
     Display.loop();
-    yield();
+    LoopProfiler.endSection(Section::Display);
     SunPosition.loop();
-    yield();
+    LoopProfiler.endSection(Section::SunPosition);
     MessageOutput.loop();
-    yield();
+    LoopProfiler.endSection(Section::MessageOutput);
     Battery.loop();
-    yield();
+    LoopProfiler.endSection(Section::Battery);
     MqttHandlePylontechHass.loop();
-    yield();
+    LoopProfiler.endSection(Section::MqttHandlePylontechHass);
     HuaweiCan.loop();
-    yield();
+    LoopProfiler.endSection(Section::HuaweiCan);
     LedSingle.loop();
-    yield();
+    LoopProfiler.endSection(Section::LedSingle);
+    Configuration.loop();
+    LoopProfiler.endSection(Section::Configuration);
 }
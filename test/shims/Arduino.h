@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// host stand-in for the parts of the Arduino core used by the code under
+// test. time is simulated, see VirtualClock.h
+#include "HardwareSerial.h"
+#include "IPAddress.h"
+#include "Print.h"
+#include "Stream.h"
+#include "VirtualClock.h"
+#include "WString.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#define F(string_literal) (string_literal)
+
+#define NOT_A_PIN -1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define LOW 0x0
+#define HIGH 0x1
+
+typedef uint8_t byte;
+
+inline uint32_t millis() { return VirtualClock::micros() / 1000; }
+inline uint32_t micros() { return VirtualClock::micros(); }
+inline void delay(uint32_t ms) { VirtualClock::advanceMillis(ms); }
+inline void yield() { }
+
+inline void pinMode(uint8_t, uint8_t) { }
+inline void digitalWrite(uint8_t, uint8_t) { }
+
+// part of newlib, but of glibc only since 2.38
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+inline size_t strlcpy(char* dst, const char* src, size_t size)
+{
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = std::min(len, size - 1);
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+inline bool getLocalTime(struct tm* info, uint32_t = 5000) { return VirtualClock::getLocalTime(info); }
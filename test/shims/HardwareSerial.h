@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "Stream.h"
+#include <cstring>
+#include <deque>
+#include <map>
+
+#define SERIAL_8N1 0x800001c
+
+// UART whose received bytes are written by a simulated device, see
+// receive(). the firmware creates some of its serials itself, so the
+// bytes are queued by port number.
+class HardwareSerial : public Stream {
+public:
+    explicit HardwareSerial(int uartNr)
+        : _uartNr(uartNr)
+    {
+    }
+
+    void begin(unsigned long, uint32_t = SERIAL_8N1, int8_t = -1, int8_t = -1, bool = false, unsigned long = 20000, uint8_t = 112) { }
+    void end() { }
+    void flush() { }
+
+    int available() override { return rxQueue(_uartNr).size(); }
+    int read() override
+    {
+        auto& queue = rxQueue(_uartNr);
+        if (queue.empty()) {
+            return -1;
+        }
+        uint8_t c = queue.front();
+        queue.pop_front();
+        return c;
+    }
+    int peek() override { return rxQueue(_uartNr).empty() ? -1 : rxQueue(_uartNr).front(); }
+
+    // transmitted bytes are discarded
+    size_t write(uint8_t) override { return 1; }
+    using Print::write;
+
+    // called by the simulated device connected to the given port
+    static void receive(int uartNr, const uint8_t* data, size_t len) { rxQueue(uartNr).insert(rxQueue(uartNr).end(), data, data + len); }
+    static void receive(int uartNr, const char* data) { receive(uartNr, reinterpret_cast<const uint8_t*>(data), strlen(data)); }
+
+private:
+    static std::deque<uint8_t>& rxQueue(int uartNr)
+    {
+        static std::map<int, std::deque<uint8_t>> queues;
+        return queues[uartNr];
+    }
+
+    int _uartNr;
+};
+
+inline HardwareSerial Serial(0);
+inline HardwareSerial Serial2(2);
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "WString.h"
+#include <cstdint>
+#include <cstdio>
+
+class IPAddress {
+public:
+    IPAddress() = default;
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _address { a, b, c, d }
+    {
+    }
+    explicit IPAddress(const uint8_t* address)
+        : _address { address[0], address[1], address[2], address[3] }
+    {
+    }
+
+    bool fromString(const char* address)
+    {
+        unsigned a, b, c, d;
+        char end;
+        if (sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+            return false;
+        }
+        *this = IPAddress(a, b, c, d);
+        return true;
+    }
+    bool fromString(const String& address) { return fromString(address.c_str()); }
+
+    String toString() const
+    {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", _address[0], _address[1], _address[2], _address[3]);
+        return String(buffer);
+    }
+
+    uint8_t operator[](int index) const { return _address[index]; }
+    uint8_t& operator[](int index) { return _address[index]; }
+
+private:
+    uint8_t _address[4] = {};
+};
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// LittleFS backed by a directory of the host, see setRoot()
+#include "Stream.h"
+#include "WString.h"
+#include <cstdio>
+#include <string>
+
+class File : public Stream {
+public:
+    File() = default;
+    File(FILE* file, void (*hook)())
+        : _file(file)
+        , _hook(hook)
+    {
+    }
+
+    explicit operator bool() const { return _file != nullptr; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        access();
+        return _file ? fwrite(buffer, 1, size, _file) : 0;
+    }
+    using Print::write;
+
+    int available() override
+    {
+        if (!_file) {
+            return 0;
+        }
+        long position = ftell(_file);
+        fseek(_file, 0, SEEK_END);
+        long end = ftell(_file);
+        fseek(_file, position, SEEK_SET);
+        return end - position;
+    }
+    int read() override
+    {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+    size_t read(uint8_t* buffer, size_t size)
+    {
+        access();
+        return _file ? fread(buffer, 1, size, _file) : 0;
+    }
+    int peek() override
+    {
+        if (!_file) {
+            return -1;
+        }
+        int c = fgetc(_file);
+        if (c != EOF) {
+            ungetc(c, _file);
+        }
+        return c == EOF ? -1 : c;
+    }
+
+    size_t size() const
+    {
+        if (!_file) {
+            return 0;
+        }
+        long position = ftell(_file);
+        fseek(_file, 0, SEEK_END);
+        long end = ftell(_file);
+        fseek(_file, position, SEEK_SET);
+        return end;
+    }
+
+    void close()
+    {
+        if (_file) {
+            fclose(_file);
+            _file = nullptr;
+        }
+    }
+
+private:
+    void access()
+    {
+        if (_hook) {
+            _hook();
+        }
+    }
+
+    FILE* _file = nullptr;
+    void (*_hook)() = nullptr;
+};
+
+class LittleFSFS {
+public:
+    // directory the paths of the file system are relative to
+    void setRoot(const std::string& root) { _root = root; }
+
+    // called on every read or write of a file, e.g. to sample the heap
+    // while the file is accessed
+    void setAccessHook(void (*hook)()) { _hook = hook; }
+
+    File open(const String& path, const char* mode = "r", bool = false) { return File(fopen(hostPath(path).c_str(), mode[0] == 'w' ? "wb" : "rb"), _hook); }
+    bool exists(const String& path) { return access(hostPath(path).c_str()); }
+    bool remove(const String& path) { return ::remove(hostPath(path).c_str()) == 0; }
+    bool rename(const String& from, const String& to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+
+private:
+    std::string hostPath(const String& path) const { return _root + path.c_str(); }
+    static bool access(const char* path)
+    {
+        FILE* file = fopen(path, "rb");
+        if (file) {
+            fclose(file);
+        }
+        return file != nullptr;
+    }
+
+    std::string _root = ".";
+    void (*_hook)() = nullptr;
+};
+
+inline LittleFSFS LittleFS;
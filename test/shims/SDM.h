@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+
+// SDM energy meter which never answers. the registers and the block read
+// interface match lib/SdmEnergyMeter.
+#define SDM_MAX_BLOCK_VALUES 10
+#define SDM_BLOCK_PENDING 0
+#define SDM_BLOCK_DONE 1
+#define SDM_BLOCK_ERROR 2
+
+#define SDM_PHASE_1_VOLTAGE 0x0000
+#define SDM_PHASE_1_POWER 0x000C
+#define SDM_IMPORT_ACTIVE_ENERGY 0x0048
+
+#define SDM_B_01 0x01
+
+class SDM {
+public:
+    SDM(HardwareSerial&, long = 9600, int = NOT_A_PIN, int = SERIAL_8N1, int8_t = -1, int8_t = -1) { }
+
+    void begin() { }
+    bool startBlockRead(uint16_t, uint8_t, uint8_t = SDM_B_01) { return true; }
+    uint8_t pollBlockRead(float*) { return SDM_BLOCK_PENDING; }
+    uint16_t getErrCode(bool = false) { return 0; }
+};
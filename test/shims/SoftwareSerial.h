@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "Stream.h"
+#include <cstring>
+#include <deque>
+
+enum SoftwareSerialConfig {
+    SWSERIAL_8N1 = 0x1c
+};
+
+// software UART, the simulated device writes its bytes with receive()
+class SoftwareSerial : public Stream {
+public:
+    void begin(uint32_t, SoftwareSerialConfig = SWSERIAL_8N1, int8_t = -1, int8_t = -1, bool = false, int = 64, int = 0) { }
+    void enableRx(bool) { }
+    void enableTx(bool) { }
+    void flush() { }
+
+    int available() override { return _rx.size(); }
+    int read() override
+    {
+        if (_rx.empty()) {
+            return -1;
+        }
+        uint8_t c = _rx.front();
+        _rx.pop_front();
+        return c;
+    }
+    int peek() override { return _rx.empty() ? -1 : _rx.front(); }
+
+    size_t write(uint8_t) override { return 1; }
+    using Print::write;
+
+    void receive(const uint8_t* data, size_t len) { _rx.insert(_rx.end(), data, data + len); }
+
+private:
+    std::deque<uint8_t> _rx;
+};
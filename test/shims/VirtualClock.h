@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+// simulated time of the host tests. millis() and micros() return it and it
+// only advances if a test advances it or the code under test calls delay(),
+// so the results do not depend on the speed of the host.
+class VirtualClock {
+public:
+    static uint64_t micros() { return _micros; }
+    static void advanceMicros(uint64_t us) { _micros += us; }
+    static void advanceMillis(uint32_t ms) { _micros += static_cast<uint64_t>(ms) * 1000; }
+
+    // starts over at the given uptime without a valid local time
+    static void reset(uint32_t ms = 0)
+    {
+        _micros = static_cast<uint64_t>(ms) * 1000;
+        _epochAtZero = 0;
+    }
+
+    // makes getLocalTime() succeed, as if NTP synchronized to the given
+    // UTC time now
+    static void setLocalTime(time_t epoch) { _epochAtZero = epoch - static_cast<time_t>(_micros / 1000000); }
+
+    static bool getLocalTime(struct tm* info)
+    {
+        if (_epochAtZero == 0) {
+            return false;
+        }
+        time_t now = _epochAtZero + static_cast<time_t>(_micros / 1000000);
+        return gmtime_r(&now, info) != nullptr;
+    }
+
+private:
+    static inline uint64_t _micros = 0;
+    static inline time_t _epochAtZero = 0;
+};
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// the parts of the Arduino String used by the code under test
+class String {
+public:
+    String(const char* s = "")
+        : _s(s != nullptr ? s : "")
+    {
+    }
+    String(const std::string& s)
+        : _s(s)
+    {
+    }
+    explicit String(char c)
+        : _s(1, c)
+    {
+    }
+    String(int value, unsigned char base = 10) { format(base == 16 ? "%x" : "%d", value); }
+    String(unsigned int value, unsigned char base = 10) { format(base == 16 ? "%x" : "%u", value); }
+    String(long value, unsigned char base = 10) { format(base == 16 ? "%lx" : "%ld", value); }
+    String(unsigned long value, unsigned char base = 10) { format(base == 16 ? "%lx" : "%lu", value); }
+    String(float value, unsigned int decimals = 2) { format("%.*f", static_cast<int>(decimals), static_cast<double>(value)); }
+    String(double value, unsigned int decimals = 2) { format("%.*f", static_cast<int>(decimals), value); }
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return _s.length(); }
+    bool isEmpty() const { return _s.empty(); }
+    bool reserve(unsigned int size)
+    {
+        _s.reserve(size);
+        return true;
+    }
+
+    bool concat(const String& s)
+    {
+        _s += s._s;
+        return true;
+    }
+    bool concat(const char* s)
+    {
+        _s += s;
+        return true;
+    }
+    bool concat(char c)
+    {
+        _s += c;
+        return true;
+    }
+    String& operator+=(const String& s)
+    {
+        concat(s);
+        return *this;
+    }
+    String& operator+=(const char* s)
+    {
+        concat(s);
+        return *this;
+    }
+    String& operator+=(char c)
+    {
+        concat(c);
+        return *this;
+    }
+
+    char operator[](unsigned int index) const { return index < _s.length() ? _s[index] : 0; }
+    bool operator==(const String& s) const { return _s == s._s; }
+    bool operator==(const char* s) const { return _s == s; }
+    bool operator!=(const String& s) const { return _s != s._s; }
+    bool operator!=(const char* s) const { return _s != s; }
+    bool operator<(const String& s) const { return _s < s._s; }
+
+    int indexOf(char c, unsigned int from = 0) const { return find(_s.find(c, from)); }
+    int indexOf(const String& s, unsigned int from = 0) const { return find(_s.find(s._s, from)); }
+    bool startsWith(const String& s) const { return _s.compare(0, s._s.length(), s._s) == 0; }
+    bool endsWith(const String& s) const
+    {
+        return _s.length() >= s._s.length() && _s.compare(_s.length() - s._s.length(), s._s.length(), s._s) == 0;
+    }
+    String substring(unsigned int from) const { return substring(from, _s.length()); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > _s.length() || to < from) {
+            return String();
+        }
+        return String(_s.substr(from, to - from));
+    }
+
+    long toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(_s.c_str(), nullptr); }
+    double toDouble() const { return strtod(_s.c_str(), nullptr); }
+
+private:
+    template <typename T>
+    void format(const char* fmt, T value)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), fmt, value);
+        _s = buffer;
+    }
+    void format(const char* fmt, int decimals, double value)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), fmt, decimals, value);
+        _s = buffer;
+    }
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : static_cast<int>(pos); }
+
+    std::string _s;
+};
+
+// the type of concatenations in the Arduino core, some libraries name it
+class StringSumHelper : public String {
+public:
+    using String::String;
+    StringSumHelper(const String& s)
+        : String(s)
+    {
+    }
+};
+
+inline StringSumHelper operator+(const String& lhs, const String& rhs)
+{
+    StringSumHelper sum(lhs);
+    sum += rhs;
+    return sum;
+}
+
+inline StringSumHelper operator+(const String& lhs, const char* rhs)
+{
+    StringSumHelper sum(lhs);
+    sum += rhs;
+    return sum;
+}
+
+inline StringSumHelper operator+(const char* lhs, const String& rhs)
+{
+    StringSumHelper sum(lhs);
+    sum += rhs;
+    return sum;
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "FreeRTOS.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// binary semaphore based on the standard library
+struct StaticSemaphore_t {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool given = false;
+};
+
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* buffer)
+{
+    return buffer;
+}
+
+inline int xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    {
+        std::lock_guard<std::mutex> lock(semaphore->mutex);
+        if (semaphore->given) {
+            return pdFALSE;
+        }
+        semaphore->given = true;
+    }
+    semaphore->cv.notify_one();
+    return pdTRUE;
+}
+
+inline int xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    auto given = [semaphore] { return semaphore->given; };
+    if (ticksToWait == portMAX_DELAY) {
+        semaphore->cv.wait(lock, given);
+    } else if (!semaphore->cv.wait_for(lock, std::chrono::milliseconds(ticksToWait), given)) {
+        return pdFALSE;
+    }
+    semaphore->given = false;
+    return pdTRUE;
+}
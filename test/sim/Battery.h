@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+// battery interface reporting a state of charge set by the test
+class BatteryStats {
+public:
+    uint8_t getSoC() const { return _SoC; }
+    uint32_t getSoCAgeSeconds() const { return (millis() - _lastUpdateSoC) / 1000; }
+    bool isValid() const { return _lastUpdateSoC > 0; }
+
+    void setSoC(uint8_t soc)
+    {
+        _SoC = soc;
+        _lastUpdateSoC = millis();
+    }
+
+private:
+    uint8_t _SoC = 0;
+    uint32_t _lastUpdateSoC = 0;
+};
+
+class BatteryClass {
+public:
+    std::shared_ptr<BatteryStats const> getStats() const { return _stats; }
+    BatteryStats& getSimulatedStats() { return *_stats; }
+
+private:
+    std::shared_ptr<BatteryStats> _stats = std::make_shared<BatteryStats>();
+};
+
+inline BatteryClass Battery;
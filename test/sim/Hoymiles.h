@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Simulated Hoymiles library. An inverter applies commands only after the
+// round trip of the radio and reports its output at the poll interval, the
+// delays the power limiter has to cope with. The interface is the part of
+// lib/Hoymiles used by the firmware modules under simulation.
+#include <Arduino.h>
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+typedef enum {
+    CMD_OK,
+    CMD_NOK,
+    CMD_PENDING
+} LastCommandSuccess;
+
+typedef enum {
+    AbsolutNonPersistent = 0x0000,
+    RelativNonPersistent = 0x0001,
+    AbsolutPersistent = 0x0100,
+    RelativPersistent = 0x0101
+} PowerLimitControlType;
+
+enum FieldId_t {
+    FLD_UDC = 0,
+    FLD_IDC,
+    FLD_PDC,
+    FLD_YD,
+    FLD_YT,
+    FLD_UAC,
+    FLD_IAC,
+    FLD_PAC,
+    FLD_F,
+    FLD_T,
+    FLD_PF,
+    FLD_EFF,
+    FLD_IRR,
+    FLD_Q,
+    FLD_EVT_LOG,
+    FLD_COUNT
+};
+
+enum ChannelNum_t {
+    CH0 = 0,
+    CH1,
+    CH2,
+    CH3,
+    CH4,
+    CH5,
+    CH_CNT
+};
+
+enum ChannelType_t {
+    TYPE_AC = 0,
+    TYPE_DC,
+    TYPE_INV,
+    TYPE_CNT
+};
+
+class StatisticsParser {
+public:
+    float getChannelFieldValue(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId) { return _values[type][channel][fieldId]; }
+    void setChannelFieldValue(ChannelType_t type, ChannelNum_t channel, FieldId_t fieldId, float value) { _values[type][channel][fieldId] = value; }
+
+    const std::list<ChannelNum_t>& getChannelsByType(ChannelType_t type) { return _channels[type]; }
+    void addChannel(ChannelType_t type, ChannelNum_t channel) { _channels[type].push_back(channel); }
+
+    uint32_t getLastUpdate() { return _lastUpdate; }
+    void setLastUpdate(uint32_t lastUpdate) { _lastUpdate = lastUpdate; }
+
+private:
+    float _values[TYPE_CNT][CH_CNT][FLD_COUNT] = {};
+    std::list<ChannelNum_t> _channels[TYPE_CNT];
+    uint32_t _lastUpdate = 0;
+};
+
+class SystemConfigParaParser {
+public:
+    LastCommandSuccess getLastLimitCommandSuccess() { return _lastLimitCommandSuccess; }
+    void setLastLimitCommandSuccess(LastCommandSuccess status) { _lastLimitCommandSuccess = status; }
+    uint32_t getLastUpdateCommand() { return _lastUpdateCommand; }
+    void setLastUpdateCommand(uint32_t lastUpdate) { _lastUpdateCommand = lastUpdate; }
+
+private:
+    LastCommandSuccess _lastLimitCommandSuccess = CMD_OK;
+    uint32_t _lastUpdateCommand = 0;
+};
+
+class PowerCommandParser {
+public:
+    LastCommandSuccess getLastPowerCommandSuccess() { return _lastPowerCommandSuccess; }
+    void setLastPowerCommandSuccess(LastCommandSuccess status) { _lastPowerCommandSuccess = status; }
+    uint32_t getLastUpdateCommand() { return _lastUpdateCommand; }
+    void setLastUpdateCommand(uint32_t lastUpdate) { _lastUpdateCommand = lastUpdate; }
+
+private:
+    LastCommandSuccess _lastPowerCommandSuccess = CMD_OK;
+    uint32_t _lastUpdateCommand = 0;
+};
+
+class DevInfoParser {
+public:
+    explicit DevInfoParser(uint16_t maxPower)
+        : _maxPower(maxPower)
+    {
+    }
+    uint16_t getMaxPower() { return _maxPower; }
+
+private:
+    uint16_t _maxPower;
+};
+
+// single DC input inverter fed by a battery
+class InverterAbstract {
+public:
+    struct Model {
+        uint16_t maxPower = 800;
+        float dcVoltage = 52.0;
+        float efficiency = 0.95;
+        uint32_t commandRoundTripMs = 600; // until the inverter acknowledged a command
+        uint32_t pollIntervalMs = 5000; // between two statistics of the DTU
+        float rampWattsPerSecond = 400; // the output follows a new limit at this rate
+    };
+
+    InverterAbstract(uint64_t serial, Model const& model)
+        : _serial(serial)
+        , _model(model)
+        , _devInfo(model.maxPower)
+        , _limit(model.maxPower)
+    {
+        _statistics.addChannel(TYPE_AC, CH0);
+        _statistics.addChannel(TYPE_DC, CH0);
+        _statistics.addChannel(TYPE_INV, CH0);
+    }
+
+    uint64_t serial() { return _serial; }
+
+    bool isProducing() { return _statistics.getChannelFieldValue(TYPE_AC, CH0, FLD_PAC) > 0; }
+    bool isReachable() { return _statistics.getLastUpdate() > 0; }
+    bool getEnableCommands() { return true; }
+    void setPollPriority(bool) { }
+
+    bool sendActivePowerControlRequest(float limit, PowerLimitControlType type)
+    {
+        if (type != AbsolutNonPersistent && type != AbsolutPersistent) {
+            limit = limit * _model.maxPower / 100;
+        }
+        _pendingLimit = limit;
+        _systemConfigPara.setLastLimitCommandSuccess(CMD_PENDING);
+        _commandDue = millis() + _model.commandRoundTripMs;
+        _commandCount++;
+        return true;
+    }
+
+    bool sendPowerControlRequest(bool turnOn)
+    {
+        _pendingProducing = turnOn;
+        _powerCommand.setLastPowerCommandSuccess(CMD_PENDING);
+        _commandDue = millis() + _model.commandRoundTripMs;
+        _commandCount++;
+        return true;
+    }
+
+    bool sendRestartControlRequest() { return sendPowerControlRequest(true); }
+
+    StatisticsParser* Statistics() { return &_statistics; }
+    SystemConfigParaParser* SystemConfigPara() { return &_systemConfigPara; }
+    PowerCommandParser* PowerCommand() { return &_powerCommand; }
+    DevInfoParser* DevInfo() { return &_devInfo; }
+
+    // completes due commands, moves the output towards the limit and polls
+    // the statistics. to be called with the main loop.
+    void loop()
+    {
+        uint32_t now = millis();
+
+        if (_commandDue != 0 && static_cast<int32_t>(now - _commandDue) >= 0) {
+            _commandDue = 0;
+            if (_systemConfigPara.getLastLimitCommandSuccess() == CMD_PENDING) {
+                _limit = std::min<float>(_pendingLimit, _model.maxPower);
+                _systemConfigPara.setLastLimitCommandSuccess(CMD_OK);
+                _systemConfigPara.setLastUpdateCommand(now);
+            }
+            if (_powerCommand.getLastPowerCommandSuccess() == CMD_PENDING) {
+                _producing = _pendingProducing;
+                _powerCommand.setLastPowerCommandSuccess(CMD_OK);
+                _powerCommand.setLastUpdateCommand(now);
+            }
+        }
+
+        float target = _producing ? _limit : 0;
+        float step = _model.rampWattsPerSecond * (now - _lastStep) / 1000;
+        _lastStep = now;
+        if (_output < target) {
+            _output = std::min(_output + step, target);
+        } else {
+            _output = std::max(_output - step, target);
+        }
+
+        if (_lastPoll == 0 || now - _lastPoll >= _model.pollIntervalMs) {
+            _lastPoll = now;
+            poll(now);
+        }
+    }
+
+    // the power fed into the grid at this very moment
+    float getOutputPower() const { return _output; }
+    float getLimit() const { return _limit; }
+    uint32_t getCommandCount() const { return _commandCount; }
+
+private:
+    void poll(uint32_t now)
+    {
+        float dcPower = _output / _model.efficiency;
+        _statistics.setChannelFieldValue(TYPE_AC, CH0, FLD_PAC, _output);
+        _statistics.setChannelFieldValue(TYPE_DC, CH0, FLD_UDC, _model.dcVoltage);
+        _statistics.setChannelFieldValue(TYPE_DC, CH0, FLD_PDC, dcPower);
+        _statistics.setChannelFieldValue(TYPE_DC, CH0, FLD_IDC, dcPower / _model.dcVoltage);
+        _statistics.setChannelFieldValue(TYPE_AC, CH0, FLD_EFF, _model.efficiency * 100);
+        _statistics.setLastUpdate(now);
+    }
+
+    uint64_t _serial;
+    Model _model;
+
+    StatisticsParser _statistics;
+    SystemConfigParaParser _systemConfigPara;
+    PowerCommandParser _powerCommand;
+    DevInfoParser _devInfo;
+
+    float _limit;
+    float _pendingLimit = 0;
+    bool _producing = true;
+    bool _pendingProducing = true;
+    uint32_t _commandDue = 0;
+    uint32_t _commandCount = 0;
+
+    float _output = 0;
+    uint32_t _lastStep = 0;
+    uint32_t _lastPoll = 0;
+};
+
+class HoymilesClass {
+public:
+    std::shared_ptr<InverterAbstract> addInverter(uint64_t serial, InverterAbstract::Model const& model)
+    {
+        _inverters.push_back(std::make_shared<InverterAbstract>(serial, model));
+        return _inverters.back();
+    }
+
+    std::shared_ptr<InverterAbstract> getInverterByPos(uint8_t pos)
+    {
+        if (pos >= _inverters.size()) {
+            return nullptr;
+        }
+        return _inverters[pos];
+    }
+
+    size_t getNumInverters() { return _inverters.size(); }
+
+    void loop()
+    {
+        for (auto& inverter : _inverters) {
+            inverter->loop();
+        }
+    }
+
+    void clear() { _inverters.clear(); }
+
+private:
+    std::vector<std::shared_ptr<InverterAbstract>> _inverters;
+};
+
+inline HoymilesClass Hoymiles;
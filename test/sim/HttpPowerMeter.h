@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "Configuration.h"
+#include <Arduino.h>
+
+// HTTP power meter which never completes a poll
+class HttpPowerMeterClass {
+public:
+    struct Reading {
+        float power[POWERMETER_MAX_PHASES];
+        float powerTotal;
+        uint32_t timestamp;
+    };
+
+    void init() { }
+    void requestUpdate() { }
+    Reading getReading() { return {}; }
+};
+
+inline HttpPowerMeterClass HttpPowerMeter;
@@ -0,0 +1,10 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// there is no Huawei charger in the simulation
+class HuaweiCanClass {
+public:
+    bool getAutoPowerStatus() { return false; }
+};
+
+inline HuaweiCanClass HuaweiCan;
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Print.h>
+#include <cstdio>
+
+// console of the simulated firmware, echoed to stdout if enabled
+class MessageOutputClass : public Print {
+public:
+    size_t write(uint8_t c) override
+    {
+        if (echo) {
+            fputc(c, stdout);
+        }
+        bytes++;
+        return 1;
+    }
+    using Print::write;
+
+    bool echo = false;
+    size_t bytes = 0;
+};
+
+inline MessageOutputClass MessageOutput;
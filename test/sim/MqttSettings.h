@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+#include <espMqttClient.h>
+#include <cstring>
+#include <map>
+
+// broker connection of the simulated firmware. simulated devices publish
+// with deliver(), the messages of the firmware are discarded.
+class MqttSettingsClass {
+public:
+    bool getConnected() { return false; }
+    void publish(const String&, const String&) { }
+    void publishGeneric(const String&, const String&, bool, uint8_t = 0) { }
+    bool publishGeneric(const char*, const char*, bool, uint8_t = 0) { return false; }
+    String getPrefix() { return "solar/"; }
+
+    void subscribe(const String& topic, uint8_t, const espMqttClientTypes::OnMessageCallback& cb) { _subscriptions[topic] = cb; }
+    void unsubscribe(const String& topic) { _subscriptions.erase(topic); }
+
+    // as if the broker sent the message to the firmware
+    void deliver(const char* topic, const char* payload)
+    {
+        auto it = _subscriptions.find(topic);
+        if (it == _subscriptions.end()) {
+            return;
+        }
+        espMqttClientTypes::MessageProperties properties = {};
+        size_t len = strlen(payload);
+        it->second(properties, topic, reinterpret_cast<const uint8_t*>(payload), len, 0, len);
+    }
+
+private:
+    std::map<String, espMqttClientTypes::OnMessageCallback> _subscriptions;
+};
+
+inline MqttSettingsClass MqttSettings;
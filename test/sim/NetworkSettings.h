@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// the simulated firmware has no network interface of its own, MQTT
+// messages are delivered by the MqttSettings stand-in
+class NetworkSettingsClass {
+public:
+    bool isConnected() const { return true; }
+};
+
+inline NetworkSettingsClass NetworkSettings;
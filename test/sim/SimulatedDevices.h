@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Scripted devices around the simulated firmware. They are advanced by
+// calling loop() with the main loop and talk to the firmware through the
+// same interfaces as the real devices: MQTT messages and UART bytes.
+#include "MqttSettings.h"
+#include <Arduino.h>
+#include <cstdio>
+#include <functional>
+
+// the household's grid connection. the power drawn from the grid is the
+// scripted load minus what the inverter feeds in.
+class SimulatedGrid {
+public:
+    explicit SimulatedGrid(std::function<float()> inverterOutput)
+        : _inverterOutput(inverterOutput)
+    {
+    }
+
+    void setLoad(float watts) { _load = watts; }
+    float getLoad() const { return _load; }
+    float getPower() const { return _load - _inverterOutput(); }
+
+private:
+    std::function<float()> _inverterOutput;
+    float _load = 0;
+};
+
+// power meter publishing the grid power to an MQTT topic
+class SimulatedMqttPowerMeter {
+public:
+    SimulatedMqttPowerMeter(SimulatedGrid const& grid, const char* topic, uint32_t intervalMs)
+        : _grid(grid)
+        , _topic(topic)
+        , _intervalMs(intervalMs)
+    {
+    }
+
+    void loop()
+    {
+        if (_lastPublish != 0 && millis() - _lastPublish < _intervalMs) {
+            return;
+        }
+        _lastPublish = millis();
+
+        char payload[16];
+        snprintf(payload, sizeof(payload), "%.1f", _grid.getPower());
+        MqttSettings.deliver(_topic, payload);
+    }
+
+private:
+    SimulatedGrid const& _grid;
+    const char* _topic;
+    uint32_t _intervalMs;
+    uint32_t _lastPublish = 0;
+};
+
+// Victron MPPT charge controller sending a VE.Direct text frame every second
+class SimulatedMppt {
+public:
+    SimulatedMppt(int uartNr, float batteryVoltage)
+        : _uartNr(uartNr)
+        , _batteryVoltage(batteryVoltage)
+    {
+    }
+
+    void setPanelPower(int32_t watts) { _panelPower = watts; }
+
+    void loop()
+    {
+        if (_lastFrame != 0 && millis() - _lastFrame < 1000) {
+            return;
+        }
+        _lastFrame = millis();
+
+        // charge current at 97 % efficiency, values in mV, mA and W
+        int32_t current = _panelPower * 970 / _batteryVoltage;
+        char frame[160];
+        int len = snprintf(frame, sizeof(frame),
+            "\r\nPID\t0xA053\r\nFW\t159\r\nSER#\tHQ2212SIM01\r\nV\t%d\r\nI\t%d\r\nVPV\t%d\r\nPPV\t%d"
+            "\r\nCS\t3\r\nMPPT\t2\r\nOR\t0x00000000\r\nERR\t0\r\nLOAD\tON\r\nChecksum\t",
+            static_cast<int>(_batteryVoltage * 1000), static_cast<int>(current), 75000, static_cast<int>(_panelPower));
+
+        // all bytes of a frame including the checksum add up to zero
+        uint8_t checksum = 0;
+        for (int i = 0; i < len; i++) {
+            checksum -= static_cast<uint8_t>(frame[i]);
+        }
+
+        HardwareSerial::receive(_uartNr, reinterpret_cast<const uint8_t*>(frame), len);
+        HardwareSerial::receive(_uartNr, &checksum, 1);
+    }
+
+private:
+    int _uartNr;
+    float _batteryVoltage;
+    int32_t _panelPower = 0;
+    uint32_t _lastFrame = 0;
+};
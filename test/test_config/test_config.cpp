@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unity.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <Configuration.cpp>
+
+static std::string _root;
+
+void setUp()
+{
+    char root[] = "/tmp/test_config_XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(root));
+    _root = root;
+    LittleFS.setRoot(_root);
+
+    // a file system without any configuration, the defaults are imported
+    Configuration.init();
+    Configuration.importJson();
+}
+
+void tearDown()
+{
+    std::string command = "rm -rf " + _root;
+    TEST_ASSERT_EQUAL(0, system(command.c_str()));
+}
+
+static void changeSettings()
+{
+    auto guard = Configuration.getWriteGuard();
+    CONFIG_T& config = guard.getConfig();
+    strlcpy(config.WiFi_Hostname, "test-host", sizeof(config.WiFi_Hostname));
+    config.Inverter[0].Serial = 0x114172218733ULL;
+    strlcpy(config.Inverter[0].Name, "roof", sizeof(config.Inverter[0].Name));
+    config.Inverter[0].channel[1].MaxChannelPower = 410;
+    config.PowerLimiter_Enabled = true;
+}
+
+void test_binary_round_trip()
+{
+    changeSettings();
+    TEST_ASSERT_TRUE(Configuration.write());
+    CONFIG_T written = Configuration.get();
+
+    Configuration.init();
+    TEST_ASSERT_TRUE(Configuration.read());
+    TEST_ASSERT_EQUAL(0, memcmp(&written, &Configuration.get(), sizeof(written)));
+}
+
+void test_rejected_binary_falls_back_to_flushed_json()
+{
+    changeSettings();
+    Configuration.requestWrite();
+    TEST_ASSERT_TRUE(Configuration.flush());
+    uint32_t saveCount = Configuration.get().Cfg_SaveCount;
+
+    // e.g. after an update changed CONFIG_T
+    TEST_ASSERT_TRUE(LittleFS.remove(CONFIG_BINARY_FILENAME));
+
+    Configuration.init();
+    TEST_ASSERT_TRUE(Configuration.read());
+    CONFIG_T const& config = Configuration.get();
+    TEST_ASSERT_EQUAL(0, strcmp(config.WiFi_Hostname, "test-host"));
+    TEST_ASSERT_TRUE(config.Inverter[0].Serial == 0x114172218733ULL);
+    TEST_ASSERT_EQUAL(410, config.Inverter[0].channel[1].MaxChannelPower);
+    // read() writes the imported settings to a new binary file
+    TEST_ASSERT_EQUAL(saveCount + 1, config.Cfg_SaveCount);
+}
+
+// the heap in use is sampled on every access to a file, the buffers of a
+// load or save are all alive while the file is read or written
+static size_t heapInUse()
+{
+#if defined(__GLIBC__)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+static size_t _peakHeap;
+
+static void sampleHeap()
+{
+    _peakHeap = std::max(_peakHeap, heapInUse());
+}
+
+struct Measurement {
+    double microseconds;
+    size_t peakHeapBytes;
+    bool success;
+};
+
+template <typename F>
+static Measurement measure(F func)
+{
+    constexpr int ITERATIONS = 200;
+
+    // the heap is measured on a separate run, sampling it takes time
+    size_t baseline = heapInUse();
+    _peakHeap = baseline;
+    LittleFS.setAccessHook(sampleHeap);
+    bool success = func();
+    LittleFS.setAccessHook(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        success &= func();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return { std::chrono::duration<double, std::micro>(end - start).count() / ITERATIONS,
+        _peakHeap - baseline, success };
+}
+
+static void reportMeasurements(const char* operation, Measurement binary, Measurement json)
+{
+    TEST_ASSERT_TRUE(binary.success);
+    TEST_ASSERT_TRUE(json.success);
+
+    char message[160];
+    snprintf(message, sizeof(message), "%s: binary %.1f us, %u bytes heap, JSON %.1f us, %u bytes heap",
+        operation, binary.microseconds, static_cast<unsigned>(binary.peakHeapBytes),
+        json.microseconds, static_cast<unsigned>(json.peakHeapBytes));
+    TEST_MESSAGE(message);
+}
+
+void test_load_and_save_benchmark()
+{
+    // the host file system and allocator are much faster than the flash and
+    // heap of the ESP32, the ratio between the formats is what carries over
+    changeSettings();
+    TEST_ASSERT_TRUE(Configuration.write());
+    TEST_ASSERT_TRUE(Configuration.exportJson());
+
+    reportMeasurements("save",
+        measure([] { return Configuration.write(); }),
+        measure([] { return Configuration.exportJson(); }));
+
+    reportMeasurements("load",
+        measure([] { return Configuration.read(); }),
+        measure([] { return Configuration.importJson(); }));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_binary_round_trip);
+    RUN_TEST(test_rejected_binary_falls_back_to_flushed_json);
+    RUN_TEST(test_load_and_save_benchmark);
+    return UNITY_END();
+}
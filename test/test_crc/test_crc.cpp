@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unity.h>
+
+// the Hoymiles library is not built for the host, only its CRC kernels
+#include <crc.cpp>
+
+// bitwise reference implementations the lookup tables have to match
+static uint8_t referenceCrc8(const uint8_t buf[], uint8_t len)
+{
+    uint8_t crc = CRC8_INIT;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc << 1) ^ ((crc & 0x80) ? CRC8_POLY : 0x00);
+        }
+    }
+    return crc;
+}
+
+static uint16_t referenceCrc16(const uint8_t buf[], uint8_t len, uint16_t start)
+{
+    uint16_t crc = start;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x0001) ? ((crc >> 1) ^ CRC16_MODBUS_POLYNOM) : (crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t referenceCrc16nrf24(const uint8_t buf[], uint16_t lenBits, uint16_t startBit, uint16_t crcIn)
+{
+    uint16_t crc = crcIn;
+    uint8_t idx, val = buf[(startBit >> 3)];
+
+    for (uint16_t bit = startBit; bit < lenBits; bit++) {
+        idx = bit & 0x07;
+        if (0 == idx)
+            val = buf[(bit >> 3)];
+        crc ^= 0x8000 & (val << (8 + idx));
+        crc = (crc & 0x8000) ? ((crc << 1) ^ CRC16_NRF24_POLYNOM) : (crc << 1);
+    }
+
+    return crc;
+}
+
+static uint8_t _buffer[256];
+
+void setUp()
+{
+    std::mt19937 random(42);
+    for (auto& b : _buffer) {
+        b = random();
+    }
+}
+
+void tearDown()
+{
+}
+
+void test_crc8_matches_reference()
+{
+    for (uint16_t len = 0; len < sizeof(_buffer); len++) {
+        TEST_ASSERT_EQUAL_HEX8(referenceCrc8(_buffer, len), crc8(_buffer, len));
+    }
+}
+
+void test_crc16_matches_reference()
+{
+    for (uint16_t len = 0; len < sizeof(_buffer); len++) {
+        TEST_ASSERT_EQUAL_HEX16(referenceCrc16(_buffer, len, 0xffff), crc16(_buffer, len));
+        TEST_ASSERT_EQUAL_HEX16(referenceCrc16(_buffer, len, 0x1234), crc16(_buffer, len, 0x1234));
+    }
+}
+
+void test_crc16nrf24_matches_reference()
+{
+    // the radio computes the crc over bit ranges which are not byte aligned
+    for (uint16_t startBit = 0; startBit < 24; startBit++) {
+        for (uint16_t lenBits = startBit; lenBits < 8 * 40; lenBits++) {
+            TEST_ASSERT_EQUAL_HEX16(referenceCrc16nrf24(_buffer, lenBits, startBit, 0xffff),
+                crc16nrf24(_buffer, lenBits, startBit));
+        }
+    }
+}
+
+template <typename F>
+static double nanosecondsPerCall(F func)
+{
+    constexpr int ITERATIONS = 200000;
+    volatile uint32_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        _buffer[0] = i;
+        sink = sink + func();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+void test_crc_benchmark()
+{
+    // a request packet: 27 bytes, crc16 over the 14 payload bytes and
+    // crc16nrf24 over the whole packet shifted by one bit
+    char message[160];
+
+    snprintf(message, sizeof(message), "crc8 27 bytes: table %.1f ns, bitwise %.1f ns",
+        nanosecondsPerCall([] { return crc8(_buffer, 27); }),
+        nanosecondsPerCall([] { return referenceCrc8(_buffer, 27); }));
+    TEST_MESSAGE(message);
+
+    snprintf(message, sizeof(message), "crc16 14 bytes: table %.1f ns, bitwise %.1f ns",
+        nanosecondsPerCall([] { return crc16(_buffer, 14); }),
+        nanosecondsPerCall([] { return referenceCrc16(_buffer, 14, 0xffff); }));
+    TEST_MESSAGE(message);
+
+    snprintf(message, sizeof(message), "crc16nrf24 217 bits: table %.1f ns, bitwise %.1f ns",
+        nanosecondsPerCall([] { return crc16nrf24(_buffer, 218, 1); }),
+        nanosecondsPerCall([] { return referenceCrc16nrf24(_buffer, 218, 1, 0xffff); }));
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc8_matches_reference);
+    RUN_TEST(test_crc16_matches_reference);
+    RUN_TEST(test_crc16nrf24_matches_reference);
+    RUN_TEST(test_crc_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#define VICTRON_COUNT 1
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <unity.h>
+#include <vector>
+
+// the firmware modules under test. test/shims stands in for the Arduino
+// core, test/sim for the modules and libraries they talk to.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include <sml.cpp>
+#include <VeDirectFrameHandler.cpp>
+#include <VeDirectMpptController.cpp>
+#include <PowerMeter.cpp>
+#include <PowerLimiter.cpp>
+#pragma GCC diagnostic pop
+
+#include <SimulatedDevices.h>
+
+ConfigurationClass Configuration;
+static CONFIG_T _config;
+
+CONFIG_T& ConfigurationClass::get()
+{
+    return _config;
+}
+
+static constexpr char GRID_TOPIC[] = "sim/grid/power";
+static constexpr uint32_t LOOP_PERIOD_MS = 5;
+static constexpr uint32_t INVERTER_MAX_POWER = 800;
+static constexpr float BATTERY_VOLTAGE = 52.0;
+
+// host time spent in the firmware modules per loop, in microseconds
+struct ModuleTimes {
+    const char* name;
+    std::vector<double> us;
+};
+
+static ModuleTimes _powerMeterTimes = { "PowerMeter", {} };
+static ModuleTimes _veDirectTimes = { "VeDirectMppt", {} };
+static ModuleTimes _powerLimiterTimes = { "PowerLimiter", {} };
+
+template <typename F>
+static void timed(ModuleTimes& times, F func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    times.us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+}
+
+class Simulation {
+public:
+    Simulation()
+        : _inverter(Hoymiles.addInverter(0x116100000001, InverterAbstract::Model()))
+        , _grid([this] { return _inverter->getOutputPower(); })
+        , _powerMeter(_grid, GRID_TOPIC, 1000)
+        , _mppt(1, BATTERY_VOLTAGE)
+    {
+        PowerMeter.init();
+        PowerLimiter = PowerLimiterClass();
+        VeDirectMppt[0].init(16, 17, 0, &MessageOutput, false);
+    }
+
+    ~Simulation() { Hoymiles.clear(); }
+
+    void run(uint32_t ms)
+    {
+        for (uint32_t end = millis() + ms; millis() < end;) {
+            _powerMeter.loop();
+            _mppt.loop();
+            Hoymiles.loop();
+
+            timed(_powerMeterTimes, [] { PowerMeter.loop(); });
+            timed(_veDirectTimes, [] { VeDirectMppt[0].loop(); });
+            timed(_powerLimiterTimes, [] { PowerLimiter.loop(); });
+
+            VirtualClock::advanceMillis(LOOP_PERIOD_MS);
+        }
+    }
+
+    // runs until the grid power stayed within the tolerance around the
+    // target for the given time. returns the control latency in ms, i.e.,
+    // the time until the grid power entered the band for good, or 0 if the
+    // grid power did not settle within the timeout.
+    uint32_t settle(float target, float tolerance, uint32_t stableMs = 10000, uint32_t timeoutMs = 60000)
+    {
+        uint32_t start = millis();
+        uint32_t enteredBand = 0;
+        while (millis() - start < timeoutMs) {
+            run(LOOP_PERIOD_MS);
+            if (std::abs(_grid.getPower() - target) > tolerance) {
+                enteredBand = 0;
+                continue;
+            }
+            if (enteredBand == 0) {
+                enteredBand = millis();
+            }
+            if (millis() - enteredBand >= stableMs) {
+                return enteredBand - start;
+            }
+        }
+        return 0;
+    }
+
+    std::shared_ptr<InverterAbstract> _inverter;
+    SimulatedGrid _grid;
+    SimulatedMqttPowerMeter _powerMeter;
+    SimulatedMppt _mppt;
+};
+
+void setUp()
+{
+    VirtualClock::reset(10000);
+    VirtualClock::setLocalTime(1697500800); // 2023-10-17 00:00:00 UTC
+
+    _config = {};
+    _config.PowerMeter_Enabled = true;
+    _config.PowerMeter_Interval = 10000;
+    _config.PowerMeter_Source = PowerMeterClass::SOURCE_MQTT;
+    strcpy(_config.PowerMeter_MqttTopicPowerMeter1, GRID_TOPIC);
+
+    _config.PowerLimiter_Enabled = true;
+    _config.PowerLimiter_IsInverterBehindPowerMeter = true;
+    _config.PowerLimiter_InverterId = 0;
+    _config.PowerLimiter_InverterChannelId = 0;
+    _config.PowerLimiter_TargetPowerConsumption = 0;
+    _config.PowerLimiter_TargetPowerConsumptionHysteresis = 20;
+    _config.PowerLimiter_LowerPowerLimit = 50;
+    _config.PowerLimiter_UpperPowerLimit = INVERTER_MAX_POWER;
+    _config.PowerLimiter_SolarPassThroughLosses = 3;
+    _config.PowerLimiter_VoltageStartThreshold = 50.0;
+    _config.PowerLimiter_VoltageStopThreshold = 46.0;
+    _config.PowerLimiter_VoltageLoadCorrectionFactor = 0.001;
+    _config.PowerLimiter_RestartHour = -1;
+    _config.PowerLimiter_FullSolarPassThroughStartVoltage = 100.0;
+    _config.PowerLimiter_FullSolarPassThroughStopVoltage = 100.0;
+}
+
+void tearDown()
+{
+}
+
+void test_dpl_follows_load_steps()
+{
+    Simulation sim;
+    char message[160];
+
+    // the battery covers the whole load, the grid power is regulated to
+    // the target within the hysteresis
+    for (float load : { 300.0f, 650.0f, 150.0f, 500.0f }) {
+        sim._grid.setLoad(load);
+        uint32_t latency = sim.settle(0, 2 * _config.PowerLimiter_TargetPowerConsumptionHysteresis);
+
+        snprintf(message, sizeof(message), "load step to %.0f W: settled after %u ms, grid %.1f W, limit %.0f W, %u commands",
+            load, static_cast<unsigned>(latency), sim._grid.getPower(), sim._inverter->getLimit(),
+            static_cast<unsigned>(sim._inverter->getCommandCount()));
+        TEST_MESSAGE(message);
+
+        TEST_ASSERT_TRUE(latency > 0);
+        TEST_ASSERT_LESS_OR_EQUAL(15000, latency);
+    }
+}
+
+void test_dpl_passes_through_solar_power()
+{
+    _config.Vedirect_Enabled = true;
+    _config.PowerLimiter_SolarPassThroughEnabled = true;
+    _config.PowerLimiter_BatteryDrainStategy = EMPTY_AT_NIGHT;
+    _config.PowerLimiter_VoltageStartThreshold = 60.0; // never discharge the battery
+
+    Simulation sim;
+    char message[160];
+
+    sim._grid.setLoad(900);
+
+    // the charge power is fed in after the losses of the charger, the
+    // cabling and the inverter
+    for (int32_t panelPower : { 400, 200 }) {
+        sim._mppt.setPanelPower(panelPower);
+        float chargePower = BATTERY_VOLTAGE * static_cast<int32_t>(panelPower * 970 / BATTERY_VOLTAGE) / 1000;
+        float expected = chargePower * 0.95 * 0.97;
+        uint32_t latency = sim.settle(900 - expected, 2 * _config.PowerLimiter_TargetPowerConsumptionHysteresis);
+
+        snprintf(message, sizeof(message), "panel power %d W: settled after %u ms, inverter %.1f W, expected %.1f W",
+            static_cast<int>(panelPower), static_cast<unsigned>(latency), sim._inverter->getOutputPower(), expected);
+        TEST_MESSAGE(message);
+
+        TEST_ASSERT_TRUE(VeDirectMppt[0].isDataValid());
+        TEST_ASSERT_TRUE(latency > 0);
+    }
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+}
+
+void test_loop_latency()
+{
+    // host time, a relative measure only. the ESP32 is slower by an order
+    // of magnitude.
+    char message[160];
+    for (ModuleTimes* times : { &_powerMeterTimes, &_veDirectTimes, &_powerLimiterTimes }) {
+        TEST_ASSERT_TRUE(!times->us.empty());
+        snprintf(message, sizeof(message), "%s: %u loops, p50 %.2f us, p99 %.2f us, max %.2f us",
+            times->name, static_cast<unsigned>(times->us.size()),
+            percentile(times->us, 0.5), percentile(times->us, 0.99), percentile(times->us, 1.0));
+        TEST_MESSAGE(message);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_dpl_follows_load_steps);
+    RUN_TEST(test_dpl_passes_through_solar_power);
+    RUN_TEST(test_loop_latency);
+    return UNITY_END();
+}
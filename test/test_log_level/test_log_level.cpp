@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#include <Arduino.h>
+#include <LogLevel.h>
+#include <chrono>
+#include <cstdio>
+#include <unity.h>
+
+// discards the output after it was formatted, as the verbose output of the
+// Hoymiles library did while verbose logging was off
+class Silent : public Print {
+public:
+    size_t write(uint8_t) override { return 0; }
+    using Print::write;
+};
+
+// keeps the output
+class Capture : public Print {
+public:
+    size_t write(uint8_t c) override
+    {
+        text += static_cast<char>(c);
+        return 1;
+    }
+    using Print::write;
+
+    std::string text;
+};
+
+// a module's verbose switch with the given build time log level, as in
+// HoymilesClass, VeDirectFrameHandler and PowerLimiterClass
+template <int BuildLevel>
+class Module {
+public:
+    bool isVerboseLogging() const { return LOG_ENABLED(LOG_LEVEL_VERBOSE, BuildLevel, _verboseLogging); }
+    bool _verboseLogging = false;
+};
+
+static Module<LOG_LEVEL_VERBOSE> _runtimeLevel;
+static Module<LOG_LEVEL_INFO> _buildLevel;
+
+struct Fragment {
+    uint8_t fragment[32];
+    uint8_t len;
+    uint8_t channel;
+    int8_t rssi;
+    uint32_t timestamp;
+};
+
+static Fragment _fragment;
+static uint8_t _payload[27];
+static Silent _silent;
+static uint32_t _evaluated;
+
+static String getCommandName()
+{
+    _evaluated++;
+    return "RealTimeRunData";
+}
+
+// the verbose output of HoymilesRadio_NRF per received fragment
+static void logFragment(Print* out)
+{
+    out->printf("RX Channel: %d --> ", _fragment.channel);
+    for (uint8_t i = 0; i < _fragment.len; i++) {
+        out->printf("%02X ", _fragment.fragment[i]);
+    }
+    out->printf("| %d dBm | %u ms\r\n", _fragment.rssi, static_cast<unsigned>(millis() - _fragment.timestamp));
+}
+
+// the verbose output of HoymilesRadio_NRF per sent request
+static void logRequest(Print* out)
+{
+    out->printf("TX %s Channel: %d --> ", getCommandName().c_str(), 23);
+    for (uint8_t i = 0; i < sizeof(_payload); i++) {
+        out->printf("%02X ", _payload[i]);
+    }
+    out->println("");
+}
+
+void setUp()
+{
+    _fragment = { {}, 27, 61, -64, 0 };
+    for (uint8_t i = 0; i < sizeof(_fragment.fragment); i++) {
+        _fragment.fragment[i] = i * 7;
+    }
+    for (uint8_t i = 0; i < sizeof(_payload); i++) {
+        _payload[i] = 0x80 | i;
+    }
+    _evaluated = 0;
+    _runtimeLevel._verboseLogging = false;
+    _buildLevel._verboseLogging = false;
+}
+
+void tearDown()
+{
+}
+
+void test_log_enabled()
+{
+    TEST_ASSERT_TRUE(LOG_ENABLED(LOG_LEVEL_ERROR, LOG_LEVEL_INFO, true));
+    TEST_ASSERT_TRUE(LOG_ENABLED(LOG_LEVEL_INFO, LOG_LEVEL_INFO, true));
+    TEST_ASSERT_FALSE(LOG_ENABLED(LOG_LEVEL_INFO, LOG_LEVEL_INFO, false));
+    TEST_ASSERT_FALSE(LOG_ENABLED(LOG_LEVEL_VERBOSE, LOG_LEVEL_INFO, true));
+    TEST_ASSERT_FALSE(LOG_ENABLED(LOG_LEVEL_ERROR, LOG_LEVEL_NONE, true));
+
+    // messages above the build time level are constant false
+    static_assert(!LOG_ENABLED(LOG_LEVEL_VERBOSE, LOG_LEVEL_INFO, _buildLevel._verboseLogging), "");
+}
+
+void test_disabled_message_is_not_evaluated()
+{
+    Capture out;
+
+    if (_runtimeLevel.isVerboseLogging()) {
+        logRequest(&out);
+    }
+    if (_buildLevel.isVerboseLogging()) {
+        logRequest(&out);
+    }
+    _buildLevel._verboseLogging = true;
+    if (_buildLevel.isVerboseLogging()) {
+        logRequest(&out);
+    }
+    TEST_ASSERT_EQUAL(0, _evaluated);
+    TEST_ASSERT_TRUE(out.text.empty());
+
+    _runtimeLevel._verboseLogging = true;
+    if (_runtimeLevel.isVerboseLogging()) {
+        logFragment(&out);
+    }
+    TEST_ASSERT_EQUAL(0, out.text.find("RX Channel: 61 --> 00 07 0E "));
+    TEST_ASSERT_TRUE(out.text.find("| -64 dBm |") != std::string::npos);
+}
+
+template <typename F>
+static double nanosecondsPerCall(F func)
+{
+    constexpr int ITERATIONS = 20000;
+    volatile uint32_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        _fragment.fragment[0] = i;
+        sink = sink + func();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+void test_log_level_benchmark()
+{
+    // verbose logging is off. before, the output was formatted and then
+    // discarded by a Silent Print. now the runtime switch is checked first,
+    // or the message is removed by the build time level.
+    char message[160];
+
+    snprintf(message, sizeof(message), "RX fragment 27 bytes: formatted and discarded %.1f ns, runtime level %.1f ns, build level %.1f ns",
+        nanosecondsPerCall([] { logFragment(&_silent); return 0; }),
+        nanosecondsPerCall([] { if (_runtimeLevel.isVerboseLogging()) { logFragment(&_silent); } return 0; }),
+        nanosecondsPerCall([] { if (_buildLevel.isVerboseLogging()) { logFragment(&_silent); } return 0; }));
+    TEST_MESSAGE(message);
+
+    // a poll of a 4 channel inverter: one request and 5 response fragments
+    auto poll = [](bool enabled) {
+        if (enabled) {
+            logRequest(&_silent);
+        }
+        for (int i = 0; i < 5; i++) {
+            if (enabled) {
+                logFragment(&_silent);
+            }
+        }
+        return 0;
+    };
+    snprintf(message, sizeof(message), "poll of 1 request and 5 fragments: formatted and discarded %.1f ns, runtime level %.1f ns, build level %.1f ns",
+        nanosecondsPerCall([&] { return poll(true); }),
+        nanosecondsPerCall([&] { return poll(_runtimeLevel.isVerboseLogging()); }),
+        nanosecondsPerCall([&] { return poll(_buildLevel.isVerboseLogging()); }));
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_log_enabled);
+    RUN_TEST(test_disabled_message_is_not_evaluated);
+    RUN_TEST(test_log_level_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#include <chrono>
+#include <cstdio>
+#include <unity.h>
+
+#include <LoopProfiler.cpp>
+
+using Section = LoopProfilerClass::Section;
+
+static std::unique_ptr<LoopProfilerClass> _profiler;
+
+void setUp()
+{
+    VirtualClock::reset(1000);
+    _profiler = std::make_unique<LoopProfilerClass>();
+}
+
+void tearDown()
+{
+    _profiler.reset();
+}
+
+// one loop in which the sections take the given virtual time
+static void runLoop(uint32_t powerMeterUs, uint32_t webApiUs)
+{
+    _profiler->startLoop();
+    VirtualClock::advanceMicros(powerMeterUs);
+    _profiler->endSection(Section::PowerMeter);
+    VirtualClock::advanceMicros(webApiUs);
+    _profiler->endSection(Section::WebApi);
+}
+
+void test_histogram_percentiles()
+{
+    LoopProfilerClass::Histogram histogram;
+    TEST_ASSERT_EQUAL(0, histogram.getPercentileUs(50));
+
+    for (uint32_t us = 1; us <= 100; us++) {
+        histogram.add(us);
+    }
+    TEST_ASSERT_EQUAL(100, histogram.count);
+    TEST_ASSERT_EQUAL(1, histogram.minUs);
+    TEST_ASSERT_EQUAL(100, histogram.maxUs);
+    TEST_ASSERT_EQUAL(5050, histogram.sumUs);
+
+    // 50 is in the bucket below 64, 99 in the one below 128 which is
+    // capped by the maximum
+    TEST_ASSERT_EQUAL(64, histogram.getPercentileUs(50));
+    TEST_ASSERT_EQUAL(100, histogram.getPercentileUs(99));
+}
+
+void test_window_is_published_when_complete()
+{
+    runLoop(100, 20);
+    runLoop(100, 20);
+
+    // nothing completed yet
+    auto window = _profiler->getLastWindow();
+    TEST_ASSERT_EQUAL(0, window->number);
+    TEST_ASSERT_EQUAL(0, window->loop.count);
+
+    while (micros() - 1000000 < LoopProfilerClass::WINDOW_US) {
+        runLoop(100, 20);
+    }
+    runLoop(5000, 20); // starts the next window
+
+    window = _profiler->getLastWindow();
+    TEST_ASSERT_EQUAL(1, window->number);
+    TEST_ASSERT_EQUAL(60000, window->durationMs);
+    TEST_ASSERT_EQUAL(window->loop.count, window->getHistogram(Section::PowerMeter).count);
+    TEST_ASSERT_EQUAL(100, window->getHistogram(Section::PowerMeter).maxUs);
+    TEST_ASSERT_EQUAL(20, window->getHistogram(Section::WebApi).maxUs);
+    TEST_ASSERT_EQUAL(100, window->stallUs);
+    TEST_ASSERT_TRUE(window->stallSection == Section::PowerMeter);
+
+    LoopProfilerClass::Total total = _profiler->getTotal(Section::PowerMeter);
+    TEST_ASSERT_EQUAL(window->getHistogram(Section::PowerMeter).count, total.count);
+    TEST_ASSERT_EQUAL(window->getHistogram(Section::PowerMeter).sumUs, total.sumUs);
+}
+
+void test_stall_is_reset_per_window()
+{
+    runLoop(100, 20);
+    runLoop(100, 250000); // a stall in the first window
+
+    while (micros() - 1000000 < 2 * LoopProfilerClass::WINDOW_US) {
+        runLoop(100, 20);
+    }
+    runLoop(100, 20);
+
+    auto window = _profiler->getLastWindow();
+    TEST_ASSERT_EQUAL(2, window->number);
+    TEST_ASSERT_EQUAL(100, window->stallUs);
+    TEST_ASSERT_EQUAL(20, window->getHistogram(Section::WebApi).maxUs);
+
+    // the totals still contain the first window
+    LoopProfilerClass::Total total = _profiler->getTotal(Section::WebApi);
+    TEST_ASSERT_TRUE(total.count > window->getHistogram(Section::WebApi).count);
+    TEST_ASSERT_TRUE(total.sumUs >= 250000);
+}
+
+void test_loop_profiler_overhead()
+{
+    // host time of the profiler itself, the sections take no time. a loop
+    // of the firmware ends 25 sections, each also recording the yield.
+    constexpr int LOOPS = 100000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < LOOPS; i++) {
+        _profiler->startLoop();
+        for (size_t s = 0; s < LoopProfilerClass::SECTION_COUNT - 1; s++) {
+            VirtualClock::advanceMicros(3);
+            _profiler->endSection(static_cast<Section>(s));
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double loopNs = std::chrono::duration<double, std::nano>(end - start).count() / LOOPS;
+    char message[160];
+    snprintf(message, sizeof(message), "per section %.1f ns, per loop of %u sections %.1f ns",
+        loopNs / (LoopProfilerClass::SECTION_COUNT - 1), static_cast<unsigned>(LoopProfilerClass::SECTION_COUNT - 1), loopNs);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_histogram_percentiles);
+    RUN_TEST(test_window_is_published_when_complete);
+    RUN_TEST(test_stall_is_reset_per_window);
+    RUN_TEST(test_loop_profiler_overhead);
+    return UNITY_END();
+}
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2023 Thomas Basler and others
+ */
+#include <MpscQueue.h>
+#include <SpscRingBuffer.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_spsc_fifo_order_and_capacity()
+{
+    SpscRingBuffer<uint32_t, 8> ring;
+    uint32_t next = 0;
+    uint32_t expected = 0;
+
+    // several rounds to wrap the counters around the buffer
+    for (int round = 0; round < 5; round++) {
+        uint32_t* slot;
+        while ((slot = ring.reserve()) != nullptr) {
+            *slot = next++;
+            ring.commit();
+        }
+        TEST_ASSERT_EQUAL(ring.capacity(), ring.size());
+
+        // drain only part of it so the next round starts in the middle
+        for (int i = 0; i < 5; i++) {
+            TEST_ASSERT_NOT_NULL(ring.front());
+            TEST_ASSERT_EQUAL_UINT32(expected++, *ring.front());
+            ring.pop();
+        }
+    }
+
+    while (ring.front() != nullptr) {
+        TEST_ASSERT_EQUAL_UINT32(expected++, *ring.front());
+        ring.pop();
+    }
+    TEST_ASSERT_EQUAL_UINT32(next, expected);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+void test_spsc_two_threads()
+{
+    constexpr uint32_t COUNT = 1000000;
+    SpscRingBuffer<uint32_t, 32> ring;
+
+    std::thread producer([&ring] {
+        for (uint32_t i = 0; i < COUNT; i++) {
+            uint32_t* slot;
+            while ((slot = ring.reserve()) == nullptr) {
+                std::this_thread::yield();
+            }
+            *slot = i;
+            ring.commit();
+        }
+    });
+
+    uint32_t expected = 0;
+    while (expected < COUNT) {
+        uint32_t* item = ring.front();
+        if (item == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (*item != expected) {
+            break;
+        }
+        ring.pop();
+        expected++;
+    }
+
+    producer.join();
+    TEST_ASSERT_EQUAL_UINT32(COUNT, expected);
+}
+
+void test_mpsc_fifo_order_and_capacity()
+{
+    MpscQueue<int, 4> queue;
+    int item;
+
+    TEST_ASSERT_FALSE(queue.try_pop(item));
+    TEST_ASSERT_FALSE(queue.pop(item, 1));
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 4; i++) {
+            TEST_ASSERT_TRUE(queue.try_push(round * 10 + i));
+        }
+        TEST_ASSERT_FALSE(queue.try_push(-1));
+        TEST_ASSERT_EQUAL(4, queue.size());
+
+        for (int i = 0; i < 4; i++) {
+            TEST_ASSERT_TRUE(queue.try_pop(item));
+            TEST_ASSERT_EQUAL(round * 10 + i, item);
+        }
+        TEST_ASSERT_TRUE(queue.empty());
+    }
+
+    TEST_ASSERT_EQUAL(4, queue.getHighWaterMark());
+}
+
+void test_mpsc_producers_stress_and_latency()
+{
+    constexpr uint32_t PRODUCERS = 4;
+    constexpr uint32_t COUNT = 200000;
+
+    using clock = std::chrono::steady_clock;
+    struct Item {
+        uint32_t producer;
+        uint32_t sequence;
+        clock::time_point pushed;
+    };
+
+    // the same capacity as the radio command queue
+    MpscQueue<Item, 32> queue;
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p] {
+            for (uint32_t i = 0; i < COUNT; i++) {
+                while (!queue.try_push({ p, i, clock::now() })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // items of each producer have to arrive in order, none may get lost
+    std::vector<uint32_t> expected(PRODUCERS, 0);
+    uint32_t received = 0;
+    bool ordered = true;
+    double latencySum = 0;
+    double latencyMax = 0;
+
+    Item item;
+    while (received < PRODUCERS * COUNT) {
+        if (!queue.pop(item, 1000)) {
+            break;
+        }
+        double latency = std::chrono::duration<double, std::micro>(clock::now() - item.pushed).count();
+        latencySum += latency;
+        latencyMax = std::max(latencyMax, latency);
+
+        ordered &= item.sequence == expected[item.producer]++;
+        received++;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(PRODUCERS * COUNT, received);
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_LESS_OR_EQUAL(queue.capacity(), queue.getHighWaterMark());
+
+    char message[160];
+    snprintf(message, sizeof(message), "%u producers: latency avg %.2f us, max %.1f us, high water %u of %u",
+        static_cast<unsigned>(PRODUCERS), latencySum / received, latencyMax,
+        static_cast<unsigned>(queue.getHighWaterMark()), static_cast<unsigned>(queue.capacity()));
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_spsc_fifo_order_and_capacity);
+    RUN_TEST(test_spsc_two_threads);
+    RUN_TEST(test_mpsc_fifo_order_and_capacity);
+    RUN_TEST(test_mpsc_producers_stress_and_latency);
+    return UNITY_END();
+}
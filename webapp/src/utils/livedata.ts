@@ -0,0 +1,69 @@
+// Client side of the delta encoded live data protocol, see docs/Web-API.md.
+// The firmware first sends a snapshot with the full document and the paths
+// of all of its values, followed by deltas which only contain the values
+// that changed, addressed by their index into these paths.
+export const LIVE_DATA_PROTOCOL = 2;
+
+export class LiveDataReader {
+    private snapshot = -1;
+    private seq = 0;
+    private paths: string[][] = [];
+
+    constructor(private socket: WebSocket) {
+    }
+
+    // to be called once the socket is open
+    start() {
+        this.snapshot = -1;
+        this.socket.send("protocol:" + LIVE_DATA_PROTOCOL);
+    }
+
+    // Returns the document after applying the message. Deltas are applied
+    // to current, which should be the reactive object returned before.
+    // Returns undefined if the message does not belong to the current
+    // snapshot, in that case a new snapshot was requested.
+    apply(message: any, current: any): any {
+        if (message.protocol !== LIVE_DATA_PROTOCOL) {
+            // sent before the firmware processed our request
+            return message;
+        }
+
+        if (message.type === "snapshot") {
+            this.snapshot = message.snapshot;
+            this.seq = message.seq;
+            this.paths = message.ids.map((id: string) => id.split("/").slice(1));
+            return message.data;
+        }
+
+        if (this.snapshot < 0) {
+            // a resync is already pending
+            return undefined;
+        }
+
+        if (message.snapshot !== this.snapshot || message.seq !== this.seq + 1) {
+            // the paths are outdated or a delta got lost
+            this.resync();
+            return undefined;
+        }
+
+        this.seq = message.seq;
+        for (const [id, value] of message.changes) {
+            const path = this.paths[id];
+            let parent = current;
+            for (let i = 0; path && i < path.length - 1 && parent; i++) {
+                parent = parent[path[i]];
+            }
+            if (!path || !parent) {
+                this.resync();
+                return undefined;
+            }
+            parent[path[path.length - 1]] = value;
+        }
+        return current;
+    }
+
+    private resync() {
+        this.snapshot = -1;
+        this.socket.send("resync");
+    }
+}